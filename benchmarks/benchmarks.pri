@@ -0,0 +1,13 @@
+# Settings shared by every benchmark program. Benchmarks are not run
+# by "make check". Run a program directly and pass -callgrind or
+# -tickcounter to use another measurement than wall time.
+
+QT += testlib
+QT -= gui
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+include(../src/antimicrocore.pri)
@@ -0,0 +1,8 @@
+TEMPLATE = subdirs
+
+SUBDIRS += dispatch \
+    mousecurve \
+    mousespeed \
+    pausehold \
+    sticksweep \
+    timerdispatch
@@ -0,0 +1,141 @@
+#include <QtTest>
+#include <QHash>
+#include <QVector>
+
+#include "joystick.h"
+#include "setjoystick.h"
+
+static const int NUMBERJOYSTICKS = 4;
+static const int NUMBERBUTTONS = 16;
+static const int NUMBERAXES = 8;
+static const int NUMBERHATS = 2;
+static const int NUMBEREVENTS = 4096;
+
+/* Compares the element lookup InputDaemon did before controller
+ * events were dispatched through flat tables (QHash of joysticks,
+ * then the QHash of the active set) with the lookup done now.
+ * Only the lookup is measured so no output is generated.
+ */
+class BenchDispatch : public QObject
+{
+    Q_OBJECT
+
+protected:
+    QHash<int, Joystick*> joysticks;
+    QVector<Joystick*> dispatchJoysticks;
+    QVector<SDL_Event> events;
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void hashLookup();
+    void flatLookup();
+};
+
+void BenchDispatch::initTestCase()
+{
+    for (int i=0; i < NUMBERJOYSTICKS; i++)
+    {
+        Joystick *joystick = new Joystick(QString("Benchmark pad %1").arg(i + 1), i,
+                                          NUMBERBUTTONS, NUMBERAXES, NUMBERHATS);
+        joysticks.insert(i, joystick);
+        dispatchJoysticks.append(joystick);
+    }
+
+    // Fixed seed so every run looks up the same elements
+    qsrand(1);
+    events.resize(NUMBEREVENTS);
+    for (int i=0; i < NUMBEREVENTS; i++)
+    {
+        SDL_Event &event = events[i];
+        int kind = qrand() % 3;
+        if (kind == 0)
+        {
+            event.type = SDL_JOYBUTTONDOWN;
+            event.button.which = qrand() % NUMBERJOYSTICKS;
+            event.button.button = qrand() % NUMBERBUTTONS;
+        }
+        else if (kind == 1)
+        {
+            event.type = SDL_JOYAXISMOTION;
+            event.jaxis.which = qrand() % NUMBERJOYSTICKS;
+            event.jaxis.axis = qrand() % NUMBERAXES;
+        }
+        else
+        {
+            event.type = SDL_JOYHATMOTION;
+            event.jhat.which = qrand() % NUMBERJOYSTICKS;
+            event.jhat.hat = qrand() % NUMBERHATS;
+        }
+    }
+}
+
+void BenchDispatch::cleanupTestCase()
+{
+    qDeleteAll(dispatchJoysticks);
+    dispatchJoysticks.clear();
+    joysticks.clear();
+}
+
+void BenchDispatch::hashLookup()
+{
+    int found = 0;
+    QBENCHMARK
+    {
+        for (int i=0; i < NUMBEREVENTS; i++)
+        {
+            const SDL_Event &event = events.at(i);
+            if (event.type == SDL_JOYBUTTONDOWN)
+            {
+                Joystick *joy = joysticks.value(event.button.which);
+                found += joy->getActiveSetJoystick()->getJoyButton(event.button.button) != 0;
+            }
+            else if (event.type == SDL_JOYAXISMOTION)
+            {
+                Joystick *joy = joysticks.value(event.jaxis.which);
+                found += joy->getActiveSetJoystick()->getJoyAxis(event.jaxis.axis) != 0;
+            }
+            else
+            {
+                Joystick *joy = joysticks.value(event.jhat.which);
+                found += joy->getActiveSetJoystick()->getJoyDPad(event.jhat.hat) != 0;
+            }
+        }
+    }
+
+    QVERIFY(found > 0);
+}
+
+void BenchDispatch::flatLookup()
+{
+    int found = 0;
+    QBENCHMARK
+    {
+        for (int i=0; i < NUMBEREVENTS; i++)
+        {
+            const SDL_Event &event = events.at(i);
+            if (event.type == SDL_JOYBUTTONDOWN)
+            {
+                Joystick *joy = dispatchJoysticks.at(event.button.which);
+                found += joy->getActiveJoyButton(event.button.button) != 0;
+            }
+            else if (event.type == SDL_JOYAXISMOTION)
+            {
+                Joystick *joy = dispatchJoysticks.at(event.jaxis.which);
+                found += joy->getActiveJoyAxis(event.jaxis.axis) != 0;
+            }
+            else
+            {
+                Joystick *joy = dispatchJoysticks.at(event.jhat.which);
+                found += joy->getActiveJoyDPad(event.jhat.hat) != 0;
+            }
+        }
+    }
+
+    QVERIFY(found > 0);
+}
+
+QTEST_MAIN(BenchDispatch)
+
+#include "bench_dispatch.moc"
@@ -0,0 +1,5 @@
+include(../benchmarks.pri)
+
+TARGET = bench_dispatch
+
+SOURCES += bench_dispatch.cpp
@@ -0,0 +1,175 @@
+#include <QtTest>
+#include <QTextStream>
+#include <QList>
+#include <QPointF>
+#include <math.h>
+
+#include "joybutton.h"
+
+static const int NUMBERSAMPLES = 4096;
+
+// Gives the benchmark access to both ways of evaluating a curve
+class CurveButton : public JoyButton
+{
+public:
+    explicit CurveButton() :
+        JoyButton(0, 0)
+    {
+    }
+
+    using JoyButton::calculateMouseCurve;
+    using JoyButton::getMouseCurveValue;
+};
+
+/* Compares looking up the mouse curve in the sampled table with
+ * evaluating it through the curve switch, which calls pow() for
+ * power curves. The accuracy of the lookup against the direct value
+ * is checked as well.
+ */
+class BenchMouseCurve : public QObject
+{
+    Q_OBJECT
+
+protected:
+    void setupCurve(CurveButton &button, int curve, double sensitivity);
+
+    QVector<double> samples;
+
+private slots:
+    void initTestCase();
+
+    void directCurve_data();
+    void directCurve();
+    void tableCurve_data();
+    void tableCurve();
+    void tableAccuracy_data();
+    void tableAccuracy();
+};
+
+void BenchMouseCurve::setupCurve(CurveButton &button, int curve, double sensitivity)
+{
+    if (curve == JoyButton::CustomCurve)
+    {
+        QList<QPointF> points;
+        points.append(QPointF(0.25, 0.05));
+        points.append(QPointF(0.5, 0.2));
+        points.append(QPointF(0.75, 0.5));
+        points.append(QPointF(1.0, 1.0));
+        button.setCustomCurvePoints(points);
+    }
+
+    button.setMouseCurve((JoyButton::JoyMouseCurve)curve);
+    button.setSensitivity(sensitivity);
+}
+
+void BenchMouseCurve::initTestCase()
+{
+    // Deflections as they come from a stick that is moved around
+    qsrand(1);
+    samples.resize(NUMBERSAMPLES);
+    for (int i=0; i < NUMBERSAMPLES; i++)
+    {
+        samples[i] = qrand() / (double)RAND_MAX;
+    }
+}
+
+static void addCurveRows()
+{
+    QTest::addColumn<int>("curve");
+    QTest::addColumn<double>("sensitivity");
+
+    QTest::newRow("power 0.5") << (int)JoyButton::PowerCurve << 0.5;
+    QTest::newRow("power 2") << (int)JoyButton::PowerCurve << 2.0;
+    QTest::newRow("power 10") << (int)JoyButton::PowerCurve << 10.0;
+    QTest::newRow("custom") << (int)JoyButton::CustomCurve << 1.0;
+}
+
+void BenchMouseCurve::directCurve_data()
+{
+    addCurveRows();
+}
+
+void BenchMouseCurve::directCurve()
+{
+    QFETCH(int, curve);
+    QFETCH(double, sensitivity);
+
+    CurveButton button;
+    setupCurve(button, curve, sensitivity);
+
+    double sum = 0.0;
+    QBENCHMARK
+    {
+        for (int i=0; i < NUMBERSAMPLES; i++)
+        {
+            sum += button.calculateMouseCurve(samples.at(i));
+        }
+    }
+
+    QVERIFY(sum > 0.0);
+}
+
+void BenchMouseCurve::tableCurve_data()
+{
+    addCurveRows();
+}
+
+void BenchMouseCurve::tableCurve()
+{
+    QFETCH(int, curve);
+    QFETCH(double, sensitivity);
+
+    CurveButton button;
+    setupCurve(button, curve, sensitivity);
+
+    double sum = 0.0;
+    QBENCHMARK
+    {
+        for (int i=0; i < NUMBERSAMPLES; i++)
+        {
+            sum += button.getMouseCurveValue(samples.at(i));
+        }
+    }
+
+    QVERIFY(sum > 0.0);
+}
+
+void BenchMouseCurve::tableAccuracy_data()
+{
+    addCurveRows();
+}
+
+// Small deflections matter most since the power curves are steepest there
+void BenchMouseCurve::tableAccuracy()
+{
+    QFETCH(int, curve);
+    QFETCH(double, sensitivity);
+
+    CurveButton button;
+    setupCurve(button, curve, sensitivity);
+
+    double worstError = 0.0;
+    double worstDistance = 0.0;
+    for (int i=1; i <= 100000; i++)
+    {
+        double distance = i / 100000.0;
+        double exact = button.calculateMouseCurve(distance);
+        double looked = button.getMouseCurveValue(distance);
+        double error = exact > 0.0 ? fabs(looked - exact) / exact : fabs(looked);
+        if (error > worstError)
+        {
+            worstError = error;
+            worstDistance = distance;
+        }
+    }
+
+    QTextStream out(stdout);
+    out << QString("Largest relative error %1 % at distance %2")
+           .arg(worstError * 100.0, 0, 'f', 4).arg(worstDistance) << endl;
+
+    QVERIFY(worstError < 0.002);
+}
+
+QTEST_MAIN(BenchMouseCurve)
+
+#include "bench_mousecurve.moc"
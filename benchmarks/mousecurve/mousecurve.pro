@@ -0,0 +1,5 @@
+include(../benchmarks.pri)
+
+TARGET = bench_mousecurve
+
+SOURCES += bench_mousecurve.cpp
@@ -0,0 +1,132 @@
+#include <QtTest>
+#include <QTextStream>
+#include <QList>
+
+#include "joybutton.h"
+#include "joybuttonslot.h"
+#include "mousescheduler.h"
+#include "recordingoutputsink.h"
+#include "common.h"
+
+// Time in milliseconds
+static const int WARMUPTIME = 200;
+static const int MEASURETIME = 2000;
+
+/* Holds a button mapped to cursor movement and compares the speed
+ * of the relative motion that reaches the output sink with the
+ * speed asked for through mouseSpeedX. Runs at several mouse
+ * scheduler rates since slow movement at high rates used to lose
+ * the most distance.
+ */
+class BenchMouseSpeed : public QObject
+{
+    Q_OBJECT
+
+protected:
+    RecordingOutputSink *sink;
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void speedError_data();
+    void speedError();
+};
+
+void BenchMouseSpeed::initTestCase()
+{
+    sink = new RecordingOutputSink();
+    OutputSink::setInstance(sink);
+}
+
+void BenchMouseSpeed::cleanupTestCase()
+{
+    OutputSink::setInstance(0);
+    delete sink;
+    sink = 0;
+
+    MouseScheduler::getInstance()->setRate(MouseScheduler::DEFAULTRATE);
+}
+
+void BenchMouseSpeed::speedError_data()
+{
+    QTest::addColumn<int>("rate");
+    QTest::addColumn<int>("speed");
+
+    int rates[] = {60, 125, 250, 500, 1000};
+    int speeds[] = {1, 5, 50};
+    for (int i=0; i < 5; i++)
+    {
+        for (int j=0; j < 3; j++)
+        {
+            QString name = QString("%1 Hz speed %2").arg(rates[i]).arg(speeds[j]);
+            QTest::newRow(name.toUtf8().constData()) << rates[i] << speeds[j];
+        }
+    }
+}
+
+void BenchMouseSpeed::speedError()
+{
+    QFETCH(int, rate);
+    QFETCH(int, speed);
+
+    MouseScheduler::getInstance()->setRate(rate);
+
+    JoyButton button(0, 0);
+    button.setMouseSpeedX(speed);
+    button.setAssignedSlot(JoyButtonSlot::MouseRight, JoyButtonSlot::JoyMouseMovement);
+
+    button.joyEvent(true);
+    QTest::qWait(WARMUPTIME);
+    sink->clear();
+    QTest::qWait(MEASURETIME);
+    button.joyEvent(false);
+
+    // Distance sent after the first motion event was integrated over
+    // the time between the first and the last one
+    QList<RecordingOutputSink::OutputEvent> *events = sink->getEvents();
+    qint64 firstTime = 0;
+    qint64 lastTime = 0;
+    int distance = 0;
+    int motionEvents = 0;
+    for (int i=0; i < events->size(); i++)
+    {
+        const RecordingOutputSink::OutputEvent &event = events->at(i);
+        if (event.type == RecordingOutputSink::RelativeMotionOutput)
+        {
+            if (motionEvents == 0)
+            {
+                firstTime = event.timestamp;
+            }
+            else
+            {
+                distance += event.code;
+            }
+
+            lastTime = event.timestamp;
+            motionEvents++;
+        }
+    }
+
+    QVERIFY(motionEvents > 2);
+
+    double expected = speed * JoyButtonSlot::JOYSPEED;
+    double measured = distance / ((lastTime - firstTime) / 1000000000.0);
+    double error = (measured - expected) / expected * 100.0;
+
+    QTextStream out(stdout);
+    out << QString("%1 Hz, speed %2: expected %3 px/s, measured %4 px/s, error %5 %, %6 motion events")
+           .arg(rate).arg(speed).arg(expected, 0, 'f', 1).arg(measured, 0, 'f', 1)
+           .arg(error, 0, 'f', 2).arg(motionEvents) << endl;
+
+    // Only fails on gross errors. Timer jitter of a busy machine
+    // shows up in the printed error
+    QVERIFY(qAbs(error) < 10.0);
+
+    sink->clear();
+    QTest::qWait(50);
+}
+
+QTEST_MAIN(BenchMouseSpeed)
+
+#include "bench_mousespeed.moc"
@@ -0,0 +1,5 @@
+include(../benchmarks.pri)
+
+TARGET = bench_mousespeed
+
+SOURCES += bench_mousespeed.cpp
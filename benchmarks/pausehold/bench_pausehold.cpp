@@ -0,0 +1,177 @@
+#include <QtTest>
+#include <QTextStream>
+#include <QList>
+
+#include "joybutton.h"
+#include "joybuttonslot.h"
+#include "recordingoutputsink.h"
+#include "common.h"
+
+static const int REPEATCOUNT = 5;
+// Key codes assigned before and after the pause or hold slot
+static const int FIRSTKEYCODE = 10;
+static const int SECONDKEYCODE = 11;
+// Time in milliseconds
+static const int SETTLETIME = 50;
+
+static const qint64 MILLISECOND = 1000000;
+
+/* Runs buttons with a pause or hold slot between two key presses and
+ * compares when the second key arrives at the output sink with the
+ * deadline taken from the monotonic clock. Timer wheel deadlines
+ * should keep the error well under a millisecond on an idle machine.
+ * tests/pausehold checks the exact deadlines with a mocked clock.
+ */
+class BenchPauseHold : public QObject
+{
+    Q_OBJECT
+
+protected:
+    qint64 findKeyEvent(int code, bool pressed);
+    void writeErrors(QList<qint64> &errors);
+
+    RecordingOutputSink *sink;
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void pauseDeadline_data();
+    void pauseDeadline();
+    void holdDeadline_data();
+    void holdDeadline();
+};
+
+// Time of the first matching key event or -1 when none was sent
+qint64 BenchPauseHold::findKeyEvent(int code, bool pressed)
+{
+    qint64 result = -1;
+
+    QList<RecordingOutputSink::OutputEvent> *events = sink->getEvents();
+    for (int i=0; i < events->size() && result < 0; i++)
+    {
+        const RecordingOutputSink::OutputEvent &event = events->at(i);
+        if (event.type == RecordingOutputSink::KeyOutput &&
+            event.code == code && (event.value != 0) == pressed)
+        {
+            result = event.timestamp;
+        }
+    }
+
+    return result;
+}
+
+void BenchPauseHold::writeErrors(QList<qint64> &errors)
+{
+    qint64 worstError = 0;
+    qint64 totalError = 0;
+    for (int i=0; i < errors.size(); i++)
+    {
+        qint64 error = qAbs(errors.at(i));
+        worstError = qMax(worstError, error);
+        totalError += error;
+    }
+
+    double meanError = totalError / (double)errors.size();
+
+    QTextStream out(stdout);
+    out << QString("Mean error %1 us, worst error %2 us")
+           .arg(meanError / 1000.0, 0, 'f', 1)
+           .arg(worstError / 1000.0, 0, 'f', 1) << endl;
+}
+
+void BenchPauseHold::initTestCase()
+{
+    sink = new RecordingOutputSink();
+    OutputSink::setInstance(sink);
+}
+
+void BenchPauseHold::cleanupTestCase()
+{
+    OutputSink::setInstance(0);
+    delete sink;
+    sink = 0;
+}
+
+static void addDurationRows()
+{
+    QTest::addColumn<int>("duration");
+
+    QTest::newRow("10 ms") << 10;
+    QTest::newRow("50 ms") << 50;
+    QTest::newRow("250 ms") << 250;
+}
+
+void BenchPauseHold::pauseDeadline_data()
+{
+    addDurationRows();
+}
+
+// The pause starts when the slots before it are released
+void BenchPauseHold::pauseDeadline()
+{
+    QFETCH(int, duration);
+
+    QList<qint64> errors;
+    for (int i=0; i < REPEATCOUNT; i++)
+    {
+        JoyButton button(0, 0);
+        button.setAssignedSlot(FIRSTKEYCODE, JoyButtonSlot::JoyKeyboard);
+        button.setAssignedSlot(duration, JoyButtonSlot::JoyPause);
+        button.setAssignedSlot(SECONDKEYCODE, JoyButtonSlot::JoyKeyboard);
+
+        sink->clear();
+        button.joyEvent(true);
+        QTest::qWait(JoyButton::PAUSEHOLDTIME + duration + SETTLETIME);
+        button.joyEvent(false);
+        QTest::qWait(SETTLETIME);
+
+        qint64 pauseStart = findKeyEvent(FIRSTKEYCODE, false);
+        qint64 pauseEnd = findKeyEvent(SECONDKEYCODE, true);
+        QVERIFY(pauseStart >= 0);
+        QVERIFY(pauseEnd >= 0);
+
+        errors.append(pauseEnd - pauseStart - duration * MILLISECOND);
+    }
+
+    writeErrors(errors);
+}
+
+void BenchPauseHold::holdDeadline_data()
+{
+    addDurationRows();
+}
+
+// The hold is measured from the moment the button was pressed
+void BenchPauseHold::holdDeadline()
+{
+    QFETCH(int, duration);
+
+    QList<qint64> errors;
+    for (int i=0; i < REPEATCOUNT; i++)
+    {
+        JoyButton button(0, 0);
+        button.setAssignedSlot(FIRSTKEYCODE, JoyButtonSlot::JoyKeyboard);
+        button.setAssignedSlot(duration, JoyButtonSlot::JoyHold);
+        button.setAssignedSlot(SECONDKEYCODE, JoyButtonSlot::JoyKeyboard);
+
+        sink->clear();
+        qint64 pressTime = PadderCommon::getMonotonicTime();
+        button.joyEvent(true);
+        QTest::qWait(duration + SETTLETIME);
+        button.joyEvent(false);
+        QTest::qWait(SETTLETIME);
+
+        qint64 holdEnd = findKeyEvent(SECONDKEYCODE, true);
+        QVERIFY(findKeyEvent(FIRSTKEYCODE, true) >= 0);
+        QVERIFY(holdEnd >= 0);
+
+        errors.append(holdEnd - pressTime - duration * MILLISECOND);
+    }
+
+    writeErrors(errors);
+}
+
+QTEST_MAIN(BenchPauseHold)
+
+#include "bench_pausehold.moc"
@@ -0,0 +1,5 @@
+include(../benchmarks.pri)
+
+TARGET = bench_pausehold
+
+SOURCES += bench_pausehold.cpp
@@ -0,0 +1,165 @@
+#include <QtTest>
+#include <QHash>
+#include <QSet>
+#include <QDir>
+#include <QFile>
+#include <QEventLoop>
+#include <QTextStream>
+#include <math.h>
+#include <string.h>
+
+#include "inputdaemon.h"
+#include "joystick.h"
+#include "setjoystick.h"
+#include "joycontrolstick.h"
+#include "joycontrolstickbutton.h"
+#include "commandlineutility.h"
+#include "eventrecorder.h"
+#include "recordingoutputsink.h"
+#include "common.h"
+
+static const int NUMBERTURNS = 200;
+static const int STEPSPERTURN = 360;
+static const int SWEEPRADIUS = 30000;
+// First key code assigned to the stick directions
+static const int FIRSTKEYCODE = 10;
+
+/* Replays a recorded stick sweep as fast as possible through
+ * InputDaemon with a control stick in eight way mode on the first
+ * two axes. Every axis event has to be classified into a direction
+ * zone so the time of the replay is dominated by stick handling.
+ * Output goes to a RecordingOutputSink so no X server is needed.
+ */
+class BenchStickSweep : public QObject
+{
+    Q_OBJECT
+
+protected:
+    QString recordingPath;
+    int numberEvents;
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void replaySweep();
+};
+
+// Write the sweep as a recording with one controller
+void BenchStickSweep::initTestCase()
+{
+    recordingPath = QDir::temp().absoluteFilePath("antimicro_sticksweep.amrec");
+    numberEvents = 0;
+
+    // The replay reader still initializes SDL
+    qputenv("SDL_VIDEODRIVER", "dummy");
+
+    QList<RecordedDevice> devices;
+    RecordedDevice device;
+    device.name = "Stick sweep";
+    device.buttons = 0;
+    device.axes = 2;
+    device.hats = 0;
+    devices.append(device);
+
+    EventRecorder recorder;
+    QVERIFY(recorder.open(recordingPath, devices));
+
+    qint64 startTime = PadderCommon::getMonotonicTime();
+    TimedSDLEvent events[2];
+    for (int i=0; i < NUMBERTURNS * STEPSPERTURN; i++)
+    {
+        double angle = 2.0 * M_PI * i / STEPSPERTURN;
+        for (int j=0; j < 2; j++)
+        {
+            memset(&events[j].event, 0, sizeof(SDL_Event));
+            events[j].event.type = SDL_JOYAXISMOTION;
+            events[j].event.jaxis.which = 0;
+            events[j].event.jaxis.axis = j;
+            events[j].timestamp = startTime + i * 1000000LL;
+        }
+
+        events[0].event.jaxis.value = (Sint16)(SWEEPRADIUS * sin(angle));
+        events[1].event.jaxis.value = (Sint16)(-SWEEPRADIUS * cos(angle));
+        recorder.write(events, 2);
+        numberEvents += 2;
+    }
+
+    recorder.close();
+}
+
+void BenchStickSweep::cleanupTestCase()
+{
+    QFile::remove(recordingPath);
+}
+
+void BenchStickSweep::replaySweep()
+{
+    RecordingOutputSink *sink = new RecordingOutputSink();
+    OutputSink::setInstance(sink);
+
+    CommandLineUtility cmdutility;
+    QStringList arguments;
+    arguments << "antimicro" << "--replay" << recordingPath << "--replay-fast";
+    cmdutility.parseArguments(arguments);
+
+    QHash<int, Joystick*> *joysticks = new QHash<int, Joystick*> ();
+    InputDaemon *daemon = new InputDaemon(joysticks, &cmdutility);
+    QCOMPARE(joysticks->count(), 1);
+
+    SetJoystick *set = joysticks->value(0)->getActiveSetJoystick();
+    JoyControlStick *stick = new JoyControlStick(set->getJoyAxis(0), set->getJoyAxis(1), 0, 0, set);
+    stick->setJoyMode(JoyControlStick::EightWayMode);
+    set->addControlStick(0, stick);
+    for (int i=JoyControlStick::StickUp; i <= JoyControlStick::StickLeftUp; i++)
+    {
+        JoyControlStickButton *button = stick->getDirectionButton((JoyControlStick::JoyStickDirections)i);
+        button->setAssignedSlot(FIRSTKEYCODE + i, JoyButtonSlot::JoyKeyboard);
+    }
+
+    QEventLoop loop;
+    connect(daemon, SIGNAL(replayFinished()), &loop, SLOT(quit()));
+
+    qint64 startTime = PadderCommon::getMonotonicTime();
+    QBENCHMARK_ONCE
+    {
+        loop.exec();
+    }
+    qint64 elapsed = PadderCommon::getMonotonicTime() - startTime;
+
+    QTextStream out(stdout);
+    out << QString("%1 axis events in %2 ms, %3 ns per event")
+           .arg(numberEvents).arg(elapsed / 1000000.0, 0, 'f', 1)
+           .arg(elapsed / (double)numberEvents, 0, 'f', 0) << endl;
+
+    // Every direction zone is crossed on each turn
+    QSet<int> pressedKeys;
+    QList<RecordingOutputSink::OutputEvent> *events = sink->getEvents();
+    for (int i=0; i < events->size(); i++)
+    {
+        const RecordingOutputSink::OutputEvent &event = events->at(i);
+        if (event.type == RecordingOutputSink::KeyOutput && event.value)
+        {
+            pressedKeys.insert(event.code);
+        }
+    }
+
+    QCOMPARE(pressedKeys.size(), 8);
+
+    QHashIterator<int, Joystick*> iter(*joysticks);
+    while (iter.hasNext())
+    {
+        delete iter.next().value();
+    }
+
+    joysticks->clear();
+    delete joysticks;
+    delete daemon;
+
+    OutputSink::setInstance(0);
+    delete sink;
+}
+
+QTEST_MAIN(BenchStickSweep)
+
+#include "bench_sticksweep.moc"
@@ -0,0 +1,5 @@
+include(../benchmarks.pri)
+
+TARGET = bench_sticksweep
+
+SOURCES += bench_sticksweep.cpp
@@ -0,0 +1,106 @@
+#include <QtTest>
+#include <QList>
+#include <QTextStream>
+#include <time.h>
+
+#include "joystick.h"
+#include "setjoystick.h"
+#include "joybutton.h"
+#include "timerwheel.h"
+#include "nulloutputsink.h"
+#include "common.h"
+
+static const int NUMBERJOYSTICKS = 4;
+static const int NUMBERBUTTONS = 16;
+// Time in milliseconds
+static const int MEASURETIME = 3000;
+static const int TURBOINTERVAL = 10;
+// First key code assigned to the buttons
+static const int FIRSTKEYCODE = 10;
+
+static qint64 getProcessTime()
+{
+    struct timespec currentTime;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &currentTime);
+    return (qint64)currentTime.tv_sec * 1000000000LL + currentTime.tv_nsec;
+}
+
+/* Holds down every button of several controllers with turbo on so
+ * the timer wheel has to drive a large number of button timers at
+ * once. Reports the processor time spent per second along with the
+ * statistics of the wheel. Output goes to a NullOutputSink.
+ */
+class BenchTimerDispatch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void heavyTurbo();
+};
+
+void BenchTimerDispatch::heavyTurbo()
+{
+    NullOutputSink *sink = new NullOutputSink();
+    OutputSink::setInstance(sink);
+
+    QList<Joystick*> joysticks;
+    for (int i=0; i < NUMBERJOYSTICKS; i++)
+    {
+        Joystick *joystick = new Joystick(QString("Turbo pad %1").arg(i + 1), i, NUMBERBUTTONS, 0, 0);
+        SetJoystick *set = joystick->getActiveSetJoystick();
+        for (int j=0; j < NUMBERBUTTONS; j++)
+        {
+            JoyButton *button = set->getJoyButton(j);
+            button->setAssignedSlot(FIRSTKEYCODE + j, JoyButtonSlot::JoyKeyboard);
+            button->setTurboInterval(TURBOINTERVAL);
+            button->setUseTurbo(true);
+        }
+
+        joysticks.append(joystick);
+    }
+
+    for (int i=0; i < joysticks.size(); i++)
+    {
+        SetJoystick *set = joysticks.at(i)->getActiveSetJoystick();
+        for (int j=0; j < NUMBERBUTTONS; j++)
+        {
+            set->getJoyButton(j)->joyEvent(true);
+        }
+    }
+
+    // Let the turbo cycles settle before measuring
+    QTest::qWait(200);
+    TimerWheel::getInstance()->resetStatistics();
+
+    qint64 startTime = PadderCommon::getMonotonicTime();
+    qint64 startProcessTime = getProcessTime();
+    QTest::qWait(MEASURETIME);
+    qint64 elapsed = PadderCommon::getMonotonicTime() - startTime;
+    qint64 processTime = getProcessTime() - startProcessTime;
+
+    QTextStream out(stdout);
+    out << QString("%1 buttons with %2 ms turbo: %3 ms of processor time per second")
+           .arg(NUMBERJOYSTICKS * NUMBERBUTTONS).arg(TURBOINTERVAL)
+           .arg(processTime / (elapsed / 1000000000.0) / 1000000.0, 0, 'f', 2) << endl;
+    TimerWheel::getInstance()->writeStatistics(out);
+
+    for (int i=0; i < joysticks.size(); i++)
+    {
+        SetJoystick *set = joysticks.at(i)->getActiveSetJoystick();
+        for (int j=0; j < NUMBERBUTTONS; j++)
+        {
+            set->getJoyButton(j)->joyEvent(false);
+        }
+    }
+
+    QTest::qWait(100);
+    qDeleteAll(joysticks);
+    joysticks.clear();
+
+    OutputSink::setInstance(0);
+    delete sink;
+}
+
+QTEST_MAIN(BenchTimerDispatch)
+
+#include "bench_timerdispatch.moc"
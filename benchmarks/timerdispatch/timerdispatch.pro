@@ -0,0 +1,5 @@
+include(../benchmarks.pri)
+
+TARGET = bench_timerdispatch
+
+SOURCES += bench_timerdispatch.cpp
@@ -59,39 +59,23 @@ QMAKE_EXTRA_TARGETS += updateqm
 TARGET = antimicro
 TEMPLATE = app
 
+include(antimicrocore.pri)
+
 SOURCES += main.cpp\
         mainwindow.cpp \
     joybuttonwidget.cpp \
-    joystick.cpp \
-    joybutton.cpp \
-    event.cpp \
-    inputdaemon.cpp \
-    joyaxis.cpp \
     joyaxiswidget.cpp \
-    joydpad.cpp \
-    joydpadbutton.cpp \
     axiseditdialog.cpp \
-    xmlconfigreader.cpp \
-    xmlconfigwriter.cpp \
     joytabwidget.cpp \
     axisvaluebox.cpp \
     advancebuttondialog.cpp \
     simplekeygrabberbutton.cpp \
-    joybuttonslot.cpp \
-    joyaxisbutton.cpp \
     aboutdialog.cpp \
-    xmlconfigmigration.cpp \
-    setjoystick.cpp \
-    sdleventreader.cpp \
     setaxisthrottledialog.cpp \
-    x11info.cpp \
     keyboard/virtualkeypushbutton.cpp \
     keyboard/virtualkeyboardmousewidget.cpp \
     keyboard/virtualmousepushbutton.cpp \
     buttoneditdialog.cpp \
-    commandlineutility.cpp \
-    joycontrolstick.cpp \
-    joycontrolstickbutton.cpp \
     joycontrolstickeditdialog.cpp \
     joycontrolstickpushbutton.cpp \
     joycontrolstickbuttonpushbutton.cpp \
@@ -100,10 +84,8 @@ SOURCES += main.cpp\
     virtualdpadpushbutton.cpp \
     dpadpushbutton.cpp \
     dpadeditdialog.cpp \
-    vdpad.cpp \
     joydpadbuttonwidget.cpp \
     quicksetdialog.cpp \
-    mousehelper.cpp \
     mousesettingsdialog.cpp \
     mousedialog/mousecontrolsticksettingsdialog.cpp \
     mousedialog/mouseaxissettingsdialog.cpp \
@@ -112,38 +94,18 @@ SOURCES += main.cpp\
 
 HEADERS  += mainwindow.h \
     joybuttonwidget.h \
-    joystick.h \
-    joybutton.h \
-    event.h \
-    inputdaemon.h \
-    joyaxis.h \
     joyaxiswidget.h \
-    joydpad.h \
-    joydpadbutton.h \
     axiseditdialog.h \
-    xmlconfigreader.h \
-    xmlconfigwriter.h \
-    common.h \
     joytabwidget.h \
     axisvaluebox.h \
     advancebuttondialog.h \
     simplekeygrabberbutton.h \
-    joybuttonslot.h \
-    joyaxisbutton.h \
     aboutdialog.h \
-    xmlconfigmigration.h \
-    setjoystick.h \
-    sdleventreader.h \
     setaxisthrottledialog.h \
-    x11info.h \
     keyboard/virtualkeypushbutton.h \
     keyboard/virtualkeyboardmousewidget.h \
     keyboard/virtualmousepushbutton.h \
     buttoneditdialog.h \
-    commandlineutility.h \
-    joycontrolstick.h \
-    joycontrolstickbutton.h \
-    joycontrolstickdirectionstype.h \
     joycontrolstickeditdialog.h \
     joycontrolstickpushbutton.h \
     joycontrolstickbuttonpushbutton.h \
@@ -152,10 +114,8 @@ HEADERS  += mainwindow.h \
     virtualdpadpushbutton.h \
     dpadpushbutton.h \
     dpadeditdialog.h \
-    vdpad.h \
     joydpadbuttonwidget.h \
     quicksetdialog.h \
-    mousehelper.h \
     mousesettingsdialog.h \
     mousedialog/mousecontrolsticksettingsdialog.h \
     mousedialog/mouseaxissettingsdialog.h \
@@ -175,8 +135,6 @@ FORMS    += mainwindow.ui \
     mousesettingsdialog.ui
 
 
-LIBS += -lSDL -lXtst -lX11
-
 RESOURCES += \
     resources.qrc
 
@@ -0,0 +1,80 @@
+# Program sources that do not depend on the QtGui module. They are
+# shared with the tests and benchmarks, which build them in as well
+# since antimicro is not split into a library.
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += $$PWD/joystick.cpp \
+    $$PWD/joybutton.cpp \
+    $$PWD/event.cpp \
+    $$PWD/inputdaemon.cpp \
+    $$PWD/joyaxis.cpp \
+    $$PWD/joydpad.cpp \
+    $$PWD/joydpadbutton.cpp \
+    $$PWD/xmlconfigreader.cpp \
+    $$PWD/xmlconfigwriter.cpp \
+    $$PWD/joybuttonslot.cpp \
+    $$PWD/joyaxisbutton.cpp \
+    $$PWD/xmlconfigmigration.cpp \
+    $$PWD/setjoystick.cpp \
+    $$PWD/sdleventreader.cpp \
+    $$PWD/sdleventring.cpp \
+    $$PWD/evdeveventreader.cpp \
+    $$PWD/latencyhistogram.cpp \
+    $$PWD/eventrecorder.cpp \
+    $$PWD/replayeventreader.cpp \
+    $$PWD/outputsink.cpp \
+    $$PWD/x11outputsink.cpp \
+    $$PWD/nulloutputsink.cpp \
+    $$PWD/recordingoutputsink.cpp \
+    $$PWD/outputflushhelper.cpp \
+    $$PWD/mousescheduler.cpp \
+    $$PWD/axisfilter.cpp \
+    $$PWD/axiscalibration.cpp \
+    $$PWD/timerwheel.cpp \
+    $$PWD/x11info.cpp \
+    $$PWD/commandlineutility.cpp \
+    $$PWD/joycontrolstick.cpp \
+    $$PWD/joycontrolstickbutton.cpp \
+    $$PWD/vdpad.cpp \
+    $$PWD/mousehelper.cpp
+
+HEADERS += $$PWD/joystick.h \
+    $$PWD/joybutton.h \
+    $$PWD/event.h \
+    $$PWD/inputdaemon.h \
+    $$PWD/joyaxis.h \
+    $$PWD/joydpad.h \
+    $$PWD/joydpadbutton.h \
+    $$PWD/xmlconfigreader.h \
+    $$PWD/xmlconfigwriter.h \
+    $$PWD/common.h \
+    $$PWD/joybuttonslot.h \
+    $$PWD/joyaxisbutton.h \
+    $$PWD/xmlconfigmigration.h \
+    $$PWD/setjoystick.h \
+    $$PWD/sdleventreader.h \
+    $$PWD/sdleventring.h \
+    $$PWD/evdeveventreader.h \
+    $$PWD/latencyhistogram.h \
+    $$PWD/eventrecorder.h \
+    $$PWD/replayeventreader.h \
+    $$PWD/outputsink.h \
+    $$PWD/x11outputsink.h \
+    $$PWD/nulloutputsink.h \
+    $$PWD/recordingoutputsink.h \
+    $$PWD/outputflushhelper.h \
+    $$PWD/mousescheduler.h \
+    $$PWD/axisfilter.h \
+    $$PWD/axiscalibration.h \
+    $$PWD/timerwheel.h \
+    $$PWD/x11info.h \
+    $$PWD/commandlineutility.h \
+    $$PWD/joycontrolstick.h \
+    $$PWD/joycontrolstickbutton.h \
+    $$PWD/joycontrolstickdirectionstype.h \
+    $$PWD/vdpad.h \
+    $$PWD/mousehelper.h
+
+LIBS += -lSDL -lXtst -lX11 -lrt
@@ -0,0 +1,98 @@
+#include "axiscalibration.h"
+
+// Times in milliseconds
+const int AxisCalibration::DEFAULTDURATION = 5000;
+const int AxisCalibration::SAMPLEINTERVAL = 5;
+const int AxisCalibration::MINIMUMTRAVEL = 8000;
+
+AxisCalibration::AxisCalibration(Joystick *joystick, QObject *parent) :
+    QObject(parent)
+{
+    this->joystick = joystick;
+
+    sampleTimer.setInterval(SAMPLEINTERVAL);
+    finishTimer.setSingleShot(true);
+    connect(&sampleTimer, SIGNAL(timeout()), this, SLOT(sample()));
+    connect(&finishTimer, SIGNAL(timeout()), this, SLOT(finish()));
+}
+
+void AxisCalibration::start(int duration)
+{
+    int numberAxes = joystick->getActiveSetJoystick()->getNumberAxes();
+
+    centers.resize(numberAxes);
+    centered.resize(numberAxes);
+    minimums.resize(numberAxes);
+    maximums.resize(numberAxes);
+
+    for (int i=0; i < numberAxes; i++)
+    {
+        centered[i] = false;
+    }
+
+    sample();
+
+    sampleTimer.start();
+    finishTimer.start(duration);
+}
+
+bool AxisCalibration::isRunning()
+{
+    return finishTimer.isActive();
+}
+
+/* Values are read from the controller rather than from the axes of
+ * the active set. Those only follow the device while their set is
+ * active and are put back to the center when the set is reset.
+ */
+void AxisCalibration::sample()
+{
+    for (int i=0; i < centers.size(); i++)
+    {
+        if (joystick->hasDeviceAxisValue(i))
+        {
+            int value = joystick->getDeviceAxisValue(i);
+            if (!centered.at(i))
+            {
+                centers[i] = value;
+                minimums[i] = value;
+                maximums[i] = value;
+                centered[i] = true;
+            }
+            else if (value < minimums.at(i))
+            {
+                minimums[i] = value;
+            }
+            else if (value > maximums.at(i))
+            {
+                maximums[i] = value;
+            }
+        }
+    }
+}
+
+void AxisCalibration::finish()
+{
+    sampleTimer.stop();
+    sample();
+
+    int calibratedAxes = 0;
+    for (int i=0; i < centers.size(); i++)
+    {
+        int center = centers.at(i);
+        if (centered.at(i) &&
+            center - minimums.at(i) >= MINIMUMTRAVEL &&
+            maximums.at(i) - center >= MINIMUMTRAVEL)
+        {
+            joystick->setAxisCalibration(i, center, minimums.at(i), maximums.at(i));
+            calibratedAxes++;
+        }
+    }
+
+    if (calibratedAxes > 0)
+    {
+        joystick->writeCalibration();
+    }
+
+    emit finished(calibratedAxes);
+}
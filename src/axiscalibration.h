@@ -0,0 +1,48 @@
+#ifndef AXISCALIBRATION_H
+#define AXISCALIBRATION_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include "joystick.h"
+
+/* Short capture session used to calibrate the axes of a controller.
+ * The values the device last reported when the session starts are
+ * taken as the rest position of each axis. An axis that has not
+ * reported anything yet takes its first value seen during the
+ * session instead. The extremes reached while the session runs
+ * become the range. Axes that were not moved far enough to both
+ * sides keep their previous calibration.
+ */
+class AxisCalibration : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AxisCalibration(Joystick *joystick, QObject *parent = 0);
+
+    void start(int duration=DEFAULTDURATION);
+    bool isRunning();
+
+    static const int DEFAULTDURATION;
+    static const int SAMPLEINTERVAL;
+    static const int MINIMUMTRAVEL;
+
+protected:
+    Joystick *joystick;
+    QTimer sampleTimer;
+    QTimer finishTimer;
+    QVector<int> centers;
+    QVector<bool> centered;
+    QVector<int> minimums;
+    QVector<int> maximums;
+
+signals:
+    void finished(int calibratedAxes);
+
+private slots:
+    void sample();
+    void finish();
+};
+
+#endif // AXISCALIBRATION_H
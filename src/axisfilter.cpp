@@ -0,0 +1,137 @@
+#include <cmath>
+
+#include "axisfilter.h"
+#include "joyaxis.h"
+
+const double AxisFilter::DEFAULTCUTOFF = 5.0;
+const double AxisFilter::MINCUTOFF = 1.0;
+const double AxisFilter::MAXCUTOFF = 100.0;
+const double AxisFilter::DEFAULTBETA = 1.0;
+const double AxisFilter::DERIVATIVECUTOFF = 1.0;
+// Time in milliseconds
+const int AxisFilter::MAXLATENCY = 50;
+
+AxisFilter::AxisFilter()
+{
+    mode = NoFilter;
+    cutoff = DEFAULTCUTOFF;
+    beta = DEFAULTBETA;
+    reset();
+}
+
+/* Filter a new raw value read at the passed monotonic time in
+ * nanoseconds. Returns the value that should be used in place of
+ * the raw value.
+ */
+int AxisFilter::filter(int value, qint64 timestamp)
+{
+    int result = value;
+
+    if (mode != NoFilter)
+    {
+        if (!primed)
+        {
+            filteredValue = value;
+            filteredDerivative = 0.0;
+            valueChangeTimestamp = timestamp;
+            primed = true;
+        }
+        else
+        {
+            double elapsed = (timestamp - lastTimestamp) / 1000000000.0;
+            if (value != lastValue)
+            {
+                valueChangeTimestamp = timestamp;
+            }
+
+            if (timestamp - valueChangeTimestamp >= (qint64)MAXLATENCY * 1000000)
+            {
+                // Input has been steady long enough. Stop lagging behind
+                filteredValue = value;
+                filteredDerivative = 0.0;
+            }
+            else if (elapsed > 0.0)
+            {
+                double tempcutoff = cutoff;
+                if (mode == OneEuroFilter)
+                {
+                    double derivative = ((value - filteredValue) / (double)JoyAxis::AXISMAX) / elapsed;
+                    double derivativeAlpha = smoothingFactor(DERIVATIVECUTOFF, elapsed);
+                    filteredDerivative += derivativeAlpha * (derivative - filteredDerivative);
+                    tempcutoff = cutoff + beta * fabs(filteredDerivative);
+                }
+
+                double alpha = smoothingFactor(tempcutoff, elapsed);
+                filteredValue += alpha * (value - filteredValue);
+            }
+        }
+
+        lastValue = value;
+        lastTimestamp = timestamp;
+        result = (int)floor(filteredValue + 0.5);
+        lastOutput = result;
+    }
+
+    return result;
+}
+
+// Check whether the last output matches the last raw value
+bool AxisFilter::isSettled()
+{
+    return !primed || lastOutput == lastValue;
+}
+
+void AxisFilter::reset()
+{
+    primed = false;
+    filteredValue = 0.0;
+    filteredDerivative = 0.0;
+    lastValue = 0;
+    lastOutput = 0;
+    lastTimestamp = 0;
+    valueChangeTimestamp = 0;
+}
+
+void AxisFilter::setMode(FilterMode mode)
+{
+    this->mode = mode;
+    reset();
+}
+
+AxisFilter::FilterMode AxisFilter::getMode()
+{
+    return mode;
+}
+
+void AxisFilter::setCutoff(double value)
+{
+    if (value >= MINCUTOFF && value <= MAXCUTOFF)
+    {
+        cutoff = value;
+    }
+}
+
+double AxisFilter::getCutoff()
+{
+    return cutoff;
+}
+
+void AxisFilter::setBeta(double value)
+{
+    if (value >= 0.0 && value <= 1000.0)
+    {
+        beta = value;
+    }
+}
+
+double AxisFilter::getBeta()
+{
+    return beta;
+}
+
+// Weight of a new sample for a first order low pass filter
+double AxisFilter::smoothingFactor(double cutoff, double elapsed)
+{
+    double rate = 2.0 * M_PI * cutoff * elapsed;
+    return rate / (rate + 1.0);
+}
@@ -0,0 +1,56 @@
+#ifndef AXISFILTER_H
+#define AXISFILTER_H
+
+#include <QtGlobal>
+
+/* Low pass filter for the raw values of one axis. The EMA mode uses
+ * a fixed cutoff frequency. The One Euro mode raises the cutoff as
+ * the axis moves faster so jitter is removed while the axis is
+ * resting without adding much lag to quick movements. Values that
+ * stop changing are passed through unfiltered after MAXLATENCY so the
+ * filter never holds an axis away from its real position for long.
+ */
+class AxisFilter
+{
+public:
+    explicit AxisFilter();
+
+    enum FilterMode {NoFilter=0, EMAFilter, OneEuroFilter};
+
+    int filter(int value, qint64 timestamp);
+    bool isSettled();
+    void reset();
+
+    void setMode(FilterMode mode);
+    FilterMode getMode();
+    void setCutoff(double value);
+    double getCutoff();
+    void setBeta(double value);
+    double getBeta();
+
+    static const double DEFAULTCUTOFF;
+    static const double MINCUTOFF;
+    static const double MAXCUTOFF;
+    static const double DEFAULTBETA;
+    static const double DERIVATIVECUTOFF;
+    static const int MAXLATENCY;
+
+protected:
+    double smoothingFactor(double cutoff, double elapsed);
+
+    FilterMode mode;
+    // Cutoff frequency in Hz. The minimum cutoff in One Euro mode
+    double cutoff;
+    // Cutoff increase in Hz for each full deflection per second
+    double beta;
+
+    bool primed;
+    double filteredValue;
+    double filteredDerivative;
+    int lastValue;
+    int lastOutput;
+    qint64 lastTimestamp;
+    qint64 valueChangeTimestamp;
+};
+
+#endif // AXISFILTER_H
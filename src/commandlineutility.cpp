@@ -1,6 +1,7 @@
 #include <QDebug>
 #include <QStringListIterator>
 #include <QFileInfo>
+#include <QDir>
 #include <QTextStream>
 
 #include "commandlineutility.h"
@@ -13,6 +14,16 @@ QRegExp CommandLineUtility::noTrayRegexp = QRegExp("--no-tray");
 QRegExp CommandLineUtility::loadProfileRegexp = QRegExp("--profile");
 QRegExp CommandLineUtility::loadProfileForControllerRegexp = QRegExp("--profile-controller");
 QRegExp CommandLineUtility::hiddenRegexp = QRegExp("--hidden");
+QRegExp CommandLineUtility::inputBackendRegexp = QRegExp("--input-backend");
+QRegExp CommandLineUtility::coalesceAxesRegexp = QRegExp("--coalesce-axes");
+QRegExp CommandLineUtility::recordRegexp = QRegExp("--record");
+QRegExp CommandLineUtility::replayRegexp = QRegExp("--replay");
+QRegExp CommandLineUtility::replayFastRegexp = QRegExp("--replay-fast");
+QRegExp CommandLineUtility::outputSinkRegexp = QRegExp("--output");
+QRegExp CommandLineUtility::outputTraceRegexp = QRegExp("--output-trace");
+QRegExp CommandLineUtility::traceNoTimesRegexp = QRegExp("--output-trace-no-times");
+QRegExp CommandLineUtility::batchOutputRegexp = QRegExp("--batch-output");
+QRegExp CommandLineUtility::mouseRateRegexp = QRegExp("--mouse-rate");
 
 
 CommandLineUtility::CommandLineUtility(QObject *parent) :
@@ -26,6 +37,16 @@ CommandLineUtility::CommandLineUtility(QObject *parent) :
     controllerNumber = 0;
     encounteredError = false;
     hiddenRequest = false;
+    inputBackend = SDLBackend;
+    coalesceAxes = false;
+    recordFile = QString();
+    replayFile = QString();
+    fastReplay = false;
+    outputSink = X11Output;
+    outputTraceFile = QString();
+    traceTimingDisabled = false;
+    batchOutput = false;
+    mouseRate = 0;
 }
 
 void CommandLineUtility::parseArguments(QStringList& arguments)
@@ -103,6 +124,132 @@ void CommandLineUtility::parseArguments(QStringList& arguments)
         {
             hiddenRequest = true;
         }
+        else if (inputBackendRegexp.exactMatch(temp))
+        {
+            if (iter.hasNext())
+            {
+                temp = iter.next();
+                if (temp == "sdl")
+                {
+                    inputBackend = SDLBackend;
+                }
+                else if (temp == "evdev")
+                {
+                    inputBackend = EvdevBackend;
+                }
+                else
+                {
+                    errorsteam << tr("Input backend %1 is not supported.").arg(temp) << endl;
+                    encounteredError = true;
+                }
+            }
+        }
+        else if (coalesceAxesRegexp.exactMatch(temp))
+        {
+            coalesceAxes = true;
+        }
+        else if (recordRegexp.exactMatch(temp))
+        {
+            if (iter.hasNext())
+            {
+                temp = iter.next();
+                QFileInfo fileInfo(temp);
+                if (fileInfo.absoluteDir().exists())
+                {
+                    recordFile = fileInfo.absoluteFilePath();
+                }
+                else
+                {
+                    errorsteam << tr("Directory for recording %1 does not exist.").arg(temp) << endl;
+                    encounteredError = true;
+                }
+            }
+        }
+        else if (replayRegexp.exactMatch(temp))
+        {
+            if (iter.hasNext())
+            {
+                temp = iter.next();
+                QFileInfo fileInfo(temp);
+                if (fileInfo.exists())
+                {
+                    replayFile = fileInfo.absoluteFilePath();
+                }
+                else
+                {
+                    errorsteam << tr("Recording %1 does not exist.").arg(temp) << endl;
+                    encounteredError = true;
+                }
+            }
+        }
+        else if (replayFastRegexp.exactMatch(temp))
+        {
+            fastReplay = true;
+        }
+        else if (outputSinkRegexp.exactMatch(temp))
+        {
+            if (iter.hasNext())
+            {
+                temp = iter.next();
+                if (temp == "x11")
+                {
+                    outputSink = X11Output;
+                }
+                else if (temp == "null")
+                {
+                    outputSink = NullOutput;
+                }
+                else
+                {
+                    errorsteam << tr("Output %1 is not supported.").arg(temp) << endl;
+                    encounteredError = true;
+                }
+            }
+        }
+        else if (outputTraceRegexp.exactMatch(temp))
+        {
+            if (iter.hasNext())
+            {
+                temp = iter.next();
+                QFileInfo fileInfo(temp);
+                if (fileInfo.absoluteDir().exists())
+                {
+                    outputTraceFile = fileInfo.absoluteFilePath();
+                }
+                else
+                {
+                    errorsteam << tr("Directory for output trace %1 does not exist.").arg(temp) << endl;
+                    encounteredError = true;
+                }
+            }
+        }
+        else if (traceNoTimesRegexp.exactMatch(temp))
+        {
+            traceTimingDisabled = true;
+        }
+        else if (batchOutputRegexp.exactMatch(temp))
+        {
+            batchOutput = true;
+        }
+        else if (mouseRateRegexp.exactMatch(temp))
+        {
+            if (iter.hasNext())
+            {
+                temp = iter.next();
+
+                bool validNumber = false;
+                int tempNumber = temp.toInt(&validNumber);
+                if (validNumber && tempNumber > 0)
+                {
+                    mouseRate = tempNumber;
+                }
+                else
+                {
+                    errorsteam << tr("Mouse rate is not a valid number.") << endl;
+                    encounteredError = true;
+                }
+            }
+        }
     }
 }
 
@@ -127,6 +274,30 @@ void CommandLineUtility::printHelp()
            tr("Launch program with the configuration file\n                            selected as the default for all available\n                            controllers.")
         << endl;
     out << "--profile-controller number" << " " << tr("Apply configuration file to a specific controller.") << endl;
+    out << "--input-backend name       " << " " <<
+           tr("Select how controller events are read. Valid\n                            values are sdl (default) and evdev.")
+        << endl;
+    out << "--coalesce-axes            " << " " <<
+           tr("Only process the latest value of an axis when\n                            several are queued at once.")
+        << endl;
+    out << "--record location          " << " " << tr("Write every controller event to a file.") << endl;
+    out << "--replay location          " << " " <<
+           tr("Read controller events from a recording instead\n                            of from controllers. Statistics are printed\n                            and the program exits when it ends. With\n                            --output null or --output-trace no window is\n                            opened and no X server is needed. Only\n                            --profile and --profile-controller apply then.")
+        << endl;
+    out << "--replay-fast              " << " " << tr("Replay events as fast as possible.") << endl;
+    out << "--output name              " << " " <<
+           tr("Select where generated events are sent. Valid\n                            values are x11 (default) and null.")
+        << endl;
+    out << "--output-trace location    " << " " <<
+           tr("Do not send generated events anywhere and write\n                            them to a file on exit.")
+        << endl;
+    out << "--output-trace-no-times    " << " " << tr("Leave event times out of the output trace.") << endl;
+    out << "--batch-output             " << " " <<
+           tr("Flush generated events once per batch of\n                            controller events instead of after each one.")
+        << endl;
+    out << "--mouse-rate hz            " << " " <<
+           tr("Number of times per second mouse movement is\n                            generated. Default is 250.")
+        << endl;
 }
 
 bool CommandLineUtility::isHelpRequested()
@@ -179,3 +350,73 @@ bool CommandLineUtility::isHiddenRequested()
 {
     return hiddenRequest;
 }
+
+CommandLineUtility::InputBackend CommandLineUtility::getInputBackend()
+{
+    return inputBackend;
+}
+
+bool CommandLineUtility::isAxisCoalescingEnabled()
+{
+    return coalesceAxes;
+}
+
+bool CommandLineUtility::hasRecordFile()
+{
+    return !recordFile.isEmpty();
+}
+
+QString CommandLineUtility::getRecordFile()
+{
+    return recordFile;
+}
+
+bool CommandLineUtility::hasReplayFile()
+{
+    return !replayFile.isEmpty();
+}
+
+QString CommandLineUtility::getReplayFile()
+{
+    return replayFile;
+}
+
+bool CommandLineUtility::isFastReplayEnabled()
+{
+    return fastReplay;
+}
+
+CommandLineUtility::OutputSinkType CommandLineUtility::getOutputSink()
+{
+    return outputSink;
+}
+
+bool CommandLineUtility::hasOutputTraceFile()
+{
+    return !outputTraceFile.isEmpty();
+}
+
+QString CommandLineUtility::getOutputTraceFile()
+{
+    return outputTraceFile;
+}
+
+bool CommandLineUtility::isTraceTimingDisabled()
+{
+    return traceTimingDisabled;
+}
+
+bool CommandLineUtility::isOutputBatchingEnabled()
+{
+    return batchOutput;
+}
+
+bool CommandLineUtility::hasMouseRate()
+{
+    return mouseRate > 0;
+}
+
+int CommandLineUtility::getMouseRate()
+{
+    return mouseRate;
+}
@@ -11,6 +11,9 @@ class CommandLineUtility : public QObject
 public:
     explicit CommandLineUtility(QObject *parent = 0);
 
+    enum InputBackend {SDLBackend=0, EvdevBackend};
+    enum OutputSinkType {X11Output=0, NullOutput};
+
     void parseArguments(QStringList& arguments);
     bool isLaunchInTrayEnabled();
     bool isHelpRequested();
@@ -21,6 +24,20 @@ public:
     QString getProfileLocation();
     unsigned int getControllerNumber();
     bool isHiddenRequested();
+    InputBackend getInputBackend();
+    bool isAxisCoalescingEnabled();
+    bool hasRecordFile();
+    QString getRecordFile();
+    bool hasReplayFile();
+    QString getReplayFile();
+    bool isFastReplayEnabled();
+    OutputSinkType getOutputSink();
+    bool hasOutputTraceFile();
+    QString getOutputTraceFile();
+    bool isTraceTimingDisabled();
+    bool isOutputBatchingEnabled();
+    bool hasMouseRate();
+    int getMouseRate();
 
     void printHelp();
     void printVersionString();
@@ -36,6 +53,16 @@ protected:
     unsigned int controllerNumber;
     bool encounteredError;
     bool hiddenRequest;
+    InputBackend inputBackend;
+    bool coalesceAxes;
+    QString recordFile;
+    QString replayFile;
+    bool fastReplay;
+    OutputSinkType outputSink;
+    QString outputTraceFile;
+    bool traceTimingDisabled;
+    bool batchOutput;
+    int mouseRate;
 
     static QRegExp trayRegexp;
     static QRegExp helpRegexp;
@@ -44,6 +71,16 @@ protected:
     static QRegExp loadProfileRegexp;
     static QRegExp loadProfileForControllerRegexp;
     static QRegExp hiddenRegexp;
+    static QRegExp inputBackendRegexp;
+    static QRegExp coalesceAxesRegexp;
+    static QRegExp recordRegexp;
+    static QRegExp replayRegexp;
+    static QRegExp replayFastRegexp;
+    static QRegExp outputSinkRegexp;
+    static QRegExp outputTraceRegexp;
+    static QRegExp traceNoTimesRegexp;
+    static QRegExp batchOutputRegexp;
+    static QRegExp mouseRateRegexp;
     
 signals:
     
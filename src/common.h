@@ -5,6 +5,7 @@
 #include <QString>
 #include <QDir>
 #include <QSettings>
+#include <time.h>
 
 namespace PadderCommon
 {
@@ -13,9 +14,31 @@ namespace PadderCommon
                 QDir::homePath() + "/.config/antimicro";
     const QString configFileName = "antimicro_settings.ini";
     const QString configFilePath = configPath + "/" + configFileName;
+    // Axis calibration is kept apart from the settings file since
+    // that file is cleared every time the settings are saved
+    const QString calibrationFileName = "antimicro_calibration.ini";
+    const QString calibrationFilePath = configPath + "/" + calibrationFileName;
     const QString pidFilePath = "/tmp/antimicro.pid";
     const int LATESTCONFIGFILEVERSION = 4;
     const QString programVersion = "1.0";
+
+#ifdef MOCK_MONOTONIC_TIME
+    // Set by tests that advance the time seen by the program themselves
+    extern qint64 mockMonotonicTime;
+
+    inline qint64 getMonotonicTime()
+    {
+        return mockMonotonicTime;
+    }
+#else
+    // Current time of the monotonic clock in nanoseconds
+    inline qint64 getMonotonicTime()
+    {
+        struct timespec currentTime;
+        clock_gettime(CLOCK_MONOTONIC, &currentTime);
+        return (qint64)currentTime.tv_sec * 1000000000LL + currentTime.tv_nsec;
+    }
+#endif
 }
 
 #endif // COMMON_H
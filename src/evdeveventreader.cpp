@@ -0,0 +1,490 @@
+#include <QTextStream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "evdeveventreader.h"
+#include "common.h"
+
+// SDL 1.2 only probes the first 32 event devices
+const int EvdevEventReader::MAXDEVICES = 32;
+
+static const int BITSPERLONG = sizeof(unsigned long) * 8;
+
+static const int KEYBITLONGS = KEY_MAX / BITSPERLONG + 1;
+static const int ABSBITLONGS = ABS_MAX / BITSPERLONG + 1;
+
+static inline bool testBit(int bit, unsigned long *array)
+{
+    return (array[bit / BITSPERLONG] >> (bit % BITSPERLONG)) & 1UL;
+}
+
+/* Read the key and absolute axis bits of an event device. Returns
+ * true if SDL 1.2 would open the device as a joystick.
+ */
+static bool readJoystickBits(int fd, unsigned long *keybit, unsigned long *absbit)
+{
+    unsigned long evbit[EV_MAX / BITSPERLONG + 1];
+    memset(evbit, 0, sizeof(evbit));
+    memset(keybit, 0, KEYBITLONGS * sizeof(unsigned long));
+    memset(absbit, 0, ABSBITLONGS * sizeof(unsigned long));
+
+    bool isJoystick = false;
+    if (ioctl(fd, EVIOCGBIT(0, sizeof(evbit)), evbit) >= 0 &&
+        ioctl(fd, EVIOCGBIT(EV_KEY, KEYBITLONGS * sizeof(unsigned long)), keybit) >= 0 &&
+        ioctl(fd, EVIOCGBIT(EV_ABS, ABSBITLONGS * sizeof(unsigned long)), absbit) >= 0)
+    {
+        isJoystick = testBit(EV_KEY, evbit) && testBit(EV_ABS, evbit) &&
+                     testBit(ABS_X, absbit) && testBit(ABS_Y, absbit) &&
+                     (testBit(BTN_TRIGGER, keybit) || testBit(BTN_A, keybit) ||
+                      testBit(BTN_1, keybit));
+    }
+
+    return isJoystick;
+}
+
+EvdevEventReader::EvdevEventReader(QHash<int, Joystick*> *joysticks, QObject *parent) :
+    SDLEventReader(joysticks, parent)
+{
+    epollFd = -1;
+    wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+EvdevEventReader::~EvdevEventReader()
+{
+    closeDevices();
+
+    if (wakeupFd >= 0)
+    {
+        close(wakeupFd);
+        wakeupFd = -1;
+    }
+}
+
+/* Wait on every joystick event device at once. Each wakeup reads
+ * everything the kernel has queued and hands it to InputDaemon as
+ * a single batch. Events keep the timestamp assigned by the kernel.
+ */
+void EvdevEventReader::performWork()
+{
+    bool quit = false;
+    bool waitError = false;
+
+    openDevices();
+
+    while (sdlIsOpen && !quit && !waitError && epollFd >= 0)
+    {
+        struct epoll_event readyEvents[16];
+        int count = epoll_wait(epollFd, readyEvents, 16, -1);
+        if (count < 0 && errno != EINTR)
+        {
+            waitError = true;
+        }
+
+        for (int i=0; i < count; i++)
+        {
+            EvdevDevice *device = static_cast<EvdevDevice*>(readyEvents[i].data.ptr);
+            if (!device)
+            {
+                quint64 wakeupCount = 0;
+                if (read(wakeupFd, &wakeupCount, sizeof(wakeupCount)) > 0)
+                {
+                    quit = true;
+                }
+            }
+            else
+            {
+                bool deviceLost = false;
+                readDevice(device, deviceLost);
+                if (deviceLost)
+                {
+                    // Device was unplugged. Stop waiting on it.
+                    epoll_ctl(epollFd, EPOLL_CTL_DEL, device->fd, 0);
+                    close(device->fd);
+                    device->fd = -1;
+                }
+            }
+        }
+
+        if (quit)
+        {
+            SDL_Event event;
+            event.type = SDL_QUIT;
+            pushEvent(event, PadderCommon::getMonotonicTime());
+        }
+
+        if (!eventRing.isEmpty() && eventRing.markPending())
+        {
+            emit eventRaised();
+        }
+    }
+
+    closeDevices();
+
+    if (quit)
+    {
+        emit finished();
+    }
+}
+
+void EvdevEventReader::stop()
+{
+    if (wakeupFd >= 0)
+    {
+        quint64 wakeupCount = 1;
+        write(wakeupFd, &wakeupCount, sizeof(wakeupCount));
+    }
+}
+
+/* Describe the joystick event devices in the order SDL 1.2 numbers
+ * them. The identity of a device is made of its node along with the
+ * physical path and unique id reported by the kernel so it tells
+ * apart controllers that have the same name. It is left empty when
+ * the device does not have the name of the SDL joystick at the same
+ * index, such as when the event devices cannot be read.
+ */
+QStringList EvdevEventReader::findDeviceIdentities()
+{
+    QStringList identities;
+
+    for (int i=0; i < MAXDEVICES; i++)
+    {
+        QString path = QString("/dev/input/event%1").arg(i);
+        int fd = open(path.toUtf8().constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd >= 0)
+        {
+            unsigned long keybit[KEYBITLONGS];
+            unsigned long absbit[ABSBITLONGS];
+            if (readJoystickBits(fd, keybit, absbit))
+            {
+                char name[256];
+                char phys[256];
+                char uniq[256];
+                memset(name, 0, sizeof(name));
+                memset(phys, 0, sizeof(phys));
+                memset(uniq, 0, sizeof(uniq));
+                ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name);
+                ioctl(fd, EVIOCGPHYS(sizeof(phys) - 1), phys);
+                ioctl(fd, EVIOCGUNIQ(sizeof(uniq) - 1), uniq);
+
+                int index = identities.size();
+                if (index < SDL_NumJoysticks() && QString(name) == QString(SDL_JoystickName(index)))
+                {
+                    identities.append(QString("%1 %2 %3").arg(path).arg(phys).arg(uniq));
+                }
+                else
+                {
+                    identities.append(QString());
+                }
+            }
+
+            close(fd);
+        }
+    }
+
+    return identities;
+}
+
+/* Probe event devices in the same order as SDL 1.2 does so that
+ * the n-th joystick device found here is SDL joystick index n.
+ */
+void EvdevEventReader::openDevices()
+{
+    closeDevices();
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd >= 0)
+    {
+        struct epoll_event wakeupEvent;
+        memset(&wakeupEvent, 0, sizeof(wakeupEvent));
+        wakeupEvent.events = EPOLLIN;
+        wakeupEvent.data.ptr = 0;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeupFd, &wakeupEvent);
+
+        int index = 0;
+        for (int i=0; i < MAXDEVICES; i++)
+        {
+            QString path = QString("/dev/input/event%1").arg(i);
+            EvdevDevice *device = openDevice(path, index);
+            if (device)
+            {
+                struct epoll_event deviceEvent;
+                memset(&deviceEvent, 0, sizeof(deviceEvent));
+                deviceEvent.events = EPOLLIN;
+                deviceEvent.data.ptr = device;
+                epoll_ctl(epollFd, EPOLL_CTL_ADD, device->fd, &deviceEvent);
+
+                devices.append(device);
+                index++;
+            }
+        }
+    }
+}
+
+void EvdevEventReader::closeDevices()
+{
+    QListIterator<EvdevDevice*> iter(devices);
+    while (iter.hasNext())
+    {
+        EvdevDevice *device = iter.next();
+        if (device->fd >= 0)
+        {
+            close(device->fd);
+            device->fd = -1;
+        }
+
+        delete device;
+        device = 0;
+    }
+
+    devices.clear();
+
+    if (epollFd >= 0)
+    {
+        close(epollFd);
+        epollFd = -1;
+    }
+}
+
+/* Open an event device and build the button, axis and hat maps
+ * used by SDL 1.2. Returns 0 if the device is not a joystick.
+ */
+EvdevDevice* EvdevEventReader::openDevice(QString path, int index)
+{
+    EvdevDevice *device = 0;
+
+    int fd = open(path.toUtf8().constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        unsigned long keybit[KEYBITLONGS];
+        unsigned long absbit[ABSBITLONGS];
+
+        if (readJoystickBits(fd, keybit, absbit))
+        {
+            device = new EvdevDevice;
+            memset(device, 0, sizeof(EvdevDevice));
+            device->fd = fd;
+            device->index = index;
+
+            // Buttons in the joystick range come first, followed
+            // by the miscellaneous buttons.
+            for (int i=BTN_JOYSTICK; i < KEY_MAX; i++)
+            {
+                if (testBit(i, keybit))
+                {
+                    device->keyMap[i - BTN_MISC] = device->numberButtons++;
+                }
+            }
+
+            for (int i=BTN_MISC; i < BTN_JOYSTICK; i++)
+            {
+                if (testBit(i, keybit))
+                {
+                    device->keyMap[i - BTN_MISC] = device->numberButtons++;
+                }
+            }
+
+            for (int i=0; i < ABS_MAX; i++)
+            {
+                // Skip hats
+                if (i == ABS_HAT0X)
+                {
+                    i = ABS_HAT3Y;
+                }
+                else if (testBit(i, absbit))
+                {
+                    struct input_absinfo absinfo;
+                    if (ioctl(fd, EVIOCGABS(i), &absinfo) >= 0)
+                    {
+                        device->absMap[i] = device->numberAxes++;
+                        if (absinfo.minimum != absinfo.maximum)
+                        {
+                            int middle = (absinfo.maximum + absinfo.minimum) / 2;
+                            int range = (absinfo.maximum - absinfo.minimum) / 2 - 2 * absinfo.flat;
+
+                            device->absCorrectUsed[i] = true;
+                            device->absCorrect[i][0] = middle - absinfo.flat;
+                            device->absCorrect[i][1] = middle + absinfo.flat;
+                            device->absCorrect[i][2] = (range != 0) ? (1 << 29) / range : 0;
+                        }
+                    }
+                }
+            }
+
+            for (int i=ABS_HAT0X; i <= ABS_HAT3Y; i += 2)
+            {
+                if (testBit(i, absbit) || testBit(i + 1, absbit))
+                {
+                    device->numberHats++;
+                }
+            }
+
+            for (int i=0; i < 4; i++)
+            {
+                device->hatAxes[i][0] = 1;
+                device->hatAxes[i][1] = 1;
+            }
+
+            // Prefer kernel timestamps taken from the monotonic clock.
+            // Otherwise, convert wall clock timestamps when read.
+            bool monotonicClock = false;
+#ifdef EVIOCSCLOCKID
+            int clockId = CLOCK_MONOTONIC;
+            monotonicClock = ioctl(fd, EVIOCSCLOCKID, &clockId) >= 0;
+#endif
+            if (!monotonicClock)
+            {
+                struct timespec realTime;
+                clock_gettime(CLOCK_REALTIME, &realTime);
+                qint64 realTimeNs = (qint64)realTime.tv_sec * 1000000000LL + realTime.tv_nsec;
+                device->clockOffset = PadderCommon::getMonotonicTime() - realTimeNs;
+            }
+
+            if (index < SDL_NumJoysticks())
+            {
+                char name[256];
+                memset(name, 0, sizeof(name));
+                ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name);
+                if (QString(name) != QString(SDL_JoystickName(index)))
+                {
+                    QTextStream errorstream(stderr);
+                    errorstream << tr("Event device %1 does not match SDL joystick %2.").arg(path).arg(index + 1) << endl;
+                }
+            }
+        }
+        else
+        {
+            close(fd);
+        }
+    }
+
+    return device;
+}
+
+void EvdevEventReader::readDevice(EvdevDevice *device, bool &deviceLost)
+{
+    struct input_event inputEvents[64];
+    bool readAgain = true;
+
+    while (readAgain)
+    {
+        ssize_t length = read(device->fd, inputEvents, sizeof(inputEvents));
+        if (length > 0)
+        {
+            int count = length / sizeof(struct input_event);
+            for (int i=0; i < count; i++)
+            {
+                handleInputEvent(device, inputEvents[i]);
+            }
+        }
+        else
+        {
+            readAgain = false;
+            if (length < 0 && errno == ENODEV)
+            {
+                deviceLost = true;
+            }
+        }
+    }
+}
+
+void EvdevEventReader::handleInputEvent(EvdevDevice *device, struct input_event &inputEvent)
+{
+    qint64 timestamp = (qint64)inputEvent.time.tv_sec * 1000000000LL +
+                       (qint64)inputEvent.time.tv_usec * 1000LL + device->clockOffset;
+    int code = inputEvent.code;
+    SDL_Event event;
+
+    if (inputEvent.type == EV_KEY && code >= BTN_MISC && code <= KEY_MAX)
+    {
+        bool pressed = inputEvent.value != 0;
+        if (device->buttonStates[code - BTN_MISC] != pressed)
+        {
+            device->buttonStates[code - BTN_MISC] = pressed;
+            event.type = pressed ? SDL_JOYBUTTONDOWN : SDL_JOYBUTTONUP;
+            event.button.type = event.type;
+            event.button.which = device->index;
+            event.button.button = device->keyMap[code - BTN_MISC];
+            event.button.state = pressed ? SDL_PRESSED : SDL_RELEASED;
+            pushEvent(event, timestamp);
+        }
+    }
+    else if (inputEvent.type == EV_ABS && code >= ABS_HAT0X && code <= ABS_HAT3Y)
+    {
+        int hat = (code - ABS_HAT0X) / 2;
+        int axis = (code - ABS_HAT0X) % 2;
+        int value = (inputEvent.value < 0) ? 0 : ((inputEvent.value == 0) ? 1 : 2);
+        if (device->hatAxes[hat][axis] != value)
+        {
+            static const Uint8 positionMap[3][3] = {
+                {SDL_HAT_LEFTUP, SDL_HAT_UP, SDL_HAT_RIGHTUP},
+                {SDL_HAT_LEFT, SDL_HAT_CENTERED, SDL_HAT_RIGHT},
+                {SDL_HAT_LEFTDOWN, SDL_HAT_DOWN, SDL_HAT_RIGHTDOWN}
+            };
+
+            device->hatAxes[hat][axis] = value;
+            event.type = SDL_JOYHATMOTION;
+            event.jhat.type = event.type;
+            event.jhat.which = device->index;
+            event.jhat.hat = hat;
+            event.jhat.value = positionMap[device->hatAxes[hat][1]][device->hatAxes[hat][0]];
+            pushEvent(event, timestamp);
+        }
+    }
+    else if (inputEvent.type == EV_ABS && code < ABS_MAX)
+    {
+        int value = correctAxisValue(device, code, inputEvent.value);
+        if (device->absValues[code] != value)
+        {
+            device->absValues[code] = value;
+            event.type = SDL_JOYAXISMOTION;
+            event.jaxis.type = event.type;
+            event.jaxis.which = device->index;
+            event.jaxis.axis = device->absMap[code];
+            event.jaxis.value = value;
+            pushEvent(event, timestamp);
+        }
+    }
+}
+
+/* Same correction applied by SDL 1.2 to scale raw axis values
+ * into the -32768 to 32767 range.
+ */
+int EvdevEventReader::correctAxisValue(EvdevDevice *device, int code, int value)
+{
+    if (device->absCorrectUsed[code])
+    {
+        if (value > device->absCorrect[code][0] && value < device->absCorrect[code][1])
+        {
+            // Inside the flat area of the axis
+            value = 0;
+        }
+        else if (value > device->absCorrect[code][0])
+        {
+            value -= device->absCorrect[code][1];
+        }
+        else
+        {
+            value -= device->absCorrect[code][0];
+        }
+
+        value *= device->absCorrect[code][2];
+        value >>= 14;
+    }
+
+    if (value < -32768)
+    {
+        value = -32768;
+    }
+    else if (value > 32767)
+    {
+        value = 32767;
+    }
+
+    return value;
+}
@@ -0,0 +1,68 @@
+#ifndef EVDEVEVENTREADER_H
+#define EVDEVEVENTREADER_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <linux/input.h>
+
+#include "sdleventreader.h"
+
+// State needed to translate the events of one evdev device
+// into the SDL events that SDL 1.2 would have produced
+struct EvdevDevice
+{
+    int fd;
+    int index;
+    qint64 clockOffset;
+    int numberButtons;
+    int numberAxes;
+    int numberHats;
+    int keyMap[KEY_MAX - BTN_MISC + 1];
+    bool buttonStates[KEY_MAX - BTN_MISC + 1];
+    int absMap[ABS_MAX + 1];
+    int absValues[ABS_MAX + 1];
+    bool absCorrectUsed[ABS_MAX + 1];
+    int absCorrect[ABS_MAX + 1][3];
+    int hatAxes[4][2];
+};
+
+/* Alternative reader that bypasses SDL_WaitEvent. Joystick event
+ * devices are read directly and waited on with epoll so events are
+ * handed to InputDaemon as soon as the kernel reports them. Device
+ * numbering and axis correction mirror the SDL 1.2 Linux driver so
+ * the rest of the program sees the same buttons, axes and hats.
+ */
+class EvdevEventReader : public SDLEventReader
+{
+    Q_OBJECT
+public:
+    explicit EvdevEventReader(QHash<int, Joystick*> *joysticks, QObject *parent = 0);
+    ~EvdevEventReader();
+
+    static QStringList findDeviceIdentities();
+
+    static const int MAXDEVICES;
+
+protected:
+    void openDevices();
+    void closeDevices();
+    EvdevDevice* openDevice(QString path, int index);
+    void readDevice(EvdevDevice *device, bool &deviceLost);
+    void handleInputEvent(EvdevDevice *device, struct input_event &inputEvent);
+    int correctAxisValue(EvdevDevice *device, int code, int value);
+
+    QList<EvdevDevice*> devices;
+    int epollFd;
+    int wakeupFd;
+
+signals:
+
+public slots:
+    virtual void performWork();
+    virtual void stop();
+};
+
+#endif // EVDEVEVENTREADER_H
@@ -3,43 +3,33 @@
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
 #include <X11/XKBlib.h>
-#include <X11/extensions/XTest.h>
 #include <cmath>
 
 #include "event.h"
 #include "x11info.h"
+#include "outputsink.h"
+#include "outputflushhelper.h"
 
 Display* display;
 MouseHelper mouseHelperObj;
+OutputFlushHelper outputFlushHelperObj;
 
 //actually creates an XWindows event  :)
 void sendevent( int code, bool pressed, JoyButtonSlot::JoySlotInputAction device) {
 
-    display = X11Info::display();
-
-    if (device == JoyButtonSlot::JoyKeyboard)
-    {
-        XTestFakeKeyEvent(display, code, pressed, 0);
-    }
-    else if (device == JoyButtonSlot::JoyMouseButton)
-    {
-        XTestFakeButtonEvent(display, code, pressed, 0);
-    }
-
-    XFlush(display);
+    OutputSink::getInstance()->sendButtonEvent(code, pressed, device);
+    outputFlushHelperObj.requestSent();
 }
 
 void sendevent(int code1, int code2)
 {
-    display = X11Info::display();
-
-    XTestFakeRelativeMotionEvent(display, code1, code2, 0);
-    XFlush(display);
+    OutputSink::getInstance()->sendRelativeMotion(code1, code2);
+    outputFlushHelperObj.requestSent();
 }
 
 void sendSpringEvent(double xcoor, double ycoor, int springWidth, int springHeight)
 {
-    display = X11Info::display();
+    OutputSink *sink = OutputSink::getInstance();
 
     mouseHelperObj.mouseTimer.stop();
 
@@ -56,20 +46,11 @@ void sendSpringEvent(double xcoor, double ycoor, int springWidth, int springHeig
         int destSpringHeight = 0;
         int destMidWidth = 0;
         int destMidHeight = 0;
+        int pointerX = 0;
+        int pointerY = 0;
 
-        XEvent mouseEvent;
-        Window wid = DefaultRootWindow(display);
-        XWindowAttributes xwAttr;
-
-        XQueryPointer(display, wid,
-            &mouseEvent.xbutton.root, &mouseEvent.xbutton.window,
-            &mouseEvent.xbutton.x_root, &mouseEvent.xbutton.y_root,
-            &mouseEvent.xbutton.x, &mouseEvent.xbutton.y,
-            &mouseEvent.xbutton.state);
-
-        XGetWindowAttributes(display, wid, &xwAttr);
-        width = xwAttr.width;
-        height = xwAttr.height;
+        sink->getPointerPosition(pointerX, pointerY);
+        sink->getScreenSize(width, height);
         midwidth = width / 2;
         midheight = height / 2;
 
@@ -87,18 +68,19 @@ void sendSpringEvent(double xcoor, double ycoor, int springWidth, int springHeig
         destMidWidth = destSpringWidth / 2;
         destMidHeight = destSpringHeight / 2;
 
-        xmovecoor = (xcoor >= -1.0) ? (midwidth + (xcoor * destMidWidth)): mouseEvent.xbutton.x_root;
-        ymovecoor = (ycoor >= -1.0) ? (midheight + (ycoor * destMidHeight)) : mouseEvent.xbutton.y_root;
+        xmovecoor = (xcoor >= -1.0) ? (midwidth + (xcoor * destMidWidth)): pointerX;
+        ymovecoor = (ycoor >= -1.0) ? (midheight + (ycoor * destMidHeight)) : pointerY;
 
-        if (xmovecoor != mouseEvent.xbutton.x_root || ymovecoor != mouseEvent.xbutton.y_root)
+        if (xmovecoor != pointerX || ymovecoor != pointerY)
         {
-            double diffx = abs(mouseEvent.xbutton.x_root - xmovecoor);
-            double diffy = abs(mouseEvent.xbutton.y_root - ymovecoor);
+            double diffx = abs(pointerX - xmovecoor);
+            double diffy = abs(pointerY - ymovecoor);
             //double finaldiff = sqrt((diffx*diffx)+(diffy*diffy));
             if (!mouseHelperObj.springMouseMoving && (diffx >= destSpringWidth*.0066 || diffy >= destSpringHeight*.0066))
             {
                 mouseHelperObj.springMouseMoving = true;
-                XTestFakeMotionEvent(display, -1, xmovecoor, ymovecoor, 0);
+                sink->sendAbsoluteMotion(xmovecoor, ymovecoor);
+                outputFlushHelperObj.requestSent();
                 mouseHelperObj.mouseTimer.start(8);
             }
             else if (mouseHelperObj.springMouseMoving && (diffx < 2 && diffy < 2))
@@ -107,12 +89,13 @@ void sendSpringEvent(double xcoor, double ycoor, int springWidth, int springHeig
             }
             else if (mouseHelperObj.springMouseMoving)
             {
-                XTestFakeMotionEvent(display, -1, xmovecoor, ymovecoor, 0);
+                sink->sendAbsoluteMotion(xmovecoor, ymovecoor);
+                outputFlushHelperObj.requestSent();
                 mouseHelperObj.mouseTimer.start(8);
             }
 
-            mouseHelperObj.previousCursorLocation[0] = mouseEvent.xbutton.x_root;
-            mouseHelperObj.previousCursorLocation[1] = mouseEvent.xbutton.y_root;
+            mouseHelperObj.previousCursorLocation[0] = pointerX;
+            mouseHelperObj.previousCursorLocation[1] = pointerY;
         }
         else if (mouseHelperObj.previousCursorLocation[0] == xmovecoor &&
                  mouseHelperObj.previousCursorLocation[1] == ymovecoor)
@@ -121,8 +104,8 @@ void sendSpringEvent(double xcoor, double ycoor, int springWidth, int springHeig
         }
         else
         {
-            mouseHelperObj.previousCursorLocation[0] = mouseEvent.xbutton.x_root;
-            mouseHelperObj.previousCursorLocation[1] = mouseEvent.xbutton.y_root;
+            mouseHelperObj.previousCursorLocation[0] = pointerX;
+            mouseHelperObj.previousCursorLocation[1] = pointerY;
             mouseHelperObj.mouseTimer.start(8);
         }
     }
@@ -130,8 +113,22 @@ void sendSpringEvent(double xcoor, double ycoor, int springWidth, int springHeig
     {
         mouseHelperObj.springMouseMoving = false;
     }
+}
+
+void setOutputBatching(bool enabled)
+{
+    outputFlushHelperObj.setBatching(enabled);
+}
 
-    XFlush(display);
+// Send any request still waiting for a batched flush
+void flushOutput()
+{
+    outputFlushHelperObj.flush();
+}
+
+void writeOutputStatistics(QTextStream &out)
+{
+    outputFlushHelperObj.writeStatistics(out);
 }
 
 int keyToKeycode (QString key)
@@ -2,6 +2,7 @@
 #define EVENT_H
 
 #include <QString>
+#include <QTextStream>
 
 #include "joybuttonslot.h"
 #include "mousehelper.h"
@@ -11,6 +12,9 @@ enum JoyInputDevice {JoyKeyboard=0, JoyMouse};
 void sendevent (int code, bool pressed=true, JoyButtonSlot::JoySlotInputAction device=JoyButtonSlot::JoyKeyboard);
 void sendevent(int code1, int code2);
 void sendSpringEvent(double xcoor, double ycoor, int springWidth=0, int springHeight=0);
+void setOutputBatching(bool enabled);
+void flushOutput();
+void writeOutputStatistics(QTextStream &out);
 int keyToKeycode (QString key);
 QString keycodeToKey(int keycode);
 
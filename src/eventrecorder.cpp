@@ -0,0 +1,218 @@
+#include <string.h>
+
+#include "eventrecorder.h"
+#include "common.h"
+
+const quint32 EventRecorder::MAGIC = 0x414D4556;
+const quint32 EventRecorder::VERSION = 1;
+
+EventRecorder::EventRecorder()
+{
+    startTime = 0;
+}
+
+EventRecorder::~EventRecorder()
+{
+    close();
+}
+
+bool EventRecorder::open(QString path, QList<RecordedDevice> &devices)
+{
+    close();
+
+    file.setFileName(path);
+    bool result = file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    if (result)
+    {
+        stream.setDevice(&file);
+        stream.setVersion(QDataStream::Qt_4_6);
+        stream << MAGIC << VERSION << (quint32)devices.size();
+
+        QListIterator<RecordedDevice> iter(devices);
+        while (iter.hasNext())
+        {
+            const RecordedDevice &device = iter.next();
+            stream << device.name << (quint32)device.buttons << (quint32)device.axes << (quint32)device.hats;
+        }
+
+        deviceMap.clear();
+        for (int i=0; i < devices.size(); i++)
+        {
+            deviceMap.append(i);
+        }
+
+        startTime = PadderCommon::getMonotonicTime();
+    }
+
+    return result;
+}
+
+/* Append the controller events of a batch. Events that are not
+ * joystick events, such as SDL_QUIT, are not recorded. Neither are
+ * events of controllers that are not listed in the header.
+ */
+void EventRecorder::write(TimedSDLEvent *events, int count)
+{
+    if (file.isOpen())
+    {
+        for (int i=0; i < count; i++)
+        {
+            SDL_Event &event = events[i].event;
+            qint64 time = events[i].timestamp - startTime;
+            int device = -1;
+            quint8 index = 0;
+            qint16 value = 0;
+
+            switch (event.type)
+            {
+                case SDL_JOYBUTTONDOWN:
+                case SDL_JOYBUTTONUP:
+                {
+                    device = getRecordedDevice(event.button.which);
+                    index = event.button.button;
+                    break;
+                }
+                case SDL_JOYAXISMOTION:
+                {
+                    device = getRecordedDevice(event.jaxis.which);
+                    index = event.jaxis.axis;
+                    value = event.jaxis.value;
+                    break;
+                }
+                case SDL_JOYHATMOTION:
+                {
+                    device = getRecordedDevice(event.jhat.which);
+                    index = event.jhat.hat;
+                    value = event.jhat.value;
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            if (device >= 0)
+            {
+                stream << time << (quint8)event.type << (quint8)device << index << value;
+            }
+        }
+    }
+}
+
+/* Set the header position recorded for the events of each SDL
+ * joystick. map[i] is the device number written for joystick i or
+ * -1 when its events are not recorded. Used when controllers are
+ * added or removed while recording so SDL numbers that shift do
+ * not end up on the wrong device of the recording.
+ */
+void EventRecorder::setDeviceMap(QVector<int> &map)
+{
+    deviceMap = map;
+}
+
+int EventRecorder::getRecordedDevice(int which)
+{
+    int device = -1;
+    if (which >= 0 && which < deviceMap.size())
+    {
+        device = deviceMap.at(which);
+    }
+
+    return device;
+}
+
+void EventRecorder::close()
+{
+    if (file.isOpen())
+    {
+        stream.setDevice(0);
+        file.close();
+    }
+}
+
+bool EventRecorder::isOpen()
+{
+    return file.isOpen();
+}
+
+bool EventRecorder::readHeader(QDataStream &stream, QList<RecordedDevice> &devices)
+{
+    bool result = false;
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 deviceCount = 0;
+
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream >> magic >> version >> deviceCount;
+    if (stream.status() == QDataStream::Ok && magic == MAGIC && version == VERSION)
+    {
+        for (quint32 i=0; i < deviceCount && stream.status() == QDataStream::Ok; i++)
+        {
+            RecordedDevice device;
+            quint32 buttons = 0;
+            quint32 axes = 0;
+            quint32 hats = 0;
+            stream >> device.name >> buttons >> axes >> hats;
+            device.buttons = buttons;
+            device.axes = axes;
+            device.hats = hats;
+            devices.append(device);
+        }
+
+        result = stream.status() == QDataStream::Ok;
+    }
+
+    return result;
+}
+
+/* Read the next record and rebuild the SDL event it was made from.
+ * Returns false at the end of the file.
+ */
+bool EventRecorder::readEvent(QDataStream &stream, qint64 &time, SDL_Event &event)
+{
+    bool result = false;
+    quint8 type = 0;
+    quint8 which = 0;
+    quint8 index = 0;
+    qint16 value = 0;
+
+    stream >> time >> type >> which >> index >> value;
+    if (stream.status() == QDataStream::Ok)
+    {
+        memset(&event, 0, sizeof(event));
+        event.type = type;
+        result = true;
+
+        switch (type)
+        {
+            case SDL_JOYBUTTONDOWN:
+            case SDL_JOYBUTTONUP:
+            {
+                event.button.which = which;
+                event.button.button = index;
+                event.button.state = (type == SDL_JOYBUTTONDOWN) ? SDL_PRESSED : SDL_RELEASED;
+                break;
+            }
+            case SDL_JOYAXISMOTION:
+            {
+                event.jaxis.which = which;
+                event.jaxis.axis = index;
+                event.jaxis.value = value;
+                break;
+            }
+            case SDL_JOYHATMOTION:
+            {
+                event.jhat.which = which;
+                event.jhat.hat = index;
+                event.jhat.value = value;
+                break;
+            }
+            default:
+            {
+                result = false;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
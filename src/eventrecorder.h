@@ -0,0 +1,56 @@
+#ifndef EVENTRECORDER_H
+#define EVENTRECORDER_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QFile>
+#include <QDataStream>
+#include <SDL/SDL.h>
+
+#include "sdleventring.h"
+
+// Controller described in the header of a recording
+struct RecordedDevice
+{
+    QString name;
+    int buttons;
+    int axes;
+    int hats;
+};
+
+/* Writes the raw controller event stream read by InputDaemon to a
+ * binary file. The file starts with a header describing every
+ * controller followed by fixed size records holding the time since
+ * the recording started, the event type, the device and element
+ * number and the value. ReplayEventReader reads the same format.
+ */
+class EventRecorder
+{
+public:
+    explicit EventRecorder();
+    ~EventRecorder();
+
+    bool open(QString path, QList<RecordedDevice> &devices);
+    void write(TimedSDLEvent *events, int count);
+    void setDeviceMap(QVector<int> &map);
+    void close();
+    bool isOpen();
+
+    static bool readHeader(QDataStream &stream, QList<RecordedDevice> &devices);
+    static bool readEvent(QDataStream &stream, qint64 &time, SDL_Event &event);
+
+    static const quint32 MAGIC;
+    static const quint32 VERSION;
+
+protected:
+    int getRecordedDevice(int which);
+
+    QFile file;
+    QDataStream stream;
+    qint64 startTime;
+    // Device number in the header for each SDL joystick number
+    QVector<int> deviceMap;
+};
+
+#endif // EVENTRECORDER_H
@@ -2,18 +2,62 @@
 #include <QTimer>
 #include <QEventLoop>
 #include <QHashIterator>
+#include <QDir>
+#include <QListIterator>
+#include <QtAlgorithms>
 #include <SDL/SDL.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
 
 #include "inputdaemon.h"
+#include "evdeveventreader.h"
+#include "replayeventreader.h"
+#include "common.h"
+#include "event.h"
+#include "mousescheduler.h"
+#include "timerwheel.h"
 
-InputDaemon::InputDaemon(QHash<int, Joystick*> *joysticks, bool graphical, QObject *parent) :
+const QString InputDaemon::DEVICEDIRECTORY = "/dev/input";
+const int InputDaemon::HOTPLUGDELAY = 250;
+
+volatile sig_atomic_t InputDaemon::statisticsFd = -1;
+
+InputDaemon::InputDaemon(QHash<int, Joystick*> *joysticks, CommandLineUtility *cmdutility, bool graphical, QObject *parent) :
     QObject(parent)
 {
     this->joysticks = joysticks;
     this->stopped = false;
     this->graphical = graphical;
+    this->coalesceAxes = cmdutility->isAxisCoalescingEnabled();
+    this->coalescedAxisEvents = 0;
+    this->deviceWatcher = 0;
+    this->rescanActive = false;
+    this->replayWorker = 0;
+    this->recorder = 0;
+    this->statisticsNotifier = 0;
+
+    if (cmdutility->hasReplayFile())
+    {
+        replayWorker = new ReplayEventReader(joysticks, cmdutility->getReplayFile(), !cmdutility->isFastReplayEnabled());
+        if (!replayWorker->isValid())
+        {
+            QTextStream errorstream(stderr);
+            errorstream << tr("%1 is not a valid recording.").arg(cmdutility->getReplayFile()) << endl;
+        }
 
-    eventWorker = new SDLEventReader(joysticks);
+        eventWorker = replayWorker;
+    }
+    else if (cmdutility->getInputBackend() == CommandLineUtility::EvdevBackend)
+    {
+        eventWorker = new EvdevEventReader(joysticks);
+    }
+    else
+    {
+        eventWorker = new SDLEventReader(joysticks);
+    }
+
+    eventBatch.resize(eventWorker->getEventRing()->getCapacity());
+    supersededEvents.resize(eventBatch.size());
     thread = new QThread();
     eventWorker->moveToThread(thread);
 
@@ -21,13 +65,57 @@ InputDaemon::InputDaemon(QHash<int, Joystick*> *joysticks, bool graphical, QObje
     {
         connect(thread, SIGNAL(started()), eventWorker, SLOT(performWork()));
         connect(eventWorker, SIGNAL(eventRaised()), this, SLOT(run()));
+        if (replayWorker)
+        {
+            connect(replayWorker, SIGNAL(replayFinished()), this, SLOT(finishReplay()));
+        }
         thread->start();
     }
+
+    // Controllers from a recording are fixed so hotplug is not needed
+    if (graphical && !replayWorker)
+    {
+        // Give udev some time to set up permissions on new device
+        // nodes before the joysticks are scanned again
+        hotplugTimer.setSingleShot(true);
+        hotplugTimer.setInterval(HOTPLUGDELAY);
+        connect(&hotplugTimer, SIGNAL(timeout()), this, SLOT(checkDeviceNodes()));
+
+        deviceNodes = findDeviceNodes();
+        deviceWatcher = new QFileSystemWatcher(this);
+        deviceWatcher->addPath(DEVICEDIRECTORY);
+        connect(deviceWatcher, SIGNAL(directoryChanged(QString)), &hotplugTimer, SLOT(start()));
+    }
     refreshJoysticks();
+
+    if (graphical && cmdutility->hasRecordFile())
+    {
+        startRecording(cmdutility->getRecordFile());
+    }
+
+    if (graphical)
+    {
+        int tempFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (tempFd >= 0)
+        {
+            statisticsNotifier = new QSocketNotifier(tempFd, QSocketNotifier::Read, this);
+            connect(statisticsNotifier, SIGNAL(activated(int)), this, SLOT(handleStatisticsRequest()));
+            statisticsFd = tempFd;
+        }
+    }
 }
 
 InputDaemon::~InputDaemon()
 {
+    if (statisticsNotifier)
+    {
+        int tempFd = statisticsFd;
+        statisticsFd = -1;
+        delete statisticsNotifier;
+        statisticsNotifier = 0;
+        close(tempFd);
+    }
+
     if (eventWorker)
     {
         quit();
@@ -40,95 +128,245 @@ InputDaemon::~InputDaemon()
         delete thread;
         thread = 0;
     }
+
+    if (recorder)
+    {
+        delete recorder;
+        recorder = 0;
+    }
+
+    QHashIterator<int, LatencyHistogram*> iter(latencyHistograms);
+    while (iter.hasNext())
+    {
+        delete iter.next().value();
+    }
+    latencyHistograms.clear();
 }
 
+/* Drain every event queued by the reader thread and dispatch
+ * the whole batch in a single pass.
+ */
 void InputDaemon::run ()
 {
-    if (joysticks->count() > 0 && !stopped)
+    SDLEventRing *eventRing = eventWorker->getEventRing();
+    eventRing->clearPending();
+
+    int count = eventRing->drain(eventBatch.data(), eventBatch.size());
+    if (recorder)
     {
-        SDL_Event event;
-        event = eventWorker->getCurrentEvent();
+        recorder->write(eventBatch.data(), count);
+    }
+
+    if (coalesceAxes)
+    {
+        count = coalesceAxisEvents(count);
+    }
 
-        do
+    for (int i=0; i < count; i++)
+    {
+        SDL_Event &event = eventBatch[i].event;
+        if (event.type == SDL_QUIT)
+        {
+            stopped = true;
+        }
+        else if (joysticks->count() > 0 && !stopped)
+        {
+            dispatchEvent(event, eventBatch[i].timestamp);
+        }
+    }
+
+    // Requests sent while dispatching the batch go out in one flush
+    flushOutput();
+
+    if (stopped)
+    {
+        if (joysticks->count() > 0)
+        {
+            emit complete(joysticks->value(0));
+        }
+        emit complete();
+        stopped = false;
+    }
+}
+
+/* Drop axis events that are superseded by a newer event for the same
+ * axis later in the batch. Only runs of axis events are coalesced. A
+ * button or hat event of the same controller ends the run since it
+ * could change the set the axis values are applied to. The newest
+ * value of a run keeps its position so events stay in their original
+ * order. Returns the number of events left in the batch.
+ */
+int InputDaemon::coalesceAxisEvents(int count)
+{
+    latestAxisEvents.clear();
+    for (int i=0; i < count; i++)
+    {
+        SDL_Event &event = eventBatch[i].event;
+        supersededEvents[i] = false;
+
+        if (event.type == SDL_JOYAXISMOTION)
         {
-            switch (event.type)
+            int key = (event.jaxis.which << 8) | event.jaxis.axis;
+            if (latestAxisEvents.contains(key))
             {
-                case SDL_JOYBUTTONDOWN:
-                {
-                    Joystick *joy = joysticks->value(event.button.which);
-                    SetJoystick* set = joy->getActiveSetJoystick();
-                    JoyButton *button = set->getJoyButton(event.button.button);
-
-                    if (button)
-                    {
-                        button->joyEvent(true);
-                    }
-                    break;
-                }
+                supersededEvents[latestAxisEvents.value(key)] = true;
+            }
 
-                case SDL_JOYBUTTONUP:
-                {
-                    Joystick *joy = joysticks->value(event.button.which);
-                    SetJoystick* set = joy->getActiveSetJoystick();
-                    JoyButton *button = set->getJoyButton(event.button.button);
-
-                    if (button)
-                    {
-                        button->joyEvent(false);
-                    }
-                    break;
-                }
+            latestAxisEvents.insert(key, i);
+        }
+        else
+        {
+            int which = -1;
+            if (event.type == SDL_JOYBUTTONDOWN || event.type == SDL_JOYBUTTONUP)
+            {
+                which = event.button.which;
+            }
+            else if (event.type == SDL_JOYHATMOTION)
+            {
+                which = event.jhat.which;
+            }
 
-                case SDL_JOYAXISMOTION:
+            // End the runs of the controller, or of every controller
+            // for events that do not belong to one
+            QMutableHashIterator<int, int> iter(latestAxisEvents);
+            while (iter.hasNext())
+            {
+                iter.next();
+                if (which < 0 || (iter.key() >> 8) == which)
                 {
-                    Joystick *joy = joysticks->value(event.jaxis.which);
-                    SetJoystick* set = joy->getActiveSetJoystick();
-                    JoyAxis *axis = set->getJoyAxis(event.jaxis.axis);
-                    if (axis)
-                    {
-                        axis->joyEvent(event.jaxis.value);
-                    }
-                    break;
+                    iter.remove();
                 }
+            }
+        }
+    }
 
-                case SDL_JOYHATMOTION:
+    int kept = 0;
+    for (int i=0; i < count; i++)
+    {
+        if (supersededEvents.at(i))
+        {
+            coalescedAxisEvents++;
+        }
+        else
+        {
+            if (kept != i)
+            {
+                eventBatch[kept] = eventBatch[i];
+            }
+            kept++;
+        }
+    }
+
+    return kept;
+}
+
+Joystick* InputDaemon::getDispatchJoystick(int which)
+{
+    Joystick *joystick = 0;
+    if (which >= 0 && which < dispatchJoysticks.size())
+    {
+        joystick = dispatchJoysticks.at(which);
+    }
+
+    return joystick;
+}
+
+void InputDaemon::dispatchEvent(SDL_Event &event, qint64 timestamp)
+{
+    int which = -1;
+    LatencyElement element = ButtonLatency;
+    switch (event.type)
+    {
+        case SDL_JOYBUTTONDOWN:
+        case SDL_JOYBUTTONUP:
+            which = event.button.which;
+            break;
+
+        case SDL_JOYAXISMOTION:
+            which = event.jaxis.which;
+            element = AxisLatency;
+            break;
+
+        case SDL_JOYHATMOTION:
+            which = event.jhat.which;
+            element = HatLatency;
+            break;
+
+        default:
+            break;
+    }
+
+    if (which >= 0 && timestamp > 0)
+    {
+        LatencyHistogram *dispatchLatency = getLatencyHistogram(which, element, DispatchStage);
+        dispatchLatency->record(PadderCommon::getMonotonicTime() - timestamp);
+        JoyButton::setInputContext(timestamp, getLatencyHistogram(which, element, OutputStage));
+    }
+
+    switch (event.type)
+    {
+        case SDL_JOYBUTTONDOWN:
+        case SDL_JOYBUTTONUP:
+        {
+            Joystick *joy = getDispatchJoystick(event.button.which);
+            if (joy)
+            {
+                JoyButton *button = joy->getActiveJoyButton(event.button.button);
+                if (button)
                 {
-                    Joystick *joy = joysticks->value(event.jhat.which);
-                    SetJoystick* set = joy->getActiveSetJoystick();
-                    JoyDPad *dpad = set->getJoyDPad(event.jhat.hat);
-                    if (dpad)
-                    {
-                        dpad->joyEvent(event.jhat.value);
-                    }
-                    break;
+                    button->joyEvent(event.type == SDL_JOYBUTTONDOWN);
                 }
+            }
+            break;
+        }
 
-                case SDL_QUIT:
+        case SDL_JOYAXISMOTION:
+        {
+            Joystick *joy = getDispatchJoystick(event.jaxis.which);
+            if (joy)
+            {
+                joy->setDeviceAxisValue(event.jaxis.axis, event.jaxis.value);
+                JoyAxis *axis = joy->getActiveJoyAxis(event.jaxis.axis);
+                if (axis)
                 {
-                    stopped = true;
-                    break;
+                    axis->joyEvent(event.jaxis.value);
                 }
-
-                default:
-                    break;
             }
+            break;
         }
-        while (SDL_PollEvent(&event) > 0);
-    }
 
-    if (stopped)
-    {
-        if (joysticks->count() > 0)
+        case SDL_JOYHATMOTION:
         {
-            emit complete(joysticks->value(0));
+            Joystick *joy = getDispatchJoystick(event.jhat.which);
+            if (joy)
+            {
+                JoyDPad *dpad = joy->getActiveJoyDPad(event.jhat.hat);
+                if (dpad)
+                {
+                    dpad->joyEvent(event.jhat.value);
+                }
+            }
+            break;
         }
-        emit complete();
-        stopped = false;
+
+        default:
+            break;
     }
-    else
+
+    JoyButton::setInputContext(0, 0);
+}
+
+LatencyHistogram* InputDaemon::getLatencyHistogram(int which, LatencyElement element, LatencyStage stage)
+{
+    int key = (which << 3) | (element << 1) | stage;
+    LatencyHistogram *histogram = latencyHistograms.value(key);
+    if (!histogram)
     {
-        QTimer::singleShot(0, eventWorker, SLOT(performWork()));
+        histogram = new LatencyHistogram();
+        latencyHistograms.insert(key, histogram);
     }
+
+    return histogram;
 }
 
 void InputDaemon::refreshJoysticks()
@@ -139,19 +377,50 @@ void InputDaemon::refreshJoysticks()
         Joystick *joystick = iter.next().value();
         if (joystick)
         {
+            if (recordedJoysticks.contains(joystick))
+            {
+                recordedJoysticks.replace(recordedJoysticks.indexOf(joystick), 0);
+            }
+
             delete joystick;
             joystick = 0;
         }
     }
 
     joysticks->clear();
+    dispatchJoysticks.clear();
 
-    for (int i=0; i < SDL_NumJoysticks(); i++)
+    if (replayWorker)
+    {
+        // Recreate the controllers described in the recording
+        QList<RecordedDevice> devices = replayWorker->getDevices();
+        for (int i=0; i < devices.size(); i++)
+        {
+            const RecordedDevice &device = devices.at(i);
+            Joystick *curJoystick = new Joystick(device.name, i, device.buttons, device.axes, device.hats, this);
+
+            joysticks->insert(i, curJoystick);
+            dispatchJoysticks.append(curJoystick);
+        }
+    }
+    else
     {
-        SDL_Joystick* joystick = SDL_JoystickOpen (i);
-        Joystick *curJoystick = new Joystick (joystick, this);
+        QStringList identities = EvdevEventReader::findDeviceIdentities();
+        for (int i=0; i < SDL_NumJoysticks(); i++)
+        {
+            SDL_Joystick* joystick = SDL_JoystickOpen (i);
+            Joystick *curJoystick = new Joystick (joystick, this);
+            curJoystick->setDeviceIdentity(identities.value(i));
+
+            joysticks->insert(i, curJoystick);
+            dispatchJoysticks.append(curJoystick);
+        }
 
-        joysticks->insert(i, curJoystick);
+        if (recorder)
+        {
+            QList<Joystick*> candidates = dispatchJoysticks.toList();
+            updateRecordedJoysticks(candidates);
+        }
     }
 
     emit joysticksRefreshed(joysticks);
@@ -182,6 +451,267 @@ void InputDaemon::refresh()
     QTimer::singleShot(0, eventWorker, SLOT(performWork()));
 }
 
+QStringList InputDaemon::findDeviceNodes()
+{
+    QDir deviceDir(DEVICEDIRECTORY);
+    QStringList filters;
+    filters << "js*" << "event*";
+    return deviceDir.entryList(filters, QDir::System, QDir::Name);
+}
+
+/* Only rescan joysticks when a joystick or event device node was
+ * actually added or removed.
+ */
+void InputDaemon::checkDeviceNodes()
+{
+    QStringList currentNodes = findDeviceNodes();
+    if (rescanActive)
+    {
+        // Check again once the current rescan is done
+        hotplugTimer.start();
+    }
+    else if (currentNodes != deviceNodes)
+    {
+        deviceNodes = currentNodes;
+        rescanJoysticks();
+    }
+}
+
+bool InputDaemon::isSameController(Joystick *joystick, SDL_Joystick *joyhandle)
+{
+    SetJoystick *set = joystick->getSetJoystick(0);
+    return joystick->getSDLName() == QString(SDL_JoystickName(SDL_JoystickIndex(joyhandle))) &&
+           set->getNumberButtons() == SDL_JoystickNumButtons(joyhandle) &&
+           set->getNumberAxes() == SDL_JoystickNumAxes(joyhandle) &&
+           set->getNumberHats() == SDL_JoystickNumHats(joyhandle);
+}
+
+/* Find the Joystick that a controller had before a rescan. When the
+ * device identity of both is known it has to match. Otherwise the
+ * Joystick is only kept if neither side has another controller that
+ * looks the same since identical controllers cannot be told apart.
+ */
+Joystick* InputDaemon::findPreviousController(SDL_Joystick *joyhandle, QString identity, QList<SDL_Joystick*> &joyhandles)
+{
+    Joystick *result = 0;
+    Joystick *lastMatch = 0;
+    int oldMatches = 0;
+
+    for (int i=0; i < dispatchJoysticks.size() && !result; i++)
+    {
+        Joystick *joystick = dispatchJoysticks.at(i);
+        if (isSameController(joystick, joyhandle))
+        {
+            if (!identity.isEmpty() && joystick->getDeviceIdentity() == identity)
+            {
+                result = joystick;
+            }
+
+            lastMatch = joystick;
+            oldMatches++;
+        }
+    }
+
+    if (!result && oldMatches == 1 &&
+        (identity.isEmpty() || lastMatch->getDeviceIdentity().isEmpty()))
+    {
+        int newMatches = 0;
+        for (int i=0; i < joyhandles.size(); i++)
+        {
+            if (isSameController(lastMatch, joyhandles.at(i)))
+            {
+                newMatches++;
+            }
+        }
+
+        if (newMatches == 1)
+        {
+            result = lastMatch;
+        }
+    }
+
+    return result;
+}
+
+/* Enumerate controllers again after one was connected or removed.
+ * Unlike refresh(), only the SDL joystick subsystem is restarted
+ * and Joystick objects of controllers that are still present are
+ * kept along with their sets and loaded profile. Controllers are
+ * matched through findPreviousController().
+ */
+void InputDaemon::rescanJoysticks()
+{
+    rescanActive = true;
+
+    // The reader has to be idle while SDL enumerates joysticks.
+    // Anything it queued is dispatched before finished arrives
+    eventWorker->stop();
+
+    QEventLoop q;
+    connect(eventWorker, SIGNAL(finished()), &q, SLOT(quit()));
+    q.exec();
+
+    eventWorker->resetJoysticks();
+
+    QList<SDL_Joystick*> joyhandles;
+    for (int i=0; i < SDL_NumJoysticks(); i++)
+    {
+        joyhandles.append(SDL_JoystickOpen(i));
+    }
+
+    QStringList identities = EvdevEventReader::findDeviceIdentities();
+    QVector<Joystick*> currentJoysticks;
+    QList<Joystick*> addedJoysticks;
+
+    for (int i=0; i < joyhandles.size(); i++)
+    {
+        SDL_Joystick *joyhandle = joyhandles.at(i);
+        QString identity = identities.value(i);
+        Joystick *joystick = findPreviousController(joyhandle, identity, joyhandles);
+        if (joystick && !currentJoysticks.contains(joystick))
+        {
+            joystick->setSDLHandle(joyhandle);
+        }
+        else
+        {
+            joystick = new Joystick(joyhandle, this);
+            addedJoysticks.append(joystick);
+        }
+
+        joystick->setDeviceIdentity(identity);
+        currentJoysticks.append(joystick);
+    }
+
+    for (int i=0; i < dispatchJoysticks.size(); i++)
+    {
+        Joystick *joystick = dispatchJoysticks.at(i);
+        if (!currentJoysticks.contains(joystick))
+        {
+            emit joystickRemoved(joystick);
+
+            // Make sure nothing stays held down for a removed controller
+            joystick->getActiveSetJoystick()->release();
+            if (recordedJoysticks.contains(joystick))
+            {
+                recordedJoysticks.replace(recordedJoysticks.indexOf(joystick), 0);
+            }
+
+            delete joystick;
+            joystick = 0;
+        }
+    }
+
+    joysticks->clear();
+    dispatchJoysticks = currentJoysticks;
+    for (int i=0; i < dispatchJoysticks.size(); i++)
+    {
+        joysticks->insert(i, dispatchJoysticks.at(i));
+    }
+
+    if (recorder)
+    {
+        updateRecordedJoysticks(addedJoysticks);
+    }
+
+    QListIterator<Joystick*> iter(addedJoysticks);
+    while (iter.hasNext())
+    {
+        emit joystickAdded(iter.next());
+    }
+
+    QTimer::singleShot(0, eventWorker, SLOT(performWork()));
+    rescanActive = false;
+}
+
+/* Write the raw event stream to a file that can be replayed later
+ * with ReplayEventReader. Controllers present now are described in
+ * the header of the file.
+ */
+void InputDaemon::startRecording(QString path)
+{
+    recordedDevices.clear();
+    recordedJoysticks = dispatchJoysticks;
+    for (int i=0; i < dispatchJoysticks.size(); i++)
+    {
+        Joystick *joystick = dispatchJoysticks.at(i);
+        SetJoystick *set = joystick->getSetJoystick(0);
+
+        RecordedDevice device;
+        device.name = joystick->getSDLName();
+        device.buttons = set->getNumberButtons();
+        device.axes = set->getNumberAxes();
+        device.hats = set->getNumberHats();
+        recordedDevices.append(device);
+    }
+
+    recorder = new EventRecorder();
+    if (!recorder->open(path, recordedDevices))
+    {
+        QTextStream errorstream(stderr);
+        errorstream << tr("Could not open %1 for recording.").arg(path) << endl;
+
+        delete recorder;
+        recorder = 0;
+        recordedDevices.clear();
+        recordedJoysticks.clear();
+    }
+}
+
+bool InputDaemon::isRecordedController(Joystick *joystick, const RecordedDevice &device)
+{
+    SetJoystick *set = joystick->getSetJoystick(0);
+    return joystick->getSDLName() == device.name &&
+           set->getNumberButtons() == device.buttons &&
+           set->getNumberAxes() == device.axes &&
+           set->getNumberHats() == device.hats;
+}
+
+/* Keep the device numbers of a recording stable after controllers
+ * were added or removed. A connected controller takes the place of
+ * a recorded controller that went away if they look the same.
+ * Events of any other new controller are left out of the recording
+ * since the header cannot describe it.
+ */
+void InputDaemon::updateRecordedJoysticks(QList<Joystick*> &candidates)
+{
+    QTextStream errorstream(stderr);
+    QListIterator<Joystick*> iter(candidates);
+    while (iter.hasNext())
+    {
+        Joystick *joystick = iter.next();
+        bool recorded = false;
+        for (int i=0; i < recordedJoysticks.size() && !recorded; i++)
+        {
+            if (!recordedJoysticks.at(i) && isRecordedController(joystick, recordedDevices.at(i)))
+            {
+                recordedJoysticks.replace(i, joystick);
+                recorded = true;
+            }
+        }
+
+        if (!recorded)
+        {
+            errorstream << tr("Events of %1 are not recorded. It was not connected when the recording started.")
+                           .arg(joystick->getSDLName()) << endl;
+        }
+    }
+
+    QVector<int> deviceMap;
+    for (int i=0; i < dispatchJoysticks.size(); i++)
+    {
+        Joystick *joystick = dispatchJoysticks.at(i);
+        deviceMap.append(recordedJoysticks.indexOf(joystick));
+    }
+
+    recorder->setDeviceMap(deviceMap);
+}
+
+void InputDaemon::finishReplay()
+{
+    printStatistics();
+    emit replayFinished();
+}
+
 void InputDaemon::refreshJoystick(Joystick *joystick)
 {
     joystick->reset();
@@ -206,3 +736,161 @@ void InputDaemon::quit()
     delete eventWorker;
     eventWorker = 0;
 }
+
+void InputDaemon::writeStatistics(QTextStream &out)
+{
+    SDLEventRing *eventRing = eventWorker ? eventWorker->getEventRing() : 0;
+    if (eventRing)
+    {
+        out << tr("Event batches:") << " " << eventRing->getBatchCount() << endl;
+        out << tr("Events dispatched:") << " " << eventRing->getEventCount() << endl;
+        out << tr("Average batch size:") << " " << eventRing->getAverageBatchSize() << endl;
+        out << tr("Largest batch size:") << " " << eventRing->getLargestBatchSize() << endl;
+        out << tr("Event queue overflows:") << " " << eventRing->getOverflowCount() << endl;
+    }
+
+    if (coalesceAxes)
+    {
+        out << tr("Axis events coalesced:") << " " << coalescedAxisEvents << endl;
+    }
+
+    writeLatencyStatistics(out);
+    writeFilterStatistics(out);
+    writeStickStatistics(out);
+    writeOutputStatistics(out);
+    MouseScheduler::getInstance()->writeStatistics(out);
+    TimerWheel::getInstance()->writeStatistics(out);
+}
+
+/* Print percentiles of the time from the controller event to
+ * InputDaemon dispatching it and to the first output event it
+ * caused, per controller and element type.
+ */
+void InputDaemon::writeLatencyStatistics(QTextStream &out)
+{
+    QList<int> keys = latencyHistograms.keys();
+    qSort(keys);
+
+    if (!keys.isEmpty())
+    {
+        out << tr("Latency in microseconds (count, p50, p99, p99.9, max):") << endl;
+    }
+
+    QListIterator<int> iter(keys);
+    while (iter.hasNext())
+    {
+        int key = iter.next();
+        LatencyHistogram *histogram = latencyHistograms.value(key);
+        int which = key >> 3;
+        LatencyElement element = (LatencyElement)((key >> 1) & 0x3);
+        LatencyStage stage = (LatencyStage)(key & 0x1);
+
+        QString elementName;
+        if (element == ButtonLatency)
+        {
+            elementName = tr("button");
+        }
+        else if (element == AxisLatency)
+        {
+            elementName = tr("axis");
+        }
+        else
+        {
+            elementName = tr("hat");
+        }
+
+        QString stageName = (stage == DispatchStage) ? tr("dispatch") : tr("output");
+
+        out << "  " << tr("Joystick %1 %2 to %3:").arg(which + 1).arg(elementName).arg(stageName) << " "
+            << histogram->getCount() << " "
+            << histogram->getPercentile(0.5) << " "
+            << histogram->getPercentile(0.99) << " "
+            << histogram->getPercentile(0.999) << " "
+            << histogram->getMaximum() << endl;
+    }
+}
+
+// Print dead zone transitions removed by axis filters in every set
+void InputDaemon::writeFilterStatistics(QTextStream &out)
+{
+    QList<int> keys = joysticks->keys();
+    qSort(keys);
+
+    QListIterator<int> iter(keys);
+    while (iter.hasNext())
+    {
+        Joystick *joystick = joysticks->value(iter.next());
+        for (int i=0; i < Joystick::NUMBER_JOYSETS; i++)
+        {
+            SetJoystick *setjoystick = joystick->getSetJoystick(i);
+            for (int j=0; j < setjoystick->getNumberAxes(); j++)
+            {
+                JoyAxis *axis = setjoystick->getJoyAxis(j);
+                if (axis && axis->getFilterMode() != AxisFilter::NoFilter)
+                {
+                    out << tr("Joystick %1 set %2 axis %3 transitions suppressed:").arg(joystick->getRealJoyNumber())
+                           .arg(i + 1).arg(axis->getRealJoyIndex())
+                        << " " << axis->getSuppressedTransitions() << " "
+                        << tr("of") << " " << (axis->getSuppressedTransitions() + axis->getFilteredTransitions()) << endl;
+                }
+            }
+        }
+    }
+}
+
+// Print state changes that stick hysteresis kept from happening
+void InputDaemon::writeStickStatistics(QTextStream &out)
+{
+    QList<int> keys = joysticks->keys();
+    qSort(keys);
+
+    QListIterator<int> iter(keys);
+    while (iter.hasNext())
+    {
+        Joystick *joystick = joysticks->value(iter.next());
+        for (int i=0; i < Joystick::NUMBER_JOYSETS; i++)
+        {
+            SetJoystick *setjoystick = joystick->getSetJoystick(i);
+            for (int j=0; j < setjoystick->getNumberSticks(); j++)
+            {
+                JoyControlStick *stick = setjoystick->getJoyStick(j);
+                if (stick && (stick->getDeadZoneHysteresis() > 0 || stick->getDirectionHysteresis() > 0))
+                {
+                    out << tr("Joystick %1 set %2 stick %3 transitions avoided (dead zone, direction):").arg(joystick->getRealJoyNumber())
+                           .arg(i + 1).arg(stick->getRealJoyIndex())
+                        << " " << stick->getAvoidedDeadZoneChanges()
+                        << " " << stick->getAvoidedDirectionChanges() << endl;
+                }
+            }
+        }
+    }
+}
+
+void InputDaemon::printStatistics()
+{
+    QTextStream out(stdout);
+    writeStatistics(out);
+}
+
+/* Ask the running daemon to print its statistics. Only write() is
+ * used so this is safe to call from a signal handler.
+ */
+void InputDaemon::requestStatistics()
+{
+    int tempFd = statisticsFd;
+    if (tempFd >= 0)
+    {
+        quint64 requestCount = 1;
+        ssize_t bytesWritten = write(tempFd, &requestCount, sizeof(requestCount));
+        Q_UNUSED(bytesWritten);
+    }
+}
+
+void InputDaemon::handleStatisticsRequest()
+{
+    quint64 requestCount = 0;
+    if (read(statisticsFd, &requestCount, sizeof(requestCount)) > 0)
+    {
+        printStatistics();
+    }
+}
@@ -3,30 +3,99 @@
 
 #include <QHash>
 #include <QThread>
+#include <QVector>
+#include <QTextStream>
+#include <QTimer>
+#include <QStringList>
+#include <QFileSystemWatcher>
+#include <QSocketNotifier>
+#include <signal.h>
 
 #include "joystick.h"
 #include "sdleventreader.h"
+#include "commandlineutility.h"
+#include "latencyhistogram.h"
+#include "eventrecorder.h"
+
+class ReplayEventReader;
 
 class InputDaemon : public QObject
 {
     Q_OBJECT
 public:
-    InputDaemon (QHash<int, Joystick*> *joysticks, bool graphical=true, QObject *parent=0);
+    InputDaemon (QHash<int, Joystick*> *joysticks, CommandLineUtility *cmdutility, bool graphical=true, QObject *parent=0);
     ~InputDaemon();
 
+    enum LatencyElement {ButtonLatency=0, AxisLatency, HatLatency};
+    enum LatencyStage {DispatchStage=0, OutputStage};
+
+    void writeStatistics(QTextStream &out);
+
+    static void requestStatistics();
+
+    static const QString DEVICEDIRECTORY;
+    static const int HOTPLUGDELAY;
+
 protected:
+    void dispatchEvent(SDL_Event &event, qint64 timestamp=0);
+    Joystick* getDispatchJoystick(int which);
+    bool isSameController(Joystick *joystick, SDL_Joystick *joyhandle);
+    Joystick* findPreviousController(SDL_Joystick *joyhandle, QString identity, QList<SDL_Joystick*> &joyhandles);
+    QStringList findDeviceNodes();
+    LatencyHistogram* getLatencyHistogram(int which, LatencyElement element, LatencyStage stage);
+    void writeLatencyStatistics(QTextStream &out);
+    void writeFilterStatistics(QTextStream &out);
+    void writeStickStatistics(QTextStream &out);
+    void startRecording(QString path);
+    void updateRecordedJoysticks(QList<Joystick*> &candidates);
+    bool isRecordedController(Joystick *joystick, const RecordedDevice &device);
+    int coalesceAxisEvents(int count);
+
     QHash<int, Joystick*> *joysticks;
+    // Same controllers as joysticks indexed by SDL number
+    QVector<Joystick*> dispatchJoysticks;
     bool stopped;
     bool graphical;
 
     SDLEventReader *eventWorker;
+    // Set when events are read from a recording instead of controllers
+    ReplayEventReader *replayWorker;
+    EventRecorder *recorder;
+    // Controllers listed in the header of the recording. Entries
+    // are reset to 0 when the controller goes away
+    QList<RecordedDevice> recordedDevices;
+    QVector<Joystick*> recordedJoysticks;
     QThread *thread;
+    QVector<TimedSDLEvent> eventBatch;
+    bool coalesceAxes;
+    // Position of the newest event in the current run of axis events
+    // for each device axis
+    QHash<int, int> latestAxisEvents;
+    // Axis events of the batch that a newer value replaces
+    QVector<bool> supersededEvents;
+    int coalescedAxisEvents;
+
+    QFileSystemWatcher *deviceWatcher;
+    QTimer hotplugTimer;
+    QStringList deviceNodes;
+    bool rescanActive;
+
+    // Keyed by device, element type and stage
+    QHash<int, LatencyHistogram*> latencyHistograms;
+
+    // Written to by requestStatistics. The statistics are printed
+    // from the event loop once the notifier fires
+    static volatile sig_atomic_t statisticsFd;
+    QSocketNotifier *statisticsNotifier;
 
 signals:
     void joystickRefreshed (Joystick *joystick);
     void joysticksRefreshed(QHash<int, Joystick*> *joysticks);
     void complete(Joystick* joystick);
     void complete();
+    void joystickAdded(Joystick *joystick);
+    void joystickRemoved(Joystick *joystick);
+    void replayFinished();
 
 public slots:
     void run();
@@ -34,9 +103,14 @@ public slots:
     void refresh();
     void refreshJoystick(Joystick *joystick);
     void refreshJoysticks();
+    void printStatistics();
+    void rescanJoysticks();
 
 private slots:
     void stop();
+    void checkDeviceNodes();
+    void finishReplay();
+    void handleStatisticsRequest();
 };
 
 #endif // INPUTDAEMONTHREAD_H
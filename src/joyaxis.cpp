@@ -4,11 +4,14 @@
 #include "joyaxis.h"
 #include "joycontrolstick.h"
 #include "event.h"
+#include "common.h"
 
 const int JoyAxis::AXISMIN = -32767;
 const int JoyAxis::AXISMAX = 32767;
 const int JoyAxis::AXISDEADZONE = 6000;
 const int JoyAxis::AXISMAXZONE = 32000;
+// Time in milliseconds
+const int JoyAxis::FILTERSETTLEINTERVAL = 5;
 
 // Speed in pixels/second
 const float JoyAxis::JOYSPEED = 20.0;
@@ -21,6 +24,9 @@ JoyAxis::JoyAxis(QObject *parent) :
     stick = 0;
     naxisbutton = new JoyAxisButton(this, 0, originset);
     paxisbutton = new JoyAxisButton(this, 1, originset);
+    filterTimer.setInterval(FILTERSETTLEINTERVAL);
+    connect(&filterTimer, SIGNAL(timeout()), this, SLOT(settleFilter()));
+    resetCalibration();
 
     reset();
     index = 0;
@@ -33,6 +39,9 @@ JoyAxis::JoyAxis(int index, int originset, QObject *parent) :
     this->originset = originset;
     naxisbutton = new JoyAxisButton(this, 0, originset);
     paxisbutton = new JoyAxisButton(this, 1, originset);
+    filterTimer.setInterval(FILTERSETTLEINTERVAL);
+    connect(&filterTimer, SIGNAL(timeout()), this, SLOT(settleFilter()));
+    resetCalibration();
 
     reset();
     this->index = index;
@@ -45,6 +54,37 @@ JoyAxis::~JoyAxis()
 }
 
 void JoyAxis::joyEvent(int value, bool ignoresets)
+{
+    uncalibratedValue = value;
+    if (calibrated)
+    {
+        value = calibrateValue(value);
+    }
+
+    if (filter.getMode() != AxisFilter::NoFilter)
+    {
+        value = filterValue(value, ignoresets);
+    }
+
+    processValue(value, ignoresets);
+}
+
+/* Return the axis to its dead value. The value is not a reading of
+ * the device so it skips the calibration and the filter, which could
+ * otherwise move it away from the dead value or delay the release.
+ */
+void JoyAxis::release(bool ignoresets)
+{
+    filterTimer.stop();
+    filter.reset();
+    unfilteredSafeZone = false;
+    filteredSafeZone = false;
+
+    processValue(currentThrottledDeadValue, ignoresets);
+}
+
+// Act on a value that has already been calibrated and filtered
+void JoyAxis::processValue(int value, bool ignoresets)
 {
     setCurrentRawValue(value);
     //currentRawValue = value;
@@ -279,6 +319,30 @@ void JoyAxis::readConfig(QXmlStreamReader *xml)
                 //currentRawValue = currentThrottledDeadValue;
                 currentThrottledValue = calculateThrottledValue(currentRawValue);
             }
+            else if (xml->name() == "filter" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                if (temptext == "ema")
+                {
+                    this->setFilterMode(AxisFilter::EMAFilter);
+                }
+                else if (temptext == "one-euro")
+                {
+                    this->setFilterMode(AxisFilter::OneEuroFilter);
+                }
+            }
+            else if (xml->name() == "filterCutoff" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                double tempchoice = temptext.toDouble();
+                this->setFilterCutoff(tempchoice);
+            }
+            else if (xml->name() == "filterBeta" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                double tempchoice = temptext.toDouble();
+                this->setFilterBeta(tempchoice);
+            }
             else if (xml->name() == JoyAxisButton::xmlName && xml->isStartElement())
             {
                 int index = xml->attributes().value("index").toString().toInt();
@@ -326,6 +390,18 @@ void JoyAxis::writeConfig(QXmlStreamWriter *xml)
         }
         xml->writeEndElement();
 
+        if (filter.getMode() == AxisFilter::EMAFilter)
+        {
+            xml->writeTextElement("filter", "ema");
+            xml->writeTextElement("filterCutoff", QString::number(filter.getCutoff()));
+        }
+        else if (filter.getMode() == AxisFilter::OneEuroFilter)
+        {
+            xml->writeTextElement("filter", "one-euro");
+            xml->writeTextElement("filterCutoff", QString::number(filter.getCutoff()));
+            xml->writeTextElement("filterBeta", QString::number(filter.getBeta()));
+        }
+
         naxisbutton->writeConfig(xml);
         paxisbutton->writeConfig(xml);
 
@@ -353,6 +429,17 @@ void JoyAxis::reset()
     setCurrentRawValue(currentThrottledDeadValue);
     //currentRawValue = currentThrottledDeadValue;
     currentThrottledValue = calculateThrottledValue(currentRawValue);
+
+    filterTimer.stop();
+    filter.setMode(AxisFilter::NoFilter);
+    filter.setCutoff(AxisFilter::DEFAULTCUTOFF);
+    filter.setBeta(AxisFilter::DEFAULTBETA);
+    uncalibratedValue = currentRawValue;
+    unfilteredIgnoreSets = false;
+    unfilteredSafeZone = false;
+    filteredSafeZone = false;
+    unfilteredTransitions = 0;
+    filteredTransitions = 0;
 }
 
 void JoyAxis::reset(int index)
@@ -564,6 +651,7 @@ bool JoyAxis::isDefault()
     value = value && (deadZone == AXISDEADZONE);
     value = value && (maxZoneValue == AXISMAXZONE);
     value = value && (throttle == 0);
+    value = value && (filter.getMode() == AxisFilter::NoFilter);
     value = value && (paxisbutton->isDefault());
     value = value && (naxisbutton->isDefault());
     return value;
@@ -699,3 +787,245 @@ double JoyAxis::getButtonsPresetSensitivity()
 
     return presetSensitivity;
 }
+
+void JoyAxis::setButtonsVelocityAcceleration(bool enabled)
+{
+    paxisbutton->setVelocityAcceleration(enabled);
+    naxisbutton->setVelocityAcceleration(enabled);
+}
+
+bool JoyAxis::getButtonsPresetVelocityAcceleration()
+{
+    bool presetVelocityAcceleration = false;
+
+    if (paxisbutton->isVelocityAccelerationEnabled() == naxisbutton->isVelocityAccelerationEnabled())
+    {
+        presetVelocityAcceleration = paxisbutton->isVelocityAccelerationEnabled();
+    }
+
+    return presetVelocityAcceleration;
+}
+
+void JoyAxis::setButtonsVelocityGain(double value)
+{
+    paxisbutton->setVelocityGain(value);
+    naxisbutton->setVelocityGain(value);
+}
+
+double JoyAxis::getButtonsPresetVelocityGain()
+{
+    double presetVelocityGain = JoyButton::DEFAULTVELOCITYGAIN;
+
+    if (paxisbutton->getVelocityGain() == naxisbutton->getVelocityGain())
+    {
+        presetVelocityGain = paxisbutton->getVelocityGain();
+    }
+
+    return presetVelocityGain;
+}
+
+void JoyAxis::setButtonsVelocityCap(double value)
+{
+    paxisbutton->setVelocityCap(value);
+    naxisbutton->setVelocityCap(value);
+}
+
+double JoyAxis::getButtonsPresetVelocityCap()
+{
+    double presetVelocityCap = JoyButton::DEFAULTVELOCITYCAP;
+
+    if (paxisbutton->getVelocityCap() == naxisbutton->getVelocityCap())
+    {
+        presetVelocityCap = paxisbutton->getVelocityCap();
+    }
+
+    return presetVelocityCap;
+}
+
+void JoyAxis::setButtonsVelocityDecay(double value)
+{
+    paxisbutton->setVelocityDecay(value);
+    naxisbutton->setVelocityDecay(value);
+}
+
+double JoyAxis::getButtonsPresetVelocityDecay()
+{
+    double presetVelocityDecay = JoyButton::DEFAULTVELOCITYDECAY;
+
+    if (paxisbutton->getVelocityDecay() == naxisbutton->getVelocityDecay())
+    {
+        presetVelocityDecay = paxisbutton->getVelocityDecay();
+    }
+
+    return presetVelocityDecay;
+}
+
+/* Pass a raw value through the axis filter. Dead zone crossings of
+ * the raw and the filtered values are counted so the number of
+ * transitions removed by the filter can be reported.
+ */
+int JoyAxis::filterValue(int value, bool ignoresets)
+{
+    int result = filter.filter(value, PadderCommon::getMonotonicTime());
+
+    bool tempUnfilteredSafeZone = !inFilterDeadZone(value);
+    bool tempFilteredSafeZone = !inFilterDeadZone(result);
+    if (tempUnfilteredSafeZone != unfilteredSafeZone)
+    {
+        unfilteredTransitions++;
+    }
+
+    if (tempFilteredSafeZone != filteredSafeZone)
+    {
+        filteredTransitions++;
+    }
+
+    unfilteredSafeZone = tempUnfilteredSafeZone;
+    filteredSafeZone = tempFilteredSafeZone;
+    unfilteredIgnoreSets = ignoresets;
+
+    if (filter.isSettled())
+    {
+        filterTimer.stop();
+    }
+    else if (!filterTimer.isActive())
+    {
+        filterTimer.start();
+    }
+
+    return result;
+}
+
+// Use the dead zone of the stick when the axis is part of one
+bool JoyAxis::inFilterDeadZone(int value)
+{
+    bool result = false;
+
+    if (this->stick)
+    {
+        result = abs(calculateThrottledValue(value)) <= stick->getDeadZone();
+    }
+    else
+    {
+        result = inDeadZone(value);
+    }
+
+    return result;
+}
+
+void JoyAxis::settleFilter()
+{
+    joyEvent(uncalibratedValue, unfilteredIgnoreSets);
+}
+
+void JoyAxis::setFilterMode(AxisFilter::FilterMode mode)
+{
+    filterTimer.stop();
+    filter.setMode(mode);
+}
+
+AxisFilter::FilterMode JoyAxis::getFilterMode()
+{
+    return filter.getMode();
+}
+
+void JoyAxis::setFilterCutoff(double value)
+{
+    filter.setCutoff(value);
+}
+
+double JoyAxis::getFilterCutoff()
+{
+    return filter.getCutoff();
+}
+
+void JoyAxis::setFilterBeta(double value)
+{
+    filter.setBeta(value);
+}
+
+double JoyAxis::getFilterBeta()
+{
+    return filter.getBeta();
+}
+
+int JoyAxis::getFilteredTransitions()
+{
+    return filteredTransitions;
+}
+
+int JoyAxis::getSuppressedTransitions()
+{
+    return qMax(0, unfilteredTransitions - filteredTransitions);
+}
+
+/* Map raw values so that the recorded center becomes 0 and the
+ * recorded min and max become the ends of the axis range. Passing
+ * a range that does not contain the center removes the calibration.
+ */
+void JoyAxis::setCalibration(int center, int min, int max)
+{
+    if (min < center && center < max)
+    {
+        calibrated = true;
+        calibrationCenter = center;
+        calibrationMin = min;
+        calibrationMax = max;
+        calibrationNegativeScale = -AXISMIN / (double)(center - min);
+        calibrationPositiveScale = AXISMAX / (double)(max - center);
+    }
+    else
+    {
+        resetCalibration();
+    }
+}
+
+void JoyAxis::resetCalibration()
+{
+    calibrated = false;
+    calibrationCenter = 0;
+    calibrationMin = AXISMIN;
+    calibrationMax = AXISMAX;
+    calibrationNegativeScale = 1.0;
+    calibrationPositiveScale = 1.0;
+}
+
+bool JoyAxis::isCalibrated()
+{
+    return calibrated;
+}
+
+int JoyAxis::getCalibrationCenter()
+{
+    return calibrationCenter;
+}
+
+int JoyAxis::getCalibrationMin()
+{
+    return calibrationMin;
+}
+
+int JoyAxis::getCalibrationMax()
+{
+    return calibrationMax;
+}
+
+int JoyAxis::getUncalibratedValue()
+{
+    return uncalibratedValue;
+}
+
+int JoyAxis::calibrateValue(int value)
+{
+    double result = 0.0;
+    if (value >= calibrationCenter)
+    {
+        result = (value - calibrationCenter) * calibrationPositiveScale;
+    }
+    else
+    {
+        result = (value - calibrationCenter) * calibrationNegativeScale;
+    }
+
+    return qBound(AXISMIN, (int)round(result), AXISMAX);
+}
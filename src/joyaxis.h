@@ -9,6 +9,7 @@
 #include <QXmlStreamWriter>
 
 #include "joyaxisbutton.h"
+#include "axisfilter.h"
 
 class JoyControlStick;
 
@@ -21,6 +22,7 @@ public:
     ~JoyAxis();
 
     void joyEvent(int value, bool ignoresets=false);
+    void release(bool ignoresets=false);
     bool inDeadZone(int value);
     QString getName();
     void setIndex(int index);
@@ -73,9 +75,35 @@ public:
 
     void setButtonsSensitivity(double value);
     double getButtonsPresetSensitivity();
+    void setButtonsVelocityAcceleration(bool enabled);
+    bool getButtonsPresetVelocityAcceleration();
+    void setButtonsVelocityGain(double value);
+    double getButtonsPresetVelocityGain();
+    void setButtonsVelocityCap(double value);
+    double getButtonsPresetVelocityCap();
+    void setButtonsVelocityDecay(double value);
+    double getButtonsPresetVelocityDecay();
+
+    void setFilterMode(AxisFilter::FilterMode mode);
+    AxisFilter::FilterMode getFilterMode();
+    void setFilterCutoff(double value);
+    double getFilterCutoff();
+    void setFilterBeta(double value);
+    double getFilterBeta();
+    int getFilteredTransitions();
+    int getSuppressedTransitions();
+
+    void setCalibration(int center, int min, int max);
+    void resetCalibration();
+    bool isCalibrated();
+    int getCalibrationCenter();
+    int getCalibrationMin();
+    int getCalibrationMax();
+    int getUncalibratedValue();
 
     virtual bool isDefault();
 
+    static const int FILTERSETTLEINTERVAL;
     static const int AXISMIN;
     static const int AXISMAX;
     static const int AXISDEADZONE;
@@ -88,6 +116,10 @@ protected:
     void adjustRange();
     int calculateThrottledValue(int value);
     void setCurrentRawValue(int value);
+    void processValue(int value, bool ignoresets);
+    int filterValue(int value, bool ignoresets);
+    bool inFilterDeadZone(int value);
+    int calibrateValue(int value);
 
     int index;
     int deadZone;
@@ -112,6 +144,30 @@ protected:
     int currentThrottledDeadValue;
     JoyControlStick *stick;
 
+    AxisFilter filter;
+    // Feeds the last raw value through the filter again while the
+    // filtered value has not caught up with it
+    QTimer filterTimer;
+    bool unfilteredIgnoreSets;
+    bool unfilteredSafeZone;
+    bool filteredSafeZone;
+    // Number of times the raw and the filtered value crossed the
+    // edge of the dead zone
+    int unfilteredTransitions;
+    int filteredTransitions;
+
+    // Range of the device recorded by AxisCalibration. Raw values
+    // are mapped so the center, min and max become 0, AXISMIN and
+    // AXISMAX. The scales are computed once in setCalibration
+    bool calibrated;
+    int calibrationCenter;
+    int calibrationMin;
+    int calibrationMax;
+    double calibrationNegativeScale;
+    double calibrationPositiveScale;
+    // Last value reported by the device before calibration
+    int uncalibratedValue;
+
 signals:
     void active(int value);
     void released(int value);
@@ -126,6 +182,9 @@ public slots:
 
     void setDeadZone(int value);
     void setMaxZoneValue(int value);
+
+private slots:
+    void settleFilter();
 };
 
 #endif // JOYAXIS_H
@@ -1,26 +1,47 @@
 #include <QDebug>
 #include <QStringList>
+#include <QMap>
+#include <QMapIterator>
 #include <cmath>
 
 #include "joybutton.h"
 #include "vdpad.h"
 #include "event.h"
+#include "common.h"
+#include "mousescheduler.h"
 
 const QString JoyButton::xmlName = "button";
 const int JoyButton::ENABLEDTURBODEFAULT = 100;
+const int JoyButton::MOUSECURVETABLESIZE = 256;
+// The power curve is evaluated directly below this many table
+// segments where its slope is too steep to interpolate
+const int JoyButton::MOUSECURVEEXACTSEGMENTS = 16;
+// Lowest power curve sensitivity that is sampled into a table
+const double JoyButton::MOUSECURVETABLESENSITIVITY = 0.5;
+// Time in milliseconds that keys stay pressed before a pause starts
+const int JoyButton::PAUSEHOLDTIME = 100;
+// Time in milliseconds that turbo keeps slots pressed by default
+const int JoyButton::TURBOPRESSTIME = 10;
+const double JoyButton::DEFAULTVELOCITYGAIN = 0.25;
+const double JoyButton::DEFAULTVELOCITYCAP = 3.0;
+const double JoyButton::DEFAULTVELOCITYDECAY = 0.25;
+
+qint64 JoyButton::currentInputTimestamp = 0;
+LatencyHistogram* JoyButton::currentInputLatency = 0;
 
 JoyButton::JoyButton(int index, int originset, QObject *parent) :
-    QObject(parent)
+    QObject(parent),
+    turboTimer(this, &JoyButton::turboEvent),
+    pauseTimer(this, &JoyButton::pauseEvent),
+    holdTimer(this, &JoyButton::holdEvent),
+    pauseWaitTimer(this, &JoyButton::pauseWaitEvent),
+    createDeskTimer(this, &JoyButton::waitForDeskEvent),
+    releaseDeskTimer(this, &JoyButton::waitForReleaseDeskEvent)
 {
     vdpad = 0;
-    slotiter = 0;
-    connect(&pauseTimer, SIGNAL(timeout()), this, SLOT(pauseEvent()));
-    connect(&pauseWaitTimer, SIGNAL(timeout()), this, SLOT(pauseWaitEvent()));
-    connect(&holdTimer, SIGNAL(timeout()), this, SLOT(holdEvent()));
-    connect(&createDeskTimer, SIGNAL(timeout()), this, SLOT(waitForDeskEvent()));
-    connect(&releaseDeskTimer, SIGNAL(timeout()), this, SLOT(waitForReleaseDeskEvent()));
-    connect(&mouseEventTimer, SIGNAL(timeout()), this, SLOT(mouseEvent()));
-    connect(&turboTimer, SIGNAL(timeout()), this, SLOT(turboEvent()));
+    programCounter = -1;
+    inputTimestamp = 0;
+    inputLatency = 0;
 
     this->reset();
     this->index = index;
@@ -65,6 +86,9 @@ void JoyButton::joyEvent(bool pressed, bool ignoresets)
     {
         if (pressed != isDown)
         {
+            inputTimestamp = currentInputTimestamp;
+            inputLatency = currentInputLatency;
+
             if (pressed)
             {
                 emit clicked(index);
@@ -116,13 +140,25 @@ void JoyButton::joyEvent(bool pressed, bool ignoresets)
                 isButtonPressedQueue.enqueue(isButtonPressed);
             }
 
+            // Pause and hold slots only wait for their deadline. Check
+            // them now since a change of the button can end them early
+            if (currentPause && pauseWaitTimer.isActive())
+            {
+                pauseWaitTimer.start(0);
+            }
+
+            if (currentHold && holdTimer.isActive())
+            {
+                holdTimer.start(0);
+            }
+
             if (useTurbo)
             {
                 if (isButtonPressed && activePress && !turboTimer.isActive())
                 {
-                    buttonHold.restart();
+                    buttonHoldStart = PadderCommon::getMonotonicTime();
                     buttonHeldRelease.restart();
-                    turboTimer.start();
+                    startTurbo();
                 }
                 else if (!isButtonPressed && !activePress && turboTimer.isActive())
                 {
@@ -140,14 +176,14 @@ void JoyButton::joyEvent(bool pressed, bool ignoresets)
                 bool releasedCalled = distanceEvent();
                 if (releasedCalled)
                 {
-                    buttonHold.restart();
+                    buttonHoldStart = PadderCommon::getMonotonicTime();
                     buttonHeldRelease.restart();
                     createDeskTimer.start(0);
                 }
             }
             else if (isButtonPressed && activePress)
             {
-                buttonHold.restart();
+                buttonHoldStart = PadderCommon::getMonotonicTime();
                 buttonHeldRelease.restart();
                 createDeskTimer.start(0);
             }
@@ -161,7 +197,7 @@ void JoyButton::joyEvent(bool pressed, bool ignoresets)
             bool releasedCalled = distanceEvent();
             if (releasedCalled)
             {
-                buttonHold.restart();
+                buttonHoldStart = PadderCommon::getMonotonicTime();
                 buttonHeldRelease.restart();
                 createDeskTimer.start(0);
             }
@@ -218,33 +254,31 @@ void JoyButton::reset()
     pauseWaitTimer.stop();
     createDeskTimer.stop();
     releaseDeskTimer.stop();
-    mouseEventTimer.stop();
+    MouseScheduler::getInstance()->removeButton(this);
     holdTimer.stop();
 
-    if (slotiter)
-    {
-        delete slotiter;
-        slotiter = 0;
-    }
-
     releaseDeskEvent(true);
     clearAssignedSlots();
 
     isButtonPressedQueue.clear();
     ignoreSetQueue.clear();
-    mouseEventQueue.clear();
 
-    currentCycle = 0;
-    previousCycle = 0;
+    programCounter = -1;
+    currentCycle = -1;
+    previousCycle = -1;
     currentPause = 0;
     currentHold = 0;
-    currentDistance = 0;
+    currentDistance = -1;
     currentRawValue = 0;
-    currentMouseEvent = 0;
+    buttonHoldStart = 0;
+    pauseWaitDeadline = 0;
 
     isKeyPressed = isButtonPressed = false;
     toggle = false;
     turboInterval = 0;
+    turboDutyCycle = 0;
+    turboPhaseLock = false;
+    turboCycleStart = 0;
     isDown = false;
     toggleActiveState = false;
     useTurbo = false;
@@ -255,6 +289,13 @@ void JoyButton::reset()
     springWidth = 0;
     springHeight = 0;
     sensitivity = 1.0;
+    customCurvePoints.clear();
+    buildMouseCurveTable();
+    velocityAcceleration = false;
+    velocityGain = DEFAULTVELOCITYGAIN;
+    velocityCap = DEFAULTVELOCITYCAP;
+    velocityDecay = DEFAULTVELOCITYDECAY;
+    resetVelocityBoost();
     setSelection = -1;
     setSelectionCondition = SetChangeDisabled;
     ignoresets = false;
@@ -294,7 +335,7 @@ void JoyButton::turboEvent()
         isKeyPressed = true;
         if (turboTimer.isActive())
         {
-            turboTimer.start(10);
+            turboTimer.startAt(turboCycleStart + getTurboPressTime());
         }
     }
     else
@@ -312,110 +353,136 @@ void JoyButton::turboEvent()
         isKeyPressed = false;
         if (turboTimer.isActive())
         {
-            turboTimer.start(turboInterval - 10);
+            // Edges are placed on a fixed grid so timer slack does
+            // not add up. Cycles that were missed entirely are skipped
+            qint64 period = qMax(turboInterval, 10) * 1000000LL;
+            qint64 currentTime = PadderCommon::getMonotonicTime();
+            turboCycleStart += period;
+            if (currentTime - turboCycleStart >= period)
+            {
+                turboCycleStart += ((currentTime - turboCycleStart) / period) * period;
+            }
+
+            turboTimer.startAt(turboCycleStart);
         }
 
     }
 }
 
+void JoyButton::startTurbo()
+{
+    qint64 period = qMax(turboInterval, 10) * 1000000LL;
+    turboCycleStart = PadderCommon::getMonotonicTime();
+    if (turboPhaseLock)
+    {
+        // Wait for the next multiple of the period
+        turboCycleStart = ((turboCycleStart + period - 1) / period) * period;
+    }
+
+    turboTimer.startAt(turboCycleStart);
+}
+
+// Time in nanoseconds that slots stay pressed during a turbo cycle
+qint64 JoyButton::getTurboPressTime()
+{
+    qint64 period = qMax(turboInterval, 10) * 1000000LL;
+    qint64 pressTime = TURBOPRESSTIME * 1000000LL;
+    if (turboDutyCycle > 0)
+    {
+        pressTime = (period * turboDutyCycle) / 100;
+    }
+
+    // Leave time for both edges of the cycle
+    return qBound((qint64)1000000LL, pressTime, period - 1000000LL);
+}
+
+void JoyButton::setTurboDutyCycle(int value)
+{
+    turboDutyCycle = qBound(0, value, 99);
+}
+
+int JoyButton::getTurboDutyCycle()
+{
+    return turboDutyCycle;
+}
+
+void JoyButton::setTurboPhaseLock(bool enabled)
+{
+    turboPhaseLock = enabled;
+}
+
+bool JoyButton::isTurboPhaseLocked()
+{
+    return turboPhaseLock;
+}
+
 bool JoyButton::distanceEvent()
 {
     bool released = false;
 
-    if (slotiter)
+    if (programCounter >= 0 && programHasDistance)
     {
-        bool distanceFound = containsDistanceSlots();
+        double currentDistance = getDistanceFromDeadZone();
+        int previousDistanceSlot = -1;
+        int segmentStart = previousCycle + 1;
+        int segment = 0;
+        if (previousCycle >= 0)
+        {
+            segment = program.at(previousCycle).segment + 1;
+        }
 
-        if (distanceFound)
+        // Thresholds only grow within a segment. The applicable zone
+        // is the last one whose threshold has been reached
+        QVector<double>::const_iterator thresholdBegin = distanceThresholds.constBegin();
+        QVector<double>::const_iterator first = thresholdBegin + segmentZones.at(segment);
+        QVector<double>::const_iterator last = thresholdBegin + segmentZones.at(segment + 1);
+        QVector<double>::const_iterator zone = qUpperBound(first, last, currentDistance);
+        if (zone != first)
         {
-            double currentDistance = getDistanceFromDeadZone();
-            double tempDistance = 0.0;
-            JoyButtonSlot *previousDistanceSlot = 0;
-            QListIterator<JoyButtonSlot*> iter(assignments);
-            if (previousCycle)
-            {
-                iter.findNext(previousCycle);
-            }
+            previousDistanceSlot = distanceInstructions.at((zone - thresholdBegin) - 1);
+        }
 
-            while (iter.hasNext())
+        // No applicable distance slot
+        if (previousDistanceSlot < 0)
+        {
+            if (this->currentDistance >= 0)
             {
-                JoyButtonSlot *slot = iter.next();
-                int tempcode = slot->getSlotCode();
-                if (slot->getSlotMode() == JoyButtonSlot::JoyDistance)
-                {
-                    tempDistance += tempcode / 100.0;
+                // Distance slot is currently active.
+                // Release slots, return to the start of
+                // the segment, and nullify currentDistance
+                pauseTimer.stop();
+                pauseWaitTimer.stop();
+                holdTimer.stop();
 
-                    if (currentDistance < tempDistance)
-                    {
-                        iter.toBack();
-                    }
-                    else
-                    {
-                        previousDistanceSlot = slot;
-                    }
-                }
-                else if (slot->getSlotMode() == JoyButtonSlot::JoyCycle)
-                {
-                    tempDistance = 0.0;
-                    iter.toBack();
-                }
-            }
+                // Release stuff
+                releaseActiveSlots();
+                currentPause = currentHold = 0;
 
-            // No applicable distance slot
-            if (!previousDistanceSlot)
-            {
-                if (this->currentDistance)
-                {
-                    // Distance slot is currently active.
-                    // Release slots, return iterator to
-                    // the front, and nullify currentDistance
-                    pauseTimer.stop();
-                    pauseWaitTimer.stop();
-                    holdTimer.stop();
-
-                    // Release stuff
-                    releaseActiveSlots();
-                    currentPause = currentHold = 0;
-
-                    slotiter->toFront();
-                    if (previousCycle)
-                    {
-                        slotiter->findNext(previousCycle);
-                    }
+                programCounter = segmentStart;
 
-                    this->currentDistance = 0;
-                    released = true;
-                }
+                this->currentDistance = -1;
+                released = true;
             }
-            // An applicable distance slot was found
-            else if (previousDistanceSlot)
-            {
-                if (this->currentDistance != previousDistanceSlot)
-                {
-                    // Active distance slot is not the applicable slot.
-                    // Deactive slots in previous distance range and
-                    // activate new slots. Set currentDistance to
-                    // new slot.
-                    pauseTimer.stop();
-                    pauseWaitTimer.stop();
-                    holdTimer.stop();
-
-                    // Release stuff
-                    releaseActiveSlots();
-                    currentPause = currentHold = 0;
-
-                    slotiter->toFront();
-                    if (previousCycle)
-                    {
-                        slotiter->findNext(previousCycle);
-                    }
+        }
+        // An applicable distance slot was found
+        else if (this->currentDistance != previousDistanceSlot)
+        {
+            // Active distance slot is not the applicable slot.
+            // Deactive slots in previous distance range and
+            // activate new slots. Set currentDistance to
+            // new slot.
+            pauseTimer.stop();
+            pauseWaitTimer.stop();
+            holdTimer.stop();
 
-                    slotiter->findNext(previousDistanceSlot);
+            // Release stuff
+            releaseActiveSlots();
+            currentPause = currentHold = 0;
 
-                    this->currentDistance = previousDistanceSlot;
-                    released = true;
-                }
-            }
+            programCounter = previousDistanceSlot + 1;
+
+            this->currentDistance = previousDistanceSlot;
+            released = true;
         }
     }
 
@@ -428,24 +495,24 @@ void JoyButton::createDeskEvent()
 
     quitEvent = false;
 
-    if (!slotiter)
+    if (programCounter < 0)
     {
-        slotiter = new QListIterator<JoyButtonSlot*> (assignments);
+        programCounter = 0;
         distanceEvent();
     }
-    else if (!slotiter->hasPrevious())
+    else if (programCounter == 0)
     {
         distanceEvent();
     }
-    else if (currentCycle)
+    else if (currentCycle >= 0)
     {
-        currentCycle = 0;
+        currentCycle = -1;
         distanceEvent();
     }
 
     activateSlots();
 
-    if (currentCycle)
+    if (currentCycle >= 0)
     {
         quitEvent = true;
     }
@@ -471,34 +538,34 @@ void JoyButton::createDeskEvent()
 
 void JoyButton::activateSlots()
 {
-    if (slotiter)
+    if (programCounter >= 0)
     {
         bool exit = false;
 
-        while (slotiter->hasNext() && !exit)
+        while (programCounter < program.size() && !exit)
         {
-            JoyButtonSlot *slot = slotiter->next();
-            int tempcode = slot->getSlotCode();
-            JoyButtonSlot::JoySlotInputAction mode = slot->getSlotMode();
+            const JoyButtonInstruction &instruction = program.at(programCounter);
+            JoyButtonSlot *slot = instruction.slot;
+            int tempcode = instruction.code;
+            JoyButtonSlot::JoySlotInputAction mode = instruction.mode;
 
             if (mode == JoyButtonSlot::JoyKeyboard || mode == JoyButtonSlot::JoyMouseButton)
             {
                 sendevent(tempcode, true, mode);
+                recordOutputLatency();
                 activeSlots.append(slot);
             }
             else if (mode == JoyButtonSlot::JoyMouseMovement)
             {
-                slot->getMouseInterval()->restart();
-                currentMouseEvent = slot;
+                slot->restartMouseInterval();
+                resetVelocityBoost();
                 activeSlots.append(slot);
-                mouseEvent();
-                currentMouseEvent = 0;
+                MouseScheduler::getInstance()->addButton(this);
             }
             else if (mode == JoyButtonSlot::JoyPause)
             {
                 currentPause = slot;
-                pauseHold.restart();
-                pauseTimer.start(0);
+                pauseTimer.start(PAUSEHOLDTIME);
                 exit = true;
             }
             else if (mode == JoyButtonSlot::JoyHold)
@@ -509,7 +576,7 @@ void JoyButton::activateSlots()
             }
             else if (mode == JoyButtonSlot::JoyCycle)
             {
-                currentCycle = slot;
+                currentCycle = programCounter;
                 exit = true;
             }
             else if (mode == JoyButtonSlot::JoyDistance)
@@ -520,34 +587,39 @@ void JoyButton::activateSlots()
             {
                 exit = true;
             }
+
+            programCounter++;
         }
     }
 }
 
+/* Called by the mouse scheduler once per tick. Movement from every
+ * active mouse movement slot is handed to the scheduler which sends
+ * the combined movement of all buttons at the end of the tick.
+ */
 void JoyButton::mouseEvent()
 {
-    JoyButtonSlot *buttonslot = 0;
-    if (currentMouseEvent)
-    {
-        buttonslot = currentMouseEvent;
-    }
-    else if (!mouseEventQueue.isEmpty())
-    {
-        buttonslot = mouseEventQueue.dequeue();
-    }
+    MouseScheduler *scheduler = MouseScheduler::getInstance();
+    qint64 currentTime = PadderCommon::getMonotonicTime();
+    double velocityMultiplier = updateVelocityBoost(currentTime);
+    bool hasMovement = false;
 
-    if (buttonslot)
+    QListIterator<JoyButtonSlot*> iter(activeSlots);
+    while (iter.hasNext())
     {
-        QTime* mouseInterval = buttonslot->getMouseInterval();
-
-        int mousedirection = buttonslot->getSlotCode();
-        JoyButton::JoyMouseMovementMode mousemode = getMouseMode();
-        int mousespeed = 0;
-        int timeElapsed = mouseInterval->elapsed();
-
-        bool isActive = activeSlots.contains(buttonslot);
-        if (isActive)
+        JoyButtonSlot *buttonslot = iter.next();
+        if (buttonslot->getSlotMode() == JoyButtonSlot::JoyMouseMovement)
         {
+            hasMovement = true;
+            int mousedirection = buttonslot->getSlotCode();
+            JoyButton::JoyMouseMovementMode mousemode = getMouseMode();
+            int mousespeed = 0;
+            // Time since the previous tick in seconds. The slot always
+            // advances to the current time and any movement too small
+            // to send is carried over in the slot distance
+            double timeElapsed = (currentTime - buttonslot->getMouseIntervalStart()) / 1000000000.0;
+            buttonslot->setMouseIntervalStart(currentTime);
+
             if (mousemode == JoyButton::MouseCursor)
             {
                 if (mousedirection == JoyButtonSlot::MouseRight)
@@ -571,79 +643,41 @@ void JoyButton::mouseEvent()
                 int mouse1 = 0;
                 int mouse2 = 0;
                 double sumDist = buttonslot->getMouseDistance();
-                JoyMouseCurve currentCurve = getMouseCurve();
-
-                switch (currentCurve)
-                {
-                    case LinearCurve:
-                    {
-                        break;
-                    }
-                    case QuadraticCurve:
-                    {
-                        difference = difference * difference;
-                        break;
-                    }
-                    case CubicCurve:
-                    {
-                        difference = difference * difference * difference;
-                        break;
-                    }
-                    case QuadraticExtremeCurve:
-                    {
-                        double temp = difference;
-                        difference = difference * difference;
-                        difference = (temp >= 0.95) ? (difference * 1.5) : difference;
-                        break;
-                    }
-                    case PowerCurve:
-                    {
-                        double tempsensitive = qMin(qMax(sensitivity, 1.0e-3), 1.0e+3);
-                        double temp = qMin(qMax(pow(difference, 1.0 / tempsensitive), 0.0), 1.0);
-                        difference = temp;
-                        break;
-                    }
-                    default:
-                    {
-                        break;
-                    }
-                }
+                difference = getMouseCurveValue(difference) * velocityMultiplier;
 
                 //difference = qMin(qMax(difference, 0.0), 1.0);
 
                 int distance = 0;
                 if (mousedirection == JoyButtonSlot::MouseRight)
                 {
-                    sumDist += difference * (mousespeed * JoyButtonSlot::JOYSPEED * timeElapsed) / 1000.0;
-                    distance = (int)floor(sumDist + 0.5);
+                    sumDist += difference * mousespeed * JoyButtonSlot::JOYSPEED * timeElapsed;
+                    distance = (int)floor(sumDist);
                     mouse1 = distance;
                 }
                 else if (mousedirection == JoyButtonSlot::MouseLeft)
                 {
-                    sumDist += difference * (mousespeed * JoyButtonSlot::JOYSPEED * timeElapsed) / 1000.0;
-                    distance = (int)floor(sumDist + 0.5);
+                    sumDist += difference * mousespeed * JoyButtonSlot::JOYSPEED * timeElapsed;
+                    distance = (int)floor(sumDist);
                     mouse1 = -distance;
                 }
                 else if (mousedirection == JoyButtonSlot::MouseDown)
                 {
-                    sumDist += difference * (mousespeed * JoyButtonSlot::JOYSPEED * timeElapsed) / 1000.0;
-                    distance = (int)floor(sumDist + 0.5);
+                    sumDist += difference * mousespeed * JoyButtonSlot::JOYSPEED * timeElapsed;
+                    distance = (int)floor(sumDist);
                     mouse2 = distance;
                 }
                 else if (mousedirection == JoyButtonSlot::MouseUp)
                 {
-                    sumDist += difference * (mousespeed * JoyButtonSlot::JOYSPEED * timeElapsed) / 1000.0;
-                    distance = (int)floor(sumDist + 0.5);
+                    sumDist += difference * mousespeed * JoyButtonSlot::JOYSPEED * timeElapsed;
+                    distance = (int)floor(sumDist);
                     mouse2 = -distance;
                 }
 
                 if (distance >= 1)
                 {
-                    sendevent(mouse1, mouse2);
-                    //sumDist = 0.0;
-                    sumDist = (sumDist - distance) * 0.85;
-                    mouseInterval->restart();
-                    mouseEventTimer.stop();
+                    scheduler->addRelativeMotion(mouse1, mouse2);
+                    recordOutputLatency();
+                    sumDist -= distance;
                 }
 
                 buttonslot->setDistance(sumDist);
@@ -653,7 +687,6 @@ void JoyButton::mouseEvent()
                 double mouse1 = -2.0;
                 double mouse2 = -2.0;
                 double difference = getSpringDistanceFromDeadZone();
-                double sumDist = buttonslot->getMouseDistance();
 
                 if (mousedirection == JoyButtonSlot::MouseRight)
                 {
@@ -672,49 +705,15 @@ void JoyButton::mouseEvent()
                     mouse2 = -difference;
                 }
 
-                double tempdiff = (difference >= 0.0) ? difference : -difference;
-                double change = sumDist - tempdiff;
-                change = (change >= 0.0) ? change : -change;
-                //if (change > 0.005)
-                //{
-                    sendSpringEvent(mouse1, mouse2, springWidth, springHeight);
-                    //buttonslot->setDistance(tempdiff);
-                //}
-                    mouseInterval->restart();
-                    mouseEventTimer.stop();
-            }
-        }
-
-        if (isActive)
-        {
-            mouseEventQueue.enqueue(buttonslot);
-            if (!mouseEventTimer.isActive())
-            {
-                mouseEventTimer.start(5);
+                scheduler->addSpringMotion(mouse1, mouse2, springWidth, springHeight);
+                recordOutputLatency();
             }
         }
-        else
-        {
-            buttonslot->setDistance(0.0);
-            mouseInterval->restart();
-            mouseEventTimer.stop();
+    }
 
-            if (mousemode == JoyButton::MouseSpring)
-            {
-                double mouse1 = (mousedirection == JoyButtonSlot::MouseLeft ||
-                                 mousedirection == JoyButtonSlot::MouseRight) ? 0.0 : -2.0;
-                double mouse2 = (mousedirection == JoyButtonSlot::MouseUp ||
-                                 mousedirection == JoyButtonSlot::MouseDown) ? 0.0 : -2.0;
-                sendSpringEvent(mouse1, mouse2);
-            }
-        }
-        /*else
-        {
-            //sendSpringEvent(0.0, 0.0);
-            buttonslot->setDistance(0.0);
-            mouseInterval->restart();
-            mouseEventTimer.stop();
-        }*/
+    if (!hasMovement)
+    {
+        scheduler->removeButton(this);
     }
 }
 
@@ -786,6 +785,20 @@ void JoyButton::readConfig(QXmlStreamReader *xml)
                     this->setUseTurbo(true);
                 }
             }
+            else if (xml->name() == "turbodutycycle" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                int tempchoice = temptext.toInt();
+                this->setTurboDutyCycle(tempchoice);
+            }
+            else if (xml->name() == "turbophaselock" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                if (temptext == "true")
+                {
+                    this->setTurboPhaseLock(true);
+                }
+            }
             else if (xml->name() == "mousespeedx" && xml->isStartElement())
             {
                 QString temptext = xml->readElementText();
@@ -883,6 +896,59 @@ void JoyButton::readConfig(QXmlStreamReader *xml)
                 {
                     setMouseCurve(PowerCurve);
                 }
+                else if (temptext == "custom")
+                {
+                    setMouseCurve(CustomCurve);
+                }
+            }
+            else if (xml->name() == "mousecurvepoints" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                QList<QPointF> temppoints;
+                QStringListIterator iter(temptext.split(" ", QString::SkipEmptyParts));
+                while (iter.hasNext())
+                {
+                    QStringList temppair = iter.next().split(":");
+                    if (temppair.size() == 2)
+                    {
+                        bool validX = false;
+                        bool validY = false;
+                        double tempx = temppair.at(0).toDouble(&validX);
+                        double tempy = temppair.at(1).toDouble(&validY);
+                        if (validX && validY)
+                        {
+                            temppoints.append(QPointF(tempx, tempy));
+                        }
+                    }
+                }
+
+                setCustomCurvePoints(temppoints);
+            }
+            else if (xml->name() == "velocityacceleration" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                if (temptext == "true")
+                {
+                    setVelocityAcceleration(true);
+                }
+            }
+            else if (xml->name() == "velocitygain" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                double tempchoice = temptext.toDouble();
+                setVelocityGain(tempchoice);
+            }
+            else if (xml->name() == "velocitycap" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                double tempchoice = temptext.toDouble();
+                setVelocityCap(tempchoice);
+            }
+            else if (xml->name() == "velocitydecay" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                double tempchoice = temptext.toDouble();
+                setVelocityDecay(tempchoice);
             }
             else if (xml->name() == "mousespringwidth" && xml->isStartElement())
             {
@@ -923,6 +989,17 @@ void JoyButton::writeConfig(QXmlStreamWriter *xml)
         xml->writeTextElement("toggle", toggle ? "true" : "false");
         xml->writeTextElement("turbointerval", QString::number(turboInterval));
         xml->writeTextElement("useturbo", useTurbo ? "true" : "false");
+
+        if (turboDutyCycle > 0)
+        {
+            xml->writeTextElement("turbodutycycle", QString::number(turboDutyCycle));
+        }
+
+        if (turboPhaseLock)
+        {
+            xml->writeTextElement("turbophaselock", "true");
+        }
+
         xml->writeTextElement("mousespeedx", QString::number(mouseSpeedX));
         xml->writeTextElement("mousespeedy", QString::number(mouseSpeedY));
 
@@ -958,6 +1035,27 @@ void JoyButton::writeConfig(QXmlStreamWriter *xml)
             xml->writeTextElement("mouseacceleration", "power");
             xml->writeTextElement("mousesensitivity", QString::number(sensitivity));
         }
+        else if (mouseCurve == CustomCurve)
+        {
+            QStringList temppoints;
+            QListIterator<QPointF> iter(customCurvePoints);
+            while (iter.hasNext())
+            {
+                QPointF temppoint = iter.next();
+                temppoints.append(QString("%1:%2").arg(temppoint.x()).arg(temppoint.y()));
+            }
+
+            xml->writeTextElement("mouseacceleration", "custom");
+            xml->writeTextElement("mousecurvepoints", temppoints.join(" "));
+        }
+
+        if (velocityAcceleration)
+        {
+            xml->writeTextElement("velocityacceleration", "true");
+            xml->writeTextElement("velocitygain", QString::number(velocityGain));
+            xml->writeTextElement("velocitycap", QString::number(velocityCap));
+            xml->writeTextElement("velocitydecay", QString::number(velocityDecay));
+        }
 
         if (setSelectionCondition != SetChangeDisabled)
         {
@@ -1095,6 +1193,7 @@ void JoyButton::setAssignedSlot(int code, JoyButtonSlot::JoySlotInputAction mode
             setUseTurbo(false);
         }
 
+        compileSlots();
         emit slotsChanged();
     }
     else
@@ -1154,6 +1253,7 @@ void JoyButton::setAssignedSlot(int code, int index, JoyButtonSlot::JoySlotInput
             setUseTurbo(false);
         }
 
+        compileSlots();
         emit slotsChanged();
     }
     else
@@ -1256,23 +1356,17 @@ int JoyButton::getOriginSet()
 
 void JoyButton::pauseEvent()
 {
+    pauseTimer.stop();
+
     if (currentPause)
     {
-        if (pauseHold.elapsed() > 100)
-        {
-            releaseActiveSlots();
-            inpauseHold.restart();
-            pauseTimer.stop();
-            pauseWaitTimer.start(0);
-        }
-        else
-        {
-            pauseTimer.start(10);
-        }
+        releaseActiveSlots();
+        pauseWaitDeadline = PadderCommon::getMonotonicTime() +
+                (qint64)currentPause->getSlotCode() * 1000000LL;
+        pauseWaitTimer.start(0);
     }
     else
     {
-        pauseTimer.stop();
         pauseWaitTimer.stop();
     }
 }
@@ -1283,10 +1377,8 @@ void JoyButton::pauseWaitEvent()
     {
         if (!isButtonPressedQueue.isEmpty() && isButtonPressedQueue.size() > 2)
         {
-            if (slotiter)
+            if (programCounter >= 0)
             {
-                slotiter->toBack();
-
                 bool lastIgnoreSetState = ignoreSetQueue.last();
                 bool lastIsButtonPressed = isButtonPressedQueue.last();
                 ignoreSetQueue.clear();
@@ -1298,7 +1390,7 @@ void JoyButton::pauseWaitEvent()
                 releaseDeskTimer.stop();
                 pauseWaitTimer.stop();
 
-                slotiter->toFront();
+                programCounter = 0;
                 quitEvent = true;
             }
         }
@@ -1306,9 +1398,9 @@ void JoyButton::pauseWaitEvent()
 
     if (currentPause)
     {
-        if (inpauseHold.elapsed() < currentPause->getSlotCode())
+        if (PadderCommon::getMonotonicTime() < pauseWaitDeadline)
         {
-            pauseWaitTimer.start(10);
+            pauseWaitTimer.startAt(pauseWaitDeadline);
         }
         else
         {
@@ -1374,24 +1466,7 @@ void JoyButton::waitForReleaseDeskEvent()
 
 bool JoyButton::containsSequence()
 {
-    bool result = false;
-
-    QListIterator<JoyButtonSlot*> tempiter(assignments);
-    while (tempiter.hasNext())
-    {
-        JoyButtonSlot *slot = tempiter.next();
-        JoyButtonSlot::JoySlotInputAction mode = slot->getSlotMode();
-        if (mode == JoyButtonSlot::JoyPause ||
-            mode == JoyButtonSlot::JoyHold ||
-            mode == JoyButtonSlot::JoyDistance
-           )
-        {
-            result = true;
-            tempiter.toBack();
-        }
-    }
-
-    return result;
+    return programHasSequence;
 }
 
 void JoyButton::holdEvent()
@@ -1404,25 +1479,29 @@ void JoyButton::holdEvent()
             currentlyPressed = isButtonPressedQueue.last();
         }
 
+        qint64 currentTime = PadderCommon::getMonotonicTime();
+        qint64 holdDeadline = buttonHoldStart + (qint64)currentHold->getSlotCode() * 1000000LL;
+
         // Activate hold event
-        if (currentlyPressed && buttonHold.elapsed() > currentHold->getSlotCode())
+        if (currentlyPressed && currentTime >= holdDeadline)
         {
+            holdTimer.stop();
             releaseActiveSlots();
             QTimer::singleShot(0, this, SLOT(createDeskEvent()));
             currentHold = 0;
-            buttonHold.restart();
+            buttonHoldStart = currentTime;
         }
         // Elapsed time has not occurred
         else if (currentlyPressed)
         {
-            holdTimer.start(10);
+            holdTimer.startAt(holdDeadline);
         }
         // Pre-emptive release
         else
         {
-            if (slotiter)
+            if (programCounter >= 0)
             {
-                slotiter->toBack();
+                programCounter = program.size();
                 currentHold = 0;
                 createDeskEvent();
             }
@@ -1466,58 +1545,50 @@ void JoyButton::releaseDeskEvent(bool skipsetchange)
         ignoreSetQueue.clear();
     }
 
-    if (slotiter && !slotiter->hasNext())
+    if (programCounter >= program.size())
     {
-        // At the end of the list of assignments.
-        currentCycle = 0;
-        previousCycle = 0;
-        slotiter->toFront();
+        // At the end of the program.
+        currentCycle = -1;
+        previousCycle = -1;
+        programCounter = 0;
     }
-    else if (slotiter && slotiter->hasNext() && currentCycle)
+    else if (programCounter >= 0 && currentCycle >= 0)
     {
         // Cycle at the end of a segment.
-        slotiter->toFront();
-        slotiter->findNext(currentCycle);
+        programCounter = currentCycle + 1;
     }
-    else if (slotiter && slotiter->hasPrevious() && slotiter->hasNext() && !currentCycle)
+    else if (programCounter > 0)
     {
-        // Check if there is a cycle action slot after
-        // current slot. Useful after dealing with pause
+        // Jump past the cycle that ends the current
+        // segment. Useful after dealing with pause
         // actions.
-        JoyButtonSlot *tempslot = 0;
-        bool exit = false;
-        while (slotiter->hasNext() && !exit)
+        currentCycle = program.at(programCounter).segmentCycle;
+
+        // No cycle follows. Return to the front.
+        if (currentCycle < 0)
         {
-            tempslot = slotiter->next();
-            if (tempslot->getSlotMode() == JoyButtonSlot::JoyCycle)
-            {
-                currentCycle = tempslot;
-                exit = true;
-            }
+            programCounter = 0;
+            previousCycle = -1;
         }
-
-        // Didn't find any cycle. Move iterator
-        // to the front.
-        if (!currentCycle)
+        else
         {
-            slotiter->toFront();
-            previousCycle = 0;
+            programCounter = currentCycle + 1;
         }
     }
 
-    if (currentCycle)
+    if (currentCycle >= 0)
     {
         previousCycle = currentCycle;
-        currentCycle = 0;
+        currentCycle = -1;
     }
-    else if (slotiter && slotiter->hasNext() && containsReleaseSlots())
+    else if (programCounter >= 0 && programCounter < program.size() && programHasRelease)
     {
-        currentCycle = 0;
-        previousCycle = 0;
-        slotiter->toFront();
+        currentCycle = -1;
+        previousCycle = -1;
+        programCounter = 0;
     }
 
-    this->currentDistance = 0;
+    this->currentDistance = -1;
     quitEvent = true;
 
     //buttonMutex.unlock();
@@ -1571,19 +1642,7 @@ double JoyButton::getTotalSlotDistance(JoyButtonSlot *slot)
 
 bool JoyButton::containsDistanceSlots()
 {
-    bool result = false;
-    QListIterator<JoyButtonSlot*> iter(assignments);
-    while (iter.hasNext())
-    {
-        JoyButtonSlot *slot = iter.next();
-        if (slot->getSlotMode() == JoyButtonSlot::JoyDistance)
-        {
-            result = true;
-            iter.toBack();
-        }
-    }
-
-    return result;
+    return programHasDistance;
 }
 
 void JoyButton::clearAssignedSlots()
@@ -1600,6 +1659,7 @@ void JoyButton::clearAssignedSlots()
     }
 
     assignments.clear();
+    compileSlots();
     emit slotsChanged();
 }
 
@@ -1614,6 +1674,7 @@ void JoyButton::removeAssignedSlot(int index)
             slot = 0;
         }
 
+        compileSlots();
         emit slotsChanged();
     }
 }
@@ -1625,29 +1686,24 @@ void JoyButton::clearSlotsEventReset()
     pauseWaitTimer.stop();
     createDeskTimer.stop();
     releaseDeskTimer.stop();
-    mouseEventTimer.stop();
+    MouseScheduler::getInstance()->removeButton(this);
     holdTimer.stop();
 
-    if (slotiter)
-    {
-        delete slotiter;
-        slotiter = 0;
-    }
-
     releaseDeskEvent(true);
     clearAssignedSlots();
 
     isButtonPressedQueue.clear();
     ignoreSetQueue.clear();
-    mouseEventQueue.clear();
 
-    currentCycle = 0;
-    previousCycle = 0;
+    programCounter = -1;
+    currentCycle = -1;
+    previousCycle = -1;
     currentPause = 0;
     currentHold = 0;
-    currentDistance = 0;
+    currentDistance = -1;
     currentRawValue = 0;
-    currentMouseEvent = 0;
+    buttonHoldStart = 0;
+    pauseWaitDeadline = 0;
 
     isKeyPressed = isButtonPressed = false;
 }
@@ -1667,6 +1723,7 @@ void JoyButton::releaseActiveSlots()
             if (mode == JoyButtonSlot::JoyKeyboard || mode == JoyButtonSlot::JoyMouseButton)
             {
                 sendevent(tempcode, false, mode);
+                recordOutputLatency();
             }
             else if (mode == JoyButtonSlot::JoyMouseMovement)
             {
@@ -1685,81 +1742,134 @@ void JoyButton::releaseActiveSlots()
 
         activeSlots.clear();
 
-        mouseEventTimer.stop();
-        currentMouseEvent = 0;
-        if (!mouseEventQueue.isEmpty())
-        {
-            mouseEventQueue.clear();
-        }
+        MouseScheduler::getInstance()->removeButton(this);
     }
 }
 
 bool JoyButton::containsReleaseSlots()
 {
-    bool result = false;
-    QListIterator<JoyButtonSlot*> iter(assignments);
-    while (iter.hasNext())
-    {
-        JoyButtonSlot *slot = iter.next();
-        if (slot->getSlotMode() == JoyButtonSlot::JoyRelease)
-        {
-            result = true;
-            iter.toBack();
-        }
-    }
-
-    return result;
+    return programHasRelease;
 }
 
 void JoyButton::releaseSlotEvent()
 {
-    JoyButtonSlot *temp = 0;
+    int temp = -1;
 
     int timeElapsed = buttonHeldRelease.elapsed();
     int tempElapsed = 0;
 
-    if (containsReleaseSlots())
+    if (programHasRelease)
     {
-        QListIterator<JoyButtonSlot*> iter(assignments);
-        if (previousCycle)
-        {
-            iter.findNext(previousCycle);
-        }
+        int i = previousCycle + 1;
+        bool exit = false;
 
-        while (iter.hasNext())
+        while (i < program.size() && !exit)
         {
-            JoyButtonSlot *currentSlot = iter.next();
-            int tempcode = currentSlot->getSlotCode();
-            JoyButtonSlot::JoySlotInputAction mode = currentSlot->getSlotMode();
-            if (mode == JoyButtonSlot::JoyRelease)
+            const JoyButtonInstruction &instruction = program.at(i);
+            if (instruction.mode == JoyButtonSlot::JoyRelease)
             {
-                tempElapsed += tempcode;
+                tempElapsed += instruction.code;
                 if (tempElapsed <= timeElapsed)
                 {
-                    temp = currentSlot;
+                    temp = i;
                 }
-                else if (tempElapsed > timeElapsed)
+                else
                 {
-                    iter.toBack();
+                    exit = true;
                 }
             }
-            else if (mode == JoyButtonSlot::JoyCycle)
+            else if (instruction.mode == JoyButtonSlot::JoyCycle)
             {
-                tempElapsed = 0;
-                iter.toBack();
+                exit = true;
             }
+
+            i++;
         }
 
-        if (temp && slotiter)
+        if (temp >= 0 && programCounter >= 0)
         {
-            slotiter->toFront();
-            slotiter->findNext(temp);
+            programCounter = temp + 1;
             activateSlots();
             releaseActiveSlots();
         }
     }
 }
 
+/* Compile the assigned slots into a flat program. Cycle segments
+ * and the markers contained in the slots are resolved here once
+ * so executing the slots does not have to search the list. Any
+ * sequence in progress starts over with the new program.
+ */
+void JoyButton::compileSlots()
+{
+    program.clear();
+    program.reserve(assignments.size());
+    programHasSequence = false;
+    programHasDistance = false;
+    programHasRelease = false;
+    distanceThresholds.clear();
+    distanceInstructions.clear();
+    segmentZones.clear();
+    segmentZones.append(0);
+
+    int segmentStart = 0;
+    int segment = 0;
+    double tempDistance = 0.0;
+    QListIterator<JoyButtonSlot*> iter(assignments);
+    while (iter.hasNext())
+    {
+        JoyButtonSlot *slot = iter.next();
+        JoyButtonInstruction instruction;
+        instruction.slot = slot;
+        instruction.mode = slot->getSlotMode();
+        instruction.code = slot->getSlotCode();
+        instruction.segmentCycle = -1;
+        instruction.segment = segment;
+
+        if (instruction.mode == JoyButtonSlot::JoyCycle)
+        {
+            // Close the segment
+            for (int i = segmentStart; i < program.size(); i++)
+            {
+                program[i].segmentCycle = program.size();
+            }
+
+            instruction.segmentCycle = program.size();
+            segmentStart = program.size() + 1;
+            segment++;
+            segmentZones.append(distanceThresholds.size());
+            tempDistance = 0.0;
+        }
+        else if (instruction.mode == JoyButtonSlot::JoyPause ||
+                 instruction.mode == JoyButtonSlot::JoyHold)
+        {
+            programHasSequence = true;
+        }
+        else if (instruction.mode == JoyButtonSlot::JoyDistance)
+        {
+            programHasSequence = true;
+            programHasDistance = true;
+
+            tempDistance += instruction.code / 100.0;
+            distanceThresholds.append(tempDistance);
+            distanceInstructions.append(program.size());
+        }
+        else if (instruction.mode == JoyButtonSlot::JoyRelease)
+        {
+            programHasRelease = true;
+        }
+
+        program.append(instruction);
+    }
+
+    segmentZones.append(distanceThresholds.size());
+
+    programCounter = -1;
+    currentCycle = -1;
+    previousCycle = -1;
+    currentDistance = -1;
+}
+
 void JoyButton::setVDPad(VDPad *vdpad)
 {
     this->vdpad = vdpad;
@@ -1786,6 +1896,8 @@ bool JoyButton::isDefault()
     value = value && (toggle == false);
     value = value && (turboInterval == 0);
     value = value && (useTurbo == false);
+    value = value && (turboDutyCycle == 0);
+    value = value && (turboPhaseLock == false);
     value = value && (mouseSpeedX == 50);
     value = value && (mouseSpeedY == 50);
     value = value && (setSelection == -1);
@@ -1796,6 +1908,8 @@ bool JoyButton::isDefault()
     value = value && (springWidth == 0);
     value = value && (springHeight == 0);
     value = value && (sensitivity == 1.0);
+    value = value && (customCurvePoints.isEmpty());
+    value = value && (velocityAcceleration == false);
     return value;
 }
 
@@ -1822,6 +1936,7 @@ JoyButton::JoyMouseMovementMode JoyButton::getMouseMode()
 void JoyButton::setMouseCurve(JoyMouseCurve selectedCurve)
 {
     mouseCurve = selectedCurve;
+    buildMouseCurveTable();
 }
 
 JoyButton::JoyMouseCurve JoyButton::getMouseCurve()
@@ -1829,6 +1944,38 @@ JoyButton::JoyMouseCurve JoyButton::getMouseCurve()
     return mouseCurve;
 }
 
+/* Points are given as (distance, multiplier) pairs. Distances
+ * are limited to the range 0 - 1 and multipliers cannot be
+ * negative.
+ */
+void JoyButton::setCustomCurvePoints(QList<QPointF> points)
+{
+    QMap<double, double> temppoints;
+    QListIterator<QPointF> iter(points);
+    while (iter.hasNext())
+    {
+        QPointF temppoint = iter.next();
+        double tempx = qBound(0.0, temppoint.x(), 1.0);
+        double tempy = qMax(0.0, temppoint.y());
+        temppoints.insert(tempx, tempy);
+    }
+
+    customCurvePoints.clear();
+    QMapIterator<double, double> mapiter(temppoints);
+    while (mapiter.hasNext())
+    {
+        mapiter.next();
+        customCurvePoints.append(QPointF(mapiter.key(), mapiter.value()));
+    }
+
+    buildMouseCurveTable();
+}
+
+QList<QPointF> JoyButton::getCustomCurvePoints()
+{
+    return customCurvePoints;
+}
+
 void JoyButton::setSpringWidth(int value)
 {
     if (value >= 0)
@@ -1860,6 +2007,7 @@ void JoyButton::setSensitivity(double value)
     if (value >= 0.001 && value <= 1000)
     {
         sensitivity = value;
+        buildMouseCurveTable();
     }
 }
 
@@ -1867,3 +2015,227 @@ double JoyButton::getSensitivity()
 {
     return sensitivity;
 }
+
+void JoyButton::setVelocityAcceleration(bool enabled)
+{
+    velocityAcceleration = enabled;
+    resetVelocityBoost();
+}
+
+bool JoyButton::isVelocityAccelerationEnabled()
+{
+    return velocityAcceleration;
+}
+
+void JoyButton::setVelocityGain(double value)
+{
+    if (value >= 0.0 && value <= 100.0)
+    {
+        velocityGain = value;
+    }
+}
+
+double JoyButton::getVelocityGain()
+{
+    return velocityGain;
+}
+
+void JoyButton::setVelocityCap(double value)
+{
+    if (value >= 1.0 && value <= 100.0)
+    {
+        velocityCap = value;
+    }
+}
+
+double JoyButton::getVelocityCap()
+{
+    return velocityCap;
+}
+
+void JoyButton::setVelocityDecay(double value)
+{
+    if (value >= 0.01 && value <= 10.0)
+    {
+        velocityDecay = value;
+    }
+}
+
+double JoyButton::getVelocityDecay()
+{
+    return velocityDecay;
+}
+
+/* Set by InputDaemon around the dispatch of every controller event
+ * so the buttons that change state know when the event was read.
+ */
+void JoyButton::setInputContext(qint64 timestamp, LatencyHistogram *latency)
+{
+    currentInputTimestamp = timestamp;
+    currentInputLatency = latency;
+}
+
+/* Record the time from the controller event that caused the current
+ * state change to the first output event it produced.
+ */
+void JoyButton::recordOutputLatency()
+{
+    if (inputLatency && inputTimestamp > 0)
+    {
+        inputLatency->record(PadderCommon::getMonotonicTime() - inputTimestamp);
+        inputTimestamp = 0;
+    }
+}
+
+/* Sample the current curve when it has to be looked up on every
+ * mouse tick. The polynomial curves are cheaper to evaluate directly
+ * and the step in the extreme quadratic curve would be smoothed out
+ * by interpolation so those do not use a table. Neither do power
+ * curves with a low sensitivity since they rise too sharply near
+ * full deflection for a uniform table.
+ */
+void JoyButton::buildMouseCurveTable()
+{
+    mouseCurveTable.clear();
+
+    if ((mouseCurve == PowerCurve && sensitivity >= MOUSECURVETABLESENSITIVITY) ||
+        mouseCurve == CustomCurve)
+    {
+        mouseCurveTable.resize(MOUSECURVETABLESIZE + 1);
+        for (int i = 0; i <= MOUSECURVETABLESIZE; i++)
+        {
+            mouseCurveTable[i] = calculateMouseCurve(i / (double)MOUSECURVETABLESIZE);
+        }
+    }
+}
+
+// Evaluate the current curve for a distance between 0 and 1
+double JoyButton::calculateMouseCurve(double difference)
+{
+    double result = difference;
+
+    switch (mouseCurve)
+    {
+        case LinearCurve:
+        {
+            break;
+        }
+        case QuadraticCurve:
+        {
+            result = difference * difference;
+            break;
+        }
+        case CubicCurve:
+        {
+            result = difference * difference * difference;
+            break;
+        }
+        case QuadraticExtremeCurve:
+        {
+            result = difference * difference;
+            result = (difference >= 0.95) ? (result * 1.5) : result;
+            break;
+        }
+        case PowerCurve:
+        {
+            double tempsensitive = qMin(qMax(sensitivity, 1.0e-3), 1.0e+3);
+            result = qMin(qMax(pow(difference, 1.0 / tempsensitive), 0.0), 1.0);
+            break;
+        }
+        case CustomCurve:
+        {
+            double previousX = 0.0;
+            double previousY = 0.0;
+            bool found = false;
+
+            QListIterator<QPointF> iter(customCurvePoints);
+            while (iter.hasNext() && !found)
+            {
+                QPointF temppoint = iter.next();
+                if (difference <= temppoint.x())
+                {
+                    double span = temppoint.x() - previousX;
+                    double fraction = span > 0.0 ? (difference - previousX) / span : 1.0;
+                    result = previousY + (temppoint.y() - previousY) * fraction;
+                    found = true;
+                }
+
+                previousX = temppoint.x();
+                previousY = temppoint.y();
+            }
+
+            if (!found)
+            {
+                result = customCurvePoints.isEmpty() ? difference : previousY;
+            }
+
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+double JoyButton::getMouseCurveValue(double difference)
+{
+    double result = 0.0;
+
+    double position = qBound(0.0, difference, 1.0) * MOUSECURVETABLESIZE;
+    if (!mouseCurveTable.isEmpty() &&
+        (mouseCurve != PowerCurve || position >= MOUSECURVEEXACTSEGMENTS))
+    {
+        int tempindex = qMin((int)position, MOUSECURVETABLESIZE - 1);
+        double fraction = position - tempindex;
+        result = mouseCurveTable.at(tempindex) +
+                (mouseCurveTable.at(tempindex + 1) - mouseCurveTable.at(tempindex)) * fraction;
+    }
+    else
+    {
+        result = calculateMouseCurve(difference);
+    }
+
+    return result;
+}
+
+// Start measuring deflection changes from a centered position
+void JoyButton::resetVelocityBoost()
+{
+    velocityBoost = 0.0;
+    velocityDistance = 0.0;
+    velocityTimestamp = PadderCommon::getMonotonicTime();
+}
+
+/* Work out how fast the deflection has grown since the previous mouse
+ * tick. A fast push raises the boost right away and the boost then
+ * decays over time. Returns the multiplier to apply to cursor speed.
+ */
+double JoyButton::updateVelocityBoost(qint64 timestamp)
+{
+    double multiplier = 1.0;
+
+    if (velocityAcceleration && mouseMode == MouseCursor)
+    {
+        double distance = getDistanceFromDeadZone();
+        double elapsed = (timestamp - velocityTimestamp) / 1000000000.0;
+        if (elapsed > 0.0)
+        {
+            double rate = (distance - velocityDistance) / elapsed;
+            velocityBoost = velocityBoost * exp(-elapsed / velocityDecay);
+            if (rate > 0.0)
+            {
+                velocityBoost = qMax(velocityBoost, velocityGain * rate);
+            }
+
+            velocityDistance = distance;
+            velocityTimestamp = timestamp;
+        }
+
+        multiplier = qMin(1.0 + velocityBoost, velocityCap);
+    }
+
+    return multiplier;
+}
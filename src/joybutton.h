@@ -9,13 +9,31 @@
 #include <QHash>
 #include <QMutex>
 #include <QQueue>
+#include <QVector>
+#include <QPointF>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 
 #include "joybuttonslot.h"
+#include "latencyhistogram.h"
+#include "timerwheel.h"
 
 class VDPad;
 
+// Slot compiled into the flat program that a button executes.
+// Jump targets are indices into the program; -1 means none
+struct JoyButtonInstruction
+{
+    JoyButtonSlot *slot;
+    JoyButtonSlot::JoySlotInputAction mode;
+    int code;
+    // JoyCycle instruction that ends the cycle segment
+    int segmentCycle;
+    // Number of the cycle segment. JoyCycle belongs to the
+    // segment that it ends
+    int segment;
+};
+
 class JoyButton : public QObject
 {
     Q_OBJECT
@@ -25,7 +43,7 @@ public:
 
     enum SetChangeCondition {SetChangeDisabled=0, SetChangeOneWay, SetChangeTwoWay, SetChangeWhileHeld};
     enum JoyMouseMovementMode {MouseCursor=0, MouseSpring};
-    enum JoyMouseCurve {LinearCurve=0, QuadraticCurve, CubicCurve, QuadraticExtremeCurve, PowerCurve};
+    enum JoyMouseCurve {LinearCurve=0, QuadraticCurve, CubicCurve, QuadraticExtremeCurve, PowerCurve, CustomCurve};
 
     void joyEvent (bool pressed, bool ignoresets=false);
     int getJoyNumber ();
@@ -35,6 +53,8 @@ public:
     bool getToggleState();
     int getTurboInterval();
     bool isUsingTurbo();
+    int getTurboDutyCycle();
+    bool isTurboPhaseLocked();
     void setCustomName(QString name);
     QString getCustomName();
     void setAssignedSlot(int code, JoyButtonSlot::JoySlotInputAction mode=JoyButtonSlot::JoyKeyboard);
@@ -85,17 +105,43 @@ public:
 
     void setMouseCurve(JoyMouseCurve selectedCurve);
     JoyMouseCurve getMouseCurve();
+    void setCustomCurvePoints(QList<QPointF> points);
+    QList<QPointF> getCustomCurvePoints();
 
     int getSpringWidth();
     int getSpringHeight();
 
     double getSensitivity();
 
+    bool isVelocityAccelerationEnabled();
+    double getVelocityGain();
+    double getVelocityCap();
+    double getVelocityDecay();
+
+    static void setInputContext(qint64 timestamp, LatencyHistogram *latency);
+
     static const QString xmlName;
     static const int ENABLEDTURBODEFAULT;
+    static const int MOUSECURVETABLESIZE;
+    static const int MOUSECURVEEXACTSEGMENTS;
+    static const double MOUSECURVETABLESENSITIVITY;
+    static const int PAUSEHOLDTIME;
+    static const int TURBOPRESSTIME;
+    static const double DEFAULTVELOCITYGAIN;
+    static const double DEFAULTVELOCITYCAP;
+    static const double DEFAULTVELOCITYDECAY;
 
 protected:
+    void recordOutputLatency();
+    void buildMouseCurveTable();
+    double calculateMouseCurve(double difference);
+    double getMouseCurveValue(double difference);
+    void resetVelocityBoost();
+    double updateVelocityBoost(qint64 timestamp);
     double getTotalSlotDistance(JoyButtonSlot *slot);
+    void compileSlots();
+    void startTurbo();
+    qint64 getTurboPressTime();
     bool distanceEvent();
     void clearAssignedSlots();
     void releaseSlotEvent();
@@ -109,13 +155,20 @@ protected:
     // Used to denote the SDL index of the actual joypad button
     int index;
     int turboInterval;
-    QTimer turboTimer;
-    QTimer pauseTimer;
-    QTimer holdTimer;
-    QTimer pauseWaitTimer;
-    QTimer createDeskTimer;
-    QTimer releaseDeskTimer;
-    QTimer mouseEventTimer;
+    // Percentage of the turbo period that the slots stay pressed.
+    // 0 keeps them pressed for TURBOPRESSTIME
+    int turboDutyCycle;
+    // Align turbo cycles to multiples of the period on the monotonic
+    // clock so buttons with the same interval press in step
+    bool turboPhaseLock;
+    // Start of the current turbo cycle in nanoseconds
+    qint64 turboCycleStart;
+    WheelTimer turboTimer;
+    WheelTimer pauseTimer;
+    WheelTimer holdTimer;
+    WheelTimer pauseWaitTimer;
+    WheelTimer createDeskTimer;
+    WheelTimer releaseDeskTimer;
     bool isDown;
     bool toggleActiveState;
     bool useTurbo;
@@ -128,35 +181,73 @@ protected:
     int setSelection;
     SetChangeCondition setSelectionCondition;
     int originset;
-    QListIterator<JoyButtonSlot*> *slotiter;
+    // Assigned slots compiled by compileSlots whenever they change
+    QVector<JoyButtonInstruction> program;
+    bool programHasSequence;
+    bool programHasDistance;
+    bool programHasRelease;
+    // Cumulative distance of every JoyDistance instruction and the
+    // index of that instruction. Zones of cycle segment n are stored
+    // between segmentZones[n] and segmentZones[n+1]
+    QVector<double> distanceThresholds;
+    QVector<int> distanceInstructions;
+    QVector<int> segmentZones;
+    // Next instruction to execute. -1 until the button is first used
+    int programCounter;
     JoyButtonSlot *currentPause;
     JoyButtonSlot *currentHold;
-    JoyButtonSlot *currentCycle;
-    JoyButtonSlot *previousCycle;
-    JoyButtonSlot *currentDistance;
-    JoyButtonSlot *currentMouseEvent;
+    // Program indices of cycle and distance instructions. -1 for none
+    int currentCycle;
+    int previousCycle;
+    int currentDistance;
 
     bool ignoresets;
     QMutex buttonMutex;
-    QTime buttonHold;
-    QTime pauseHold;
-    QTime inpauseHold;
+    // Monotonic times in nanoseconds
+    qint64 buttonHoldStart;
+    qint64 pauseWaitDeadline;
     QTime buttonHeldRelease;
 
     QQueue<bool> ignoreSetQueue;
     QQueue<bool> isButtonPressedQueue;
-    QQueue<JoyButtonSlot*> mouseEventQueue;
 
     int currentRawValue;
     VDPad *vdpad;
     bool ignoreEvents;
     JoyMouseMovementMode mouseMode;
     JoyMouseCurve mouseCurve;
+    // Points of a user defined curve sorted by distance. The curve
+    // starts at the origin and stays flat after the last point
+    QList<QPointF> customCurvePoints;
+    // Samples of the current curve used by curves that are too
+    // expensive to evaluate on every mouse tick
+    QVector<double> mouseCurveTable;
 
     int springWidth;
     int springHeight;
     double sensitivity;
 
+    // Boost cursor speed while the deflection is increasing quickly.
+    // Gain converts deflection change per second into extra speed,
+    // cap is the largest total multiplier and decay is the time
+    // constant in seconds that the boost falls off with
+    bool velocityAcceleration;
+    double velocityGain;
+    double velocityCap;
+    double velocityDecay;
+    double velocityBoost;
+    double velocityDistance;
+    qint64 velocityTimestamp;
+
+    // Monotonic time of the controller event that caused the last
+    // state change and the histogram its output latency goes into
+    qint64 inputTimestamp;
+    LatencyHistogram *inputLatency;
+
+    // Controller event currently being dispatched by InputDaemon
+    static qint64 currentInputTimestamp;
+    static LatencyHistogram *currentInputLatency;
+
 signals:
     void clicked (int index);
     void released (int index);
@@ -172,6 +263,8 @@ signals:
 
 public slots:
     void setTurboInterval (int interval);
+    void setTurboDutyCycle(int value);
+    void setTurboPhaseLock(bool enabled);
     void setToggle (bool toggle);
     void setUseTurbo(bool useTurbo);
     void setMouseSpeedX(int speed);
@@ -182,14 +275,20 @@ public slots:
 
     void setSensitivity(double value);
 
+    void setVelocityAcceleration(bool enabled);
+    void setVelocityGain(double value);
+    void setVelocityCap(double value);
+    void setVelocityDecay(double value);
+
     virtual void reset();
     virtual void reset(int index);
 
     virtual void clearSlotsEventReset();
 
+    virtual void mouseEvent();
+
 private slots:
     void turboEvent();
-    virtual void mouseEvent();
     void createDeskEvent();
     void releaseDeskEvent(bool skipsetchange=false);
     void releaseActiveSlots();
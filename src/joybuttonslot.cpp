@@ -1,5 +1,6 @@
 #include "joybuttonslot.h"
 #include "event.h"
+#include "common.h"
 
 const int JoyButtonSlot::JOYSPEED = 20;
 const QString JoyButtonSlot::xmlName = "slot";
@@ -11,7 +12,7 @@ JoyButtonSlot::JoyButtonSlot(QObject *parent) :
     deviceCode = 0;
     mode = JoyKeyboard;
     distance = 0.0;
-    mouseInterval = new QTime();
+    mouseIntervalStart = 0;
 }
 
 JoyButtonSlot::JoyButtonSlot(int code, JoySlotInputAction mode, QObject *parent) :
@@ -26,12 +27,11 @@ JoyButtonSlot::JoyButtonSlot(int code, JoySlotInputAction mode, QObject *parent)
 
     this->mode = mode;
     distance = 0.0;
-    mouseInterval = new QTime();
+    mouseIntervalStart = 0;
 }
 
 JoyButtonSlot::~JoyButtonSlot()
 {
-    delete mouseInterval;
 }
 
 void JoyButtonSlot::setSlotCode(int code)
@@ -92,14 +92,19 @@ double JoyButtonSlot::getMouseDistance()
     return distance;
 }
 
-QTime* JoyButtonSlot::getMouseInterval()
+qint64 JoyButtonSlot::getMouseIntervalStart()
 {
-    return mouseInterval;
+    return mouseIntervalStart;
+}
+
+void JoyButtonSlot::setMouseIntervalStart(qint64 timestamp)
+{
+    mouseIntervalStart = timestamp;
 }
 
 void JoyButtonSlot::restartMouseInterval()
 {
-    mouseInterval->restart();
+    mouseIntervalStart = PadderCommon::getMonotonicTime();
 }
 
 void JoyButtonSlot::readConfig(QXmlStreamReader *xml)
@@ -2,7 +2,6 @@
 #define JOYBUTTONSLOT_H
 
 #include <QObject>
-#include <QTime>
 #include <QMetaType>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
@@ -26,7 +25,8 @@ public:
     void setMouseSpeed(int value);
     void setDistance(double distance);
     double getMouseDistance();
-    QTime* getMouseInterval();
+    qint64 getMouseIntervalStart();
+    void setMouseIntervalStart(qint64 timestamp);
     void restartMouseInterval();
     QString getXmlName();
     QString getSlotString();
@@ -41,7 +41,9 @@ protected:
     int deviceCode;
     JoySlotInputAction mode;
     double distance;
-    QTime *mouseInterval;
+    // Monotonic time in nanoseconds that mouse movement
+    // was last integrated up to
+    qint64 mouseIntervalStart;
 
 signals:
     
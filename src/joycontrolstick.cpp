@@ -6,6 +6,7 @@
 #include "joycontrolstick.h"
 
 const double JoyControlStick::PI = acos(-1.0);
+const int JoyControlStick::ZONESCALE = 1 << 16;
 
 JoyControlStick::JoyControlStick(JoyAxis *axis1, JoyAxis *axis2, int index, int originset, QObject *parent) :
     QObject(parent)
@@ -32,7 +33,23 @@ JoyControlStick::~JoyControlStick()
 
 void JoyControlStick::joyEvent(bool ignoresets)
 {
-    safezone = !inDeadZone();
+    invalidateSnapshot();
+
+    bool unfilteredSafeZone = !inDeadZone();
+    safezone = unfilteredSafeZone;
+
+    // Stay active until the stick is clearly back inside the dead zone
+    if (isActive && !safezone && deadZoneHysteresis > 0 &&
+        !isWithinDeadZone(qMax(0, deadZone - deadZoneHysteresis)))
+    {
+        safezone = true;
+    }
+
+    if (unfilteredSafeZone != previousUnfilteredSafeZone && safezone == isActive)
+    {
+        avoidedDeadZoneChanges++;
+    }
+    previousUnfilteredSafeZone = unfilteredSafeZone;
 
     if (safezone && !isActive)
     {
@@ -44,6 +61,7 @@ void JoyControlStick::joyEvent(bool ignoresets)
     {
         isActive = false;
         currentDirection = StickCentered;
+        unfilteredDirection = StickCentered;
         emit released(axisX->getCurrentRawValue(), axisY->getCurrentRawValue());
 
         createDeskEvent(ignoresets);
@@ -57,13 +75,102 @@ void JoyControlStick::joyEvent(bool ignoresets)
 }
 
 bool JoyControlStick::inDeadZone()
+{
+    return isWithinDeadZone(deadZone);
+}
+
+bool JoyControlStick::isWithinRadius(int radius)
 {
     int axis1Value = axisX->getCurrentRawValue();
     int axis2Value = axisY->getCurrentRawValue();
 
     unsigned int squareDist = (unsigned int)(axis1Value*axis1Value) + (unsigned int)(axis2Value*axis2Value);
 
-    return squareDist <= (unsigned int)(deadZone*deadZone);
+    return squareDist <= (unsigned int)(radius*radius);
+}
+
+/* Check the stick position against a dead zone of the passed size
+ * using the shape of the selected dead zone type.
+ */
+bool JoyControlStick::isWithinDeadZone(int radius)
+{
+    bool result = false;
+
+    if (deadZoneType == AxialDeadZone)
+    {
+        result = abs(axisX->getCurrentRawValue()) <= radius &&
+                 abs(axisY->getCurrentRawValue()) <= radius;
+    }
+    else if (deadZoneType == SquareToCircleDeadZone)
+    {
+        int axis1Value = axisX->getCurrentRawValue();
+        int axis2Value = axisY->getCurrentRawValue();
+        mapSquareToCircle(axis1Value, axis2Value);
+
+        unsigned int squareDist = (unsigned int)(axis1Value*axis1Value) + (unsigned int)(axis2Value*axis2Value);
+        result = squareDist <= (unsigned int)(radius*radius);
+    }
+    else
+    {
+        result = isWithinRadius(radius);
+    }
+
+    return result;
+}
+
+/* Map a position from the square gate of a stick onto a circle
+ * so that the corners of the gate end up at the max zone.
+ */
+void JoyControlStick::mapSquareToCircle(int &xvalue, int &yvalue)
+{
+    double tempx = qBound(-1.0, xvalue / (double)maxZone, 1.0);
+    double tempy = qBound(-1.0, yvalue / (double)maxZone, 1.0);
+
+    double circleX = tempx * sqrt(1.0 - (tempy * tempy) / 2.0);
+    double circleY = tempy * sqrt(1.0 - (tempx * tempx) / 2.0);
+
+    xvalue = (int)round(circleX * maxZone);
+    yvalue = (int)round(circleY * maxZone);
+}
+
+/* Output of the non radial dead zone types. Each axis value is in
+ * the range [-1.0, 1.0] with the dead zone already removed.
+ */
+void JoyControlStick::calculateDeadZoneOutput(int xvalue, int yvalue, double &outputX, double &outputY)
+{
+    outputX = 0.0;
+    outputY = 0.0;
+
+    double zoneRange = (double)(maxZone - deadZone);
+
+    if (deadZoneType == SquareToCircleDeadZone)
+    {
+        mapSquareToCircle(xvalue, yvalue);
+    }
+
+    unsigned int square_dist = (unsigned int)(xvalue*xvalue) + (unsigned int)(yvalue*yvalue);
+    double length = sqrt(square_dist);
+
+    if (deadZoneType == ScaledRadialDeadZone || deadZoneType == SquareToCircleDeadZone)
+    {
+        // Rescale the radius past the dead zone and keep the bearing
+        if (length > deadZone)
+        {
+            double scale = qBound(0.0, (length - deadZone) / zoneRange, 1.0) / length;
+            outputX = xvalue * scale;
+            outputY = yvalue * scale;
+        }
+    }
+    else if (deadZoneType == AxialDeadZone ||
+             (deadZoneType == HybridDeadZone && length > deadZone))
+    {
+        // Hybrid uses the radial dead zone to activate the stick
+        // and removes the dead zone from each axis on its own
+        double tempx = qBound(0.0, (abs(xvalue) - deadZone) / zoneRange, 1.0);
+        double tempy = qBound(0.0, (abs(yvalue) - deadZone) / zoneRange, 1.0);
+        outputX = xvalue < 0 ? -tempx : tempx;
+        outputY = yvalue < 0 ? -tempy : tempy;
+    }
 }
 
 void JoyControlStick::populateButtons()
@@ -111,28 +218,34 @@ void JoyControlStick::createDeskEvent(bool ignoresets)
 
     if (safezone)
     {
-        double bearing = calculateBearing();
+        int xvalue = axisX->getCurrentRawValue();
+        int yvalue = axisY->getCurrentRawValue();
+        JoyStickDirections direction = calculateStickDirection(xvalue, yvalue);
+        JoyStickDirections heldDirection = direction;
+
+        // Keep the current direction while the bearing is still
+        // within the hysteresis band around its zone
+        if (directionHysteresis > 0 && currentDirection != StickCentered &&
+            direction != currentDirection &&
+            isInZone(hysteresisZones[currentDirection - 1], xvalue, yvalue))
+        {
+            heldDirection = currentDirection;
+        }
+
+        if (direction != unfilteredDirection && heldDirection == currentDirection)
+        {
+            avoidedDirectionChanges++;
+        }
 
-        QList<int> anglesList = getDiagonalZoneAngles();
-        int initialLeft = anglesList.value(0);
-        int initialRight = anglesList.value(1);
-        int upRightInitial = anglesList.value(2);
-        int rightInitial = anglesList.value(3);
-        int downRightInitial = anglesList.value(4);
-        int downInitial = anglesList.value(5);
-        int downLeftInitial = anglesList.value(6);
-        int leftInitial = anglesList.value(7);
-        int upLeftInitial = anglesList.value(8);
+        unfilteredDirection = direction;
+        currentDirection = heldDirection;
 
-        bearing = round(bearing);
-        if (bearing <= initialRight || bearing >= initialLeft)
+        if (currentDirection == StickUp)
         {
-            currentDirection = StickUp;
             eventbutton2 = buttons.value(StickUp);
         }
-        else if (bearing >= upRightInitial && bearing < rightInitial)
+        else if (currentDirection == StickRightUp)
         {
-            currentDirection = StickRightUp;
             if (currentMode == EightWayMode && buttons.contains(StickRightUp))
             {
                 eventbutton3 = buttons.value(StickRightUp);
@@ -143,14 +256,12 @@ void JoyControlStick::createDeskEvent(bool ignoresets)
                 eventbutton2 = buttons.value(StickUp);
             }
         }
-        else if (bearing >= rightInitial && bearing < downRightInitial)
+        else if (currentDirection == StickRight)
         {
-            currentDirection = StickRight;
             eventbutton1 = buttons.value(StickRight);
         }
-        else if (bearing >= downRightInitial && bearing < downInitial)
+        else if (currentDirection == StickRightDown)
         {
-            currentDirection = StickRightDown;
             if (currentMode == EightWayMode && buttons.contains(StickRightDown))
             {
                 eventbutton3 = buttons.value(StickRightDown);
@@ -161,14 +272,12 @@ void JoyControlStick::createDeskEvent(bool ignoresets)
                 eventbutton2 = buttons.value(StickDown);
             }
         }
-        else if (bearing >= downInitial && bearing < downLeftInitial)
+        else if (currentDirection == StickDown)
         {
-            currentDirection = StickDown;
             eventbutton2 = buttons.value(StickDown);
         }
-        else if (bearing >= downLeftInitial && bearing < leftInitial)
+        else if (currentDirection == StickLeftDown)
         {
-            currentDirection = StickLeftDown;
             if (currentMode == EightWayMode && buttons.contains(StickLeftDown))
             {
                 eventbutton3 = buttons.value(StickLeftDown);
@@ -179,14 +288,12 @@ void JoyControlStick::createDeskEvent(bool ignoresets)
                 eventbutton2 = buttons.value(StickDown);
             }
         }
-        else if (bearing >= leftInitial && bearing < upLeftInitial)
+        else if (currentDirection == StickLeft)
         {
-            currentDirection = StickLeft;
             eventbutton1 = buttons.value(StickLeft);
         }
-        else if (bearing >= upLeftInitial && bearing < initialLeft)
+        else if (currentDirection == StickLeftUp)
         {
-            currentDirection = StickLeftUp;
             if (currentMode == EightWayMode && buttons.contains(StickLeftUp))
             {
                 eventbutton3 = buttons.value(StickLeftUp);
@@ -215,44 +322,105 @@ void JoyControlStick::createDeskEvent(bool ignoresets)
     }
 }
 
-double JoyControlStick::calculateBearing()
+/* Find the direction zone that the stick position falls in. The
+ * result matches rounding calculateBearing() and comparing it against
+ * getDiagonalZoneAngles() but only needs integer math.
+ */
+JoyControlStick::JoyStickDirections JoyControlStick::calculateStickDirection(int xvalue, int yvalue)
 {
-    double finalAngle = 0.0;
+    JoyStickDirections direction = StickUp;
 
-    if (axisX->getCurrentRawValue() == 0 && axisY->getCurrentRawValue() == 0)
+    if (xvalue != 0 || yvalue != 0)
     {
-        finalAngle = 0.0;
+        bool found = false;
+        for (int i=0; i < 8 && !found; i++)
+        {
+            if (isInZone(directionZones[i], xvalue, yvalue))
+            {
+                direction = (JoyStickDirections)(i + 1);
+                found = true;
+            }
+        }
     }
-    else
+
+    return direction;
+}
+
+/* Zones are narrower than 180 degrees so a position is inside a
+ * zone when it is clockwise of the start edge and counterclockwise
+ * of the end edge. Both checks are the sign of a cross product.
+ */
+bool JoyControlStick::isInZone(const StickZone &zone, int xvalue, int yvalue)
+{
+    // Bearings are measured clockwise from up and SDL reports
+    // positive y values for down
+    qint64 tempx = xvalue;
+    qint64 tempy = -yvalue;
+
+    bool afterStart = (zone.startCos * tempx - zone.startSin * tempy) >= 0;
+    bool beforeEnd = (zone.endCos * tempx - zone.endSin * tempy) < 0;
+
+    return afterStart && beforeEnd;
+}
+
+/* Called whenever the diagonal range or the direction hysteresis
+ * changes. A rounded bearing is at least an integer boundary once
+ * the exact bearing is half a degree below it, so the edges sit half
+ * a degree before each boundary from getDiagonalZoneAngles().
+ */
+void JoyControlStick::refreshZones()
+{
+    int cardinalAngle = (360 - (diagonalRange * 4)) / 4;
+
+    int initialLeft = 360 - (int)((cardinalAngle - 1) / 2);
+    int initialRight = (int)((cardinalAngle - 1)/ 2);
+    if ((cardinalAngle - 1) % 2 != 0)
     {
-        double temp1 = axisX->getCurrentRawValue() / (double)maxZone;
-        double temp2 = axisY->getCurrentRawValue() / (double)maxZone;
+        initialLeft = 360 - (cardinalAngle / 2);
+        initialRight = (cardinalAngle / 2) - 1;
+    }
 
-        double angle = (atan2(temp1, -temp2) * 180) / PI;
+    zoneAngles[0] = initialLeft;
+    zoneAngles[1] = initialRight;
+    zoneAngles[2] = initialRight + 1;
+    zoneAngles[3] = zoneAngles[2] + diagonalRange;
+    zoneAngles[4] = zoneAngles[3] + cardinalAngle;
+    zoneAngles[5] = zoneAngles[4] + diagonalRange;
+    zoneAngles[6] = zoneAngles[5] + cardinalAngle;
+    zoneAngles[7] = zoneAngles[6] + diagonalRange;
+    zoneAngles[8] = zoneAngles[7] + cardinalAngle;
 
-        if (axisX->getCurrentRawValue() >= 0 && axisY->getCurrentRawValue() <= 0)
-        {
-            // NE Quadrant
-            finalAngle = angle;
-        }
-        else if (axisX->getCurrentRawValue() >= 0 && axisY->getCurrentRawValue() >= 0)
-        {
-            // SE Quadrant (angle will be positive)
-            finalAngle = angle;
-        }
-        else if (axisX->getCurrentRawValue() <= 0 && axisY->getCurrentRawValue() >= 0)
-        {
-            // SW Quadrant (angle will be negative)
-            finalAngle = 360.0 + angle;
-        }
-        else if (axisX->getCurrentRawValue() <= 0 && axisY->getCurrentRawValue() <= 0)
-        {
-            // NW Quadrant (angle will be negative)
-            finalAngle = 360.0 + angle;
-        }
+    // Start of the zone of each direction from StickUp going clockwise
+    double edges[9];
+    edges[0] = initialLeft - 0.5;
+    for (int i=1; i < 8; i++)
+    {
+        edges[i] = zoneAngles[i + 1] - 0.5;
     }
+    edges[8] = edges[0];
 
-    return finalAngle;
+    for (int i=0; i < 8; i++)
+    {
+        setZoneEdges(directionZones[i], edges[i], edges[i + 1]);
+        setZoneEdges(hysteresisZones[i], edges[i] - directionHysteresis,
+                     edges[i + 1] + directionHysteresis);
+    }
+}
+
+void JoyControlStick::setZoneEdges(StickZone &zone, double startAngle, double endAngle)
+{
+    double startRadians = startAngle * PI / 180.0;
+    double endRadians = endAngle * PI / 180.0;
+
+    zone.startCos = (qint64)floor(cos(startRadians) * ZONESCALE + 0.5);
+    zone.startSin = (qint64)floor(sin(startRadians) * ZONESCALE + 0.5);
+    zone.endCos = (qint64)floor(cos(endRadians) * ZONESCALE + 0.5);
+    zone.endSin = (qint64)floor(sin(endRadians) * ZONESCALE + 0.5);
+}
+
+double JoyControlStick::calculateBearing()
+{
+    return getSnapshot().bearing;
 }
 
 void JoyControlStick::changeButtonEvent(JoyControlStickButton *eventbutton, JoyControlStickButton *&activebutton, bool ignoresets)
@@ -288,120 +456,27 @@ void JoyControlStick::changeButtonEvent(JoyControlStickButton *eventbutton, JoyC
 
 double JoyControlStick::getDistanceFromDeadZone()
 {
-    double distance = 0.0;
-
-    int axis1Value = axisX->getCurrentRawValue();
-    int axis2Value = axisY->getCurrentRawValue();
-
-    unsigned int square_dist = (unsigned int)(axis1Value*axis1Value) + (unsigned int)(axis2Value*axis2Value);
-
-    distance = (sqrt(square_dist) - deadZone)/(double)(maxZone - deadZone);
-    if (distance > 1.0)
-    {
-        distance = 1.0;
-    }
-    else if (distance < 0.0)
-    {
-        distance = 0.0;
-    }
-
-    return distance;
+    return getSnapshot().deadZoneDistance;
 }
 
 double JoyControlStick::calculateXDistanceFromDeadZone()
 {
-    double distance = 0.0;
-
-    int axis1Value = axisX->getCurrentRawValue();
-
-    double relativeAngle = calculateBearing();
-    if (relativeAngle > 180)
-    {
-        relativeAngle = relativeAngle - 180;
-    }
-
-    int deadX = (int)round(deadZone * sin(relativeAngle * PI / 180.0));
-    distance = (abs(axis1Value) - deadX)/(double)(maxZone - deadX);
-    if (distance > 1.0)
-    {
-        distance = 1.0;
-    }
-    else if (distance < 0.0)
-    {
-        distance = 0.0;
-    }
-
-    return distance;
+    return getSnapshot().xDeadZoneDistance;
 }
 
 double JoyControlStick::calculateYDistanceFromDeadZone()
 {
-    double distance = 0.0;
-
-    int axis2Value = axisY->getCurrentRawValue();
-
-    double relativeAngle = calculateBearing();
-    if (relativeAngle > 180)
-    {
-        relativeAngle = relativeAngle - 180;
-    }
-
-    int deadY = abs(round(deadZone * cos(relativeAngle * PI / 180.0)));
-    distance = (abs(axis2Value) - deadY)/(double)(maxZone - deadY);
-    if (distance > 1.0)
-    {
-        distance = 1.0;
-    }
-    else if (distance < 0.0)
-    {
-        distance = 0.0;
-    }
-
-    return distance;
+    return getSnapshot().yDeadZoneDistance;
 }
 
 double JoyControlStick::getAbsoluteDistance()
 {
-    double distance = 0.0;
-
-    int axis1Value = axisX->getCurrentRawValue();
-    int axis2Value = axisY->getCurrentRawValue();
-
-    unsigned int square_dist = (unsigned int)(axis1Value*axis1Value) + (unsigned int)(axis2Value*axis2Value);
-
-    distance = sqrt(square_dist);
-    if (distance > JoyAxis::AXISMAX)
-    {
-        distance = JoyAxis::AXISMAX;
-    }
-    else if (distance < 0.0)
-    {
-        distance = 0.0;
-    }
-
-    return distance;
+    return getSnapshot().radius;
 }
 
 double JoyControlStick::getNormalizedAbsoluteDistance()
 {
-    double distance = 0.0;
-
-    int axis1Value = axisX->getCurrentRawValue();
-    int axis2Value = axisY->getCurrentRawValue();
-
-    unsigned int square_dist = (unsigned int)(axis1Value*axis1Value) + (unsigned int)(axis2Value*axis2Value);
-
-    distance = sqrt(square_dist)/(double)(maxZone);
-    if (distance > 1.0)
-    {
-        distance = 1.0;
-    }
-    else if (distance < 0.0)
-    {
-        distance = 0.0;
-    }
-
-    return distance;
+    return getSnapshot().normalizedRadius;
 }
 
 void JoyControlStick::setIndex(int index)
@@ -494,6 +569,16 @@ void JoyControlStick::reset()
     safezone = false;
     currentDirection = StickCentered;
     currentMode = StandardMode;
+    deadZoneType = RadialDeadZone;
+    deadZoneHysteresis = 0;
+    directionHysteresis = 0;
+    refreshZones();
+    unfilteredDirection = StickCentered;
+    previousUnfilteredSafeZone = false;
+    avoidedDeadZoneChanges = 0;
+    avoidedDirectionChanges = 0;
+    snapshot.version = 0;
+    stateVersion = 1;
     resetButtons();
 }
 
@@ -508,6 +593,7 @@ void JoyControlStick::setDeadZone(int value)
     if (value != deadZone && value < maxZone)
     {
         deadZone = value;
+        invalidateSnapshot();
         emit deadZoneChanged(value);
     }
 }
@@ -523,6 +609,7 @@ void JoyControlStick::setMaxZone(int value)
     if (value != maxZone && value > deadZone)
     {
         maxZone = value;
+        invalidateSnapshot();
         emit maxZoneChanged(value);
     }
 }
@@ -541,10 +628,56 @@ void JoyControlStick::setDiagonalRange(int value)
     if (value != diagonalRange)
     {
         diagonalRange = value;
+        refreshZones();
         emit diagonalRangeChanged(value);
     }
 }
 
+void JoyControlStick::setDeadZoneType(DeadZoneType type)
+{
+    if (type != deadZoneType)
+    {
+        deadZoneType = type;
+        invalidateSnapshot();
+    }
+}
+
+JoyControlStick::DeadZoneType JoyControlStick::getDeadZoneType()
+{
+    return deadZoneType;
+}
+
+void JoyControlStick::setDeadZoneHysteresis(int value)
+{
+    deadZoneHysteresis = qBound(0, abs(value), JoyAxis::AXISMAX);
+}
+
+int JoyControlStick::getDeadZoneHysteresis()
+{
+    return deadZoneHysteresis;
+}
+
+void JoyControlStick::setDirectionHysteresis(int value)
+{
+    directionHysteresis = qBound(0, value, 45);
+    refreshZones();
+}
+
+int JoyControlStick::getDirectionHysteresis()
+{
+    return directionHysteresis;
+}
+
+int JoyControlStick::getAvoidedDeadZoneChanges()
+{
+    return avoidedDeadZoneChanges;
+}
+
+int JoyControlStick::getAvoidedDirectionChanges()
+{
+    return avoidedDirectionChanges;
+}
+
 void JoyControlStick::refreshButtons()
 {
     deleteButtons();
@@ -601,6 +734,38 @@ void JoyControlStick::readConfig(QXmlStreamReader *xml)
                     this->setJoyMode(EightWayMode);
                 }
             }
+            else if (xml->name() == "deadZoneType" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                if (temptext == "scaled-radial")
+                {
+                    this->setDeadZoneType(ScaledRadialDeadZone);
+                }
+                else if (temptext == "axial")
+                {
+                    this->setDeadZoneType(AxialDeadZone);
+                }
+                else if (temptext == "hybrid")
+                {
+                    this->setDeadZoneType(HybridDeadZone);
+                }
+                else if (temptext == "square-to-circle")
+                {
+                    this->setDeadZoneType(SquareToCircleDeadZone);
+                }
+            }
+            else if (xml->name() == "deadZoneHysteresis" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                int tempchoice = temptext.toInt();
+                this->setDeadZoneHysteresis(tempchoice);
+            }
+            else if (xml->name() == "directionHysteresis" && xml->isStartElement())
+            {
+                QString temptext = xml->readElementText();
+                int tempchoice = temptext.toInt();
+                this->setDirectionHysteresis(tempchoice);
+            }
             else if (xml->name() == JoyControlStickButton::xmlName && xml->isStartElement())
             {
                 int index = xml->attributes().value("index").toString().toInt();
@@ -638,6 +803,33 @@ void JoyControlStick::writeConfig(QXmlStreamWriter *xml)
             xml->writeTextElement("mode", "eight-way");
         }
 
+        if (deadZoneType == ScaledRadialDeadZone)
+        {
+            xml->writeTextElement("deadZoneType", "scaled-radial");
+        }
+        else if (deadZoneType == AxialDeadZone)
+        {
+            xml->writeTextElement("deadZoneType", "axial");
+        }
+        else if (deadZoneType == HybridDeadZone)
+        {
+            xml->writeTextElement("deadZoneType", "hybrid");
+        }
+        else if (deadZoneType == SquareToCircleDeadZone)
+        {
+            xml->writeTextElement("deadZoneType", "square-to-circle");
+        }
+
+        if (deadZoneHysteresis > 0)
+        {
+            xml->writeTextElement("deadZoneHysteresis", QString::number(deadZoneHysteresis));
+        }
+
+        if (directionHysteresis > 0)
+        {
+            xml->writeTextElement("directionHysteresis", QString::number(directionHysteresis));
+        }
+
         QHashIterator<JoyStickDirections, JoyControlStickButton*> iter(buttons);
         while (iter.hasNext())
         {
@@ -680,119 +872,12 @@ double JoyControlStick::calculateNormalizedAxis2Placement()
 
 double JoyControlStick::calculateSquareAxisXDistanceFromDeadZone()
 {
-    double distance = 0.0;
-
-    int axis1Value = axisX->getCurrentRawValue();
-    int axis2Value = axisY->getCurrentRawValue();
-    int absX = abs(axis1Value);
-    int absY = abs(axis2Value);
-
-    unsigned int axis1Square = axis1Value * axis1Value;
-    unsigned int axis2Square = axis2Value * axis2Value;
-    unsigned int square_dist = (unsigned int)axis1Square + (unsigned int)axis2Square;
-
-    double relativeAngle = calculateBearing();
-    if (relativeAngle > 180)
-    {
-        relativeAngle = relativeAngle - 180;
-    }
-
-    int deadX = (int)round(deadZone * sin(relativeAngle * PI / 180.0));
-    int maxZoneX = (int)round(maxZone * sin(relativeAngle * PI / 180.0));
-    double dirLen = qMin(sqrt(square_dist) * 1.25, JoyAxis::AXISMAX * 1.0);
-    int scale = qMax(1, absX > absY ? absX : absY);
-    //int squareX = (axis1Value * dirLen)/scale;
-    /*int squareX = 0;
-    if (abs(axis1Value) < abs(axis2Value))
-    {
-        squareX = (axis2Value < 0) ? -axis1Value/axis2Value : axis1Value/axis2Value;
-    }
-    else
-    {
-        squareX = (axis1Value < 0) ? -square_dist : square_dist;
-    }*/
-    //int deadY = abs(round(deadZone * cos(relativeAngle * PI / 180.0)));
-    //int squareX = sqrt(square_dist/(double)qMax(axis1Square, axis2Square)) * abs(axis1Value);
-    //double shitfuck = sqrt(square_dist/(double)qMax(axis1Square, axis2Square));
-
-    //int squareY = sqrt(square_dist/qMax(axis1Square, axis2Square)) * axis2Value;
-    double factor = JoyAxis::AXISMAX/(qMin(22000.0, (double)maxZone));
-    //distance = ((abs(axis1Value) - deadX)/(double)(maxZone - deadX))*1.5;
-    distance = ((abs(axis1Value) - deadX)/(double)(maxZone - deadX));
-    if (distance > 1.0)
-    {
-        distance = 1.0;
-    }
-    else if (distance < 0.0)
-    {
-        distance = 0.0;
-    }
-
-    //distance *= 0.5;
-
-    return distance;
+    return getSnapshot().xDeadZoneDistance;
 }
 
 double JoyControlStick::calculateSquareAxisYDistanceFromDeadZone()
 {
-    double distance = 0.0;
-
-    int axis1Value = axisX->getCurrentRawValue();
-    int axis2Value = axisY->getCurrentRawValue();
-    int absX = abs(axis1Value);
-    int absY = abs(axis2Value);
-
-    unsigned int axis1Square = axis1Value * axis1Value;
-    unsigned int axis2Square = axis2Value * axis2Value;
-    unsigned int square_dist = (unsigned int)axis1Square + (unsigned int)axis2Square;
-
-    double relativeAngle = calculateBearing();
-    if (relativeAngle > 180)
-    {
-        relativeAngle = relativeAngle - 180;
-    }
-
-    int maxZoneX = abs(round(maxZone * sin(relativeAngle * PI / 180.0)));
-    //int deadX = (int)round(deadZone * sin(relativeAngle * PI / 180.0));
-    int deadY = abs(round(deadZone * cos((relativeAngle * PI) / 180.0)));
-    double dudebro = cos((relativeAngle * PI) / 180.0);
-    int maxZoneY = abs(round(maxZone * cos((relativeAngle * PI) / 180.0)));
-    double dirLen = qMin(sqrt(square_dist) * 1.25, JoyAxis::AXISMAX * 1.0);
-    int scale = qMax(1, absX > absY ? absX : absY);
-    int squareY = (axis2Value * dirLen)/scale;
-    //int squareY = 0;
-    /*if (abs(axis1Value) < abs(axis2Value))
-    {
-        squareY = (axis2Value < 0) ? -square_dist : square_dist;
-    }
-    else
-    {
-        squareY = (axis1Value < 0) ? -axis2Value/axis1Value : axis2Value/axis1Value;
-    }*/
-    //int squareX = sqrt(square_dist/qMax(axis1Square, axis2Square)) * axis1Value;
-    //int squareY = sqrt(square_dist/(double)qMax(axis1Square, axis2Square)) * abs(axis2Value);
-    double factor = JoyAxis::AXISMAX/(qMin(22000.0, (double)maxZone));
-    //distance = ((abs(axis2Value) - deadY)/(double)(maxZone - deadY))*1.5;
-    distance = (abs(axis2Value) - deadY)/(double)(maxZone - deadY);
-    /*if (abs(axis2Value) > maxZoneY)
-    {
-        qDebug() << "SQUEALING PIGS";
-    }
-    */
-
-    if (distance > 1.0)
-    {
-        distance = 1.0;
-    }
-    else if (distance < 0.0)
-    {
-        distance = 0.0;
-    }
-
-    //distance *= 0.5;
-
-
-    return distance;
+    return getSnapshot().yDeadZoneDistance;
 }
 
 double JoyControlStick::getSquareDistance()
@@ -852,17 +937,7 @@ double JoyControlStick::calculateDirectionalDistance(JoyControlStickButton *butt
         }
         else if (activeButton3 && activeButton3 == button)
         {
-            double radius = getDistanceFromDeadZone();
-            double bearing = calculateBearing();
-            int relativeBearing = (int)round(bearing) % 90;
-            //bearing = round(bearing) % 90;
-            int diagonalAngle = relativeBearing;
-            if (relativeBearing > 45)
-            {
-                diagonalAngle = 90 - relativeBearing;
-            }
-
-            finalDistance = radius * (diagonalAngle / 45.0);
+            finalDistance = getSnapshot().diagonalDistance;
         }
     }
     else if (currentDirection == StickRight)
@@ -902,17 +977,7 @@ double JoyControlStick::calculateDirectionalDistance(JoyControlStickButton *butt
         }
         else if (activeButton3 && activeButton3 == button)
         {
-            double radius = getDistanceFromDeadZone();
-            double bearing = calculateBearing();
-            int relativeBearing = (int)round(bearing) % 90;
-            //bearing = round(bearing) % 90;
-            int diagonalAngle = relativeBearing;
-            if (relativeBearing > 45)
-            {
-                diagonalAngle = 90 - relativeBearing;
-            }
-
-            finalDistance = radius * (diagonalAngle / 45.0);
+            finalDistance = getSnapshot().diagonalDistance;
         }
     }
     else if (currentDirection == StickDown)
@@ -952,17 +1017,7 @@ double JoyControlStick::calculateDirectionalDistance(JoyControlStickButton *butt
         }
         else if (activeButton3 && activeButton3 == button)
         {
-            double radius = getDistanceFromDeadZone();
-            double bearing = calculateBearing();
-            int relativeBearing = (int)round(bearing) % 90;
-            //bearing = round(bearing) % 90;
-            int diagonalAngle = relativeBearing;
-            if (relativeBearing > 45)
-            {
-                diagonalAngle = 90 - relativeBearing;
-            }
-
-            finalDistance = radius * (diagonalAngle / 45.0);
+            finalDistance = getSnapshot().diagonalDistance;
         }
     }
     else if (currentDirection == StickLeft)
@@ -1002,23 +1057,105 @@ double JoyControlStick::calculateDirectionalDistance(JoyControlStickButton *butt
         }
         else if (activeButton3 && activeButton3 == button)
         {
-            double radius = getDistanceFromDeadZone();
-            double bearing = calculateBearing();
-            int relativeBearing = (int)round(bearing) % 90;
-            //bearing = round(bearing) % 90;
-            int diagonalAngle = relativeBearing;
-            if (relativeBearing > 45)
-            {
-                diagonalAngle = 90 - relativeBearing;
-            }
-
-            finalDistance = radius * (diagonalAngle / 45.0);
+            finalDistance = getSnapshot().diagonalDistance;
         }
     }
 
     return finalDistance;
 }
 
+/* Return the values derived from the current stick position.
+ * The snapshot is rebuilt when the state version changed or when
+ * an axis was moved before the stick received its event.
+ */
+const StickSnapshot& JoyControlStick::getSnapshot()
+{
+    if (snapshot.version != stateVersion ||
+        snapshot.xvalue != axisX->getCurrentRawValue() ||
+        snapshot.yvalue != axisY->getCurrentRawValue())
+    {
+        buildSnapshot();
+    }
+
+    return snapshot;
+}
+
+void JoyControlStick::invalidateSnapshot()
+{
+    stateVersion++;
+    if (stateVersion == snapshot.version)
+    {
+        stateVersion++;
+    }
+}
+
+void JoyControlStick::buildSnapshot()
+{
+    int axis1Value = axisX->getCurrentRawValue();
+    int axis2Value = axisY->getCurrentRawValue();
+
+    snapshot.version = stateVersion;
+    snapshot.xvalue = axis1Value;
+    snapshot.yvalue = axis2Value;
+    snapshot.normalizedX = qBound(-1.0, axis1Value / (double)maxZone, 1.0);
+    snapshot.normalizedY = qBound(-1.0, axis2Value / (double)maxZone, 1.0);
+
+    unsigned int square_dist = (unsigned int)(axis1Value*axis1Value) + (unsigned int)(axis2Value*axis2Value);
+    double length = sqrt(square_dist);
+
+    snapshot.radius = qMin(length, (double)JoyAxis::AXISMAX);
+    snapshot.normalizedRadius = qBound(0.0, length / (double)maxZone, 1.0);
+    snapshot.deadZoneDistance = qBound(0.0, (length - deadZone)/(double)(maxZone - deadZone), 1.0);
+
+    // Bearing is measured clockwise from up
+    double bearing = 0.0;
+    if (axis1Value != 0 || axis2Value != 0)
+    {
+        bearing = (atan2((double)axis1Value, (double)-axis2Value) * 180) / PI;
+        if (bearing < 0.0)
+        {
+            bearing = 360.0 + bearing;
+        }
+    }
+    snapshot.bearing = bearing;
+
+    if (deadZoneType == RadialDeadZone)
+    {
+        // Distances past the dead zone along each axis
+        double relativeAngle = bearing;
+        if (relativeAngle > 180)
+        {
+            relativeAngle = relativeAngle - 180;
+        }
+
+        int deadX = (int)round(deadZone * sin(relativeAngle * PI / 180.0));
+        snapshot.xDeadZoneDistance = qBound(0.0, (abs(axis1Value) - deadX)/(double)(maxZone - deadX), 1.0);
+
+        int deadY = abs((int)round(deadZone * cos(relativeAngle * PI / 180.0)));
+        snapshot.yDeadZoneDistance = qBound(0.0, (abs(axis2Value) - deadY)/(double)(maxZone - deadY), 1.0);
+    }
+    else
+    {
+        double outputX = 0.0;
+        double outputY = 0.0;
+        calculateDeadZoneOutput(axis1Value, axis2Value, outputX, outputY);
+
+        snapshot.xDeadZoneDistance = fabs(outputX);
+        snapshot.yDeadZoneDistance = fabs(outputY);
+        snapshot.deadZoneDistance = qMin(1.0, sqrt(outputX*outputX + outputY*outputY));
+    }
+
+    // Distance used by a diagonal button in eight way mode
+    int relativeBearing = (int)round(bearing) % 90;
+    int diagonalAngle = relativeBearing;
+    if (relativeBearing > 45)
+    {
+        diagonalAngle = 90 - relativeBearing;
+    }
+
+    snapshot.diagonalDistance = snapshot.deadZoneDistance * (diagonalAngle / 45.0);
+}
+
 JoyControlStick::JoyStickDirections JoyControlStick::getCurrentDirection()
 {
     return currentDirection;
@@ -1038,36 +1175,11 @@ QList<int> JoyControlStick::getDiagonalZoneAngles()
 {
     QList<int> anglesList;
 
-    int diagonalAngle = diagonalRange;
-
-    int cardinalAngle = (360 - (diagonalAngle * 4)) / 4;
-
-    int initialLeft = 360 - (int)((cardinalAngle - 1) / 2);
-    int initialRight = (int)((cardinalAngle - 1)/ 2);
-    if ((cardinalAngle - 1) % 2 != 0)
+    for (int i=0; i < 9; i++)
     {
-        initialLeft = 360 - (cardinalAngle / 2);
-        initialRight = (cardinalAngle / 2) - 1;
+        anglesList.append(zoneAngles[i]);
     }
 
-    int upRightInitial = initialRight + 1;
-    int rightInitial = upRightInitial + diagonalAngle ;
-    int downRightInitial = rightInitial + cardinalAngle;
-    int downInitial = downRightInitial + diagonalAngle;
-    int downLeftInitial = downInitial + cardinalAngle;
-    int leftInitial = downLeftInitial + diagonalAngle;
-    int upLeftInitial = leftInitial + cardinalAngle;
-
-    anglesList.append(initialLeft);
-    anglesList.append(initialRight);
-    anglesList.append(upRightInitial);
-    anglesList.append(rightInitial);
-    anglesList.append(downRightInitial);
-    anglesList.append(downInitial);
-    anglesList.append(downLeftInitial);
-    anglesList.append(leftInitial);
-    anglesList.append(upLeftInitial);
-
     return anglesList;
 }
 
@@ -1091,6 +1203,7 @@ void JoyControlStick::replaceXAxis(JoyAxis *axis)
     axisX->removeControlStick();
     this->axisX = axis;
     this->axisX->setControlStick(this);
+    invalidateSnapshot();
 }
 
 void JoyControlStick::replaceYAxis(JoyAxis *axis)
@@ -1098,6 +1211,7 @@ void JoyControlStick::replaceYAxis(JoyAxis *axis)
     axisY->removeControlStick();
     this->axisY = axis;
     this->axisY->setControlStick(this);
+    invalidateSnapshot();
 }
 
 void JoyControlStick::setJoyMode(JoyMode mode)
@@ -1127,6 +1241,9 @@ bool JoyControlStick::isDefault()
     value = value && (maxZone == JoyAxis::AXISMAXZONE);
     value = value && (diagonalRange == 45);
     value = value && (currentMode == StandardMode);
+    value = value && (deadZoneType == RadialDeadZone);
+    value = value && (deadZoneHysteresis == 0);
+    value = value && (directionHysteresis == 0);
     QHashIterator<JoyStickDirections, JoyControlStickButton*> iter(buttons);
     while (iter.hasNext())
     {
@@ -1467,3 +1584,203 @@ double JoyControlStick::getButtonsPresetSensitivity()
 
     return presetSensitivity;
 }
+
+void JoyControlStick::setButtonsVelocityAcceleration(bool enabled)
+{
+    QHashIterator<JoyStickDirections, JoyControlStickButton*> iter(buttons);
+    while (iter.hasNext())
+    {
+        JoyControlStickButton *button = iter.next().value();
+        button->setVelocityAcceleration(enabled);
+    }
+}
+
+bool JoyControlStick::getButtonsPresetVelocityAcceleration()
+{
+    bool presetVelocityAcceleration = false;
+
+    QHash<JoyStickDirections, JoyControlStickButton*> temphash;
+    temphash.insert(StickUp, buttons.value(StickUp));
+    temphash.insert(StickDown, buttons.value(StickDown));
+    temphash.insert(StickLeft, buttons.value(StickLeft));
+    temphash.insert(StickRight, buttons.value(StickRight));
+    if (currentMode == EightWayMode)
+    {
+        temphash.insert(StickLeftUp, buttons.value(StickLeftUp));
+        temphash.insert(StickRightUp, buttons.value(StickRightUp));
+        temphash.insert(StickRightDown, buttons.value(StickRightDown));
+        temphash.insert(StickLeftDown, buttons.value(StickLeftDown));
+    }
+
+    QHashIterator<JoyStickDirections, JoyControlStickButton*> iter(temphash);
+    while (iter.hasNext())
+    {
+        if (!iter.hasPrevious())
+        {
+            JoyControlStickButton *button = iter.next().value();
+            presetVelocityAcceleration = button->isVelocityAccelerationEnabled();
+        }
+        else
+        {
+            JoyControlStickButton *button = iter.next().value();
+            bool temp = button->isVelocityAccelerationEnabled();
+            if (temp != presetVelocityAcceleration)
+            {
+                presetVelocityAcceleration = false;
+                iter.toBack();
+            }
+        }
+    }
+
+    return presetVelocityAcceleration;
+}
+
+void JoyControlStick::setButtonsVelocityGain(double value)
+{
+    QHashIterator<JoyStickDirections, JoyControlStickButton*> iter(buttons);
+    while (iter.hasNext())
+    {
+        JoyControlStickButton *button = iter.next().value();
+        button->setVelocityGain(value);
+    }
+}
+
+double JoyControlStick::getButtonsPresetVelocityGain()
+{
+    double presetVelocityGain = JoyButton::DEFAULTVELOCITYGAIN;
+
+    QHash<JoyStickDirections, JoyControlStickButton*> temphash;
+    temphash.insert(StickUp, buttons.value(StickUp));
+    temphash.insert(StickDown, buttons.value(StickDown));
+    temphash.insert(StickLeft, buttons.value(StickLeft));
+    temphash.insert(StickRight, buttons.value(StickRight));
+    if (currentMode == EightWayMode)
+    {
+        temphash.insert(StickLeftUp, buttons.value(StickLeftUp));
+        temphash.insert(StickRightUp, buttons.value(StickRightUp));
+        temphash.insert(StickRightDown, buttons.value(StickRightDown));
+        temphash.insert(StickLeftDown, buttons.value(StickLeftDown));
+    }
+
+    QHashIterator<JoyStickDirections, JoyControlStickButton*> iter(temphash);
+    while (iter.hasNext())
+    {
+        if (!iter.hasPrevious())
+        {
+            JoyControlStickButton *button = iter.next().value();
+            presetVelocityGain = button->getVelocityGain();
+        }
+        else
+        {
+            JoyControlStickButton *button = iter.next().value();
+            double temp = button->getVelocityGain();
+            if (temp != presetVelocityGain)
+            {
+                presetVelocityGain = JoyButton::DEFAULTVELOCITYGAIN;
+                iter.toBack();
+            }
+        }
+    }
+
+    return presetVelocityGain;
+}
+
+void JoyControlStick::setButtonsVelocityCap(double value)
+{
+    QHashIterator<JoyStickDirections, JoyControlStickButton*> iter(buttons);
+    while (iter.hasNext())
+    {
+        JoyControlStickButton *button = iter.next().value();
+        button->setVelocityCap(value);
+    }
+}
+
+double JoyControlStick::getButtonsPresetVelocityCap()
+{
+    double presetVelocityCap = JoyButton::DEFAULTVELOCITYCAP;
+
+    QHash<JoyStickDirections, JoyControlStickButton*> temphash;
+    temphash.insert(StickUp, buttons.value(StickUp));
+    temphash.insert(StickDown, buttons.value(StickDown));
+    temphash.insert(StickLeft, buttons.value(StickLeft));
+    temphash.insert(StickRight, buttons.value(StickRight));
+    if (currentMode == EightWayMode)
+    {
+        temphash.insert(StickLeftUp, buttons.value(StickLeftUp));
+        temphash.insert(StickRightUp, buttons.value(StickRightUp));
+        temphash.insert(StickRightDown, buttons.value(StickRightDown));
+        temphash.insert(StickLeftDown, buttons.value(StickLeftDown));
+    }
+
+    QHashIterator<JoyStickDirections, JoyControlStickButton*> iter(temphash);
+    while (iter.hasNext())
+    {
+        if (!iter.hasPrevious())
+        {
+            JoyControlStickButton *button = iter.next().value();
+            presetVelocityCap = button->getVelocityCap();
+        }
+        else
+        {
+            JoyControlStickButton *button = iter.next().value();
+            double temp = button->getVelocityCap();
+            if (temp != presetVelocityCap)
+            {
+                presetVelocityCap = JoyButton::DEFAULTVELOCITYCAP;
+                iter.toBack();
+            }
+        }
+    }
+
+    return presetVelocityCap;
+}
+
+void JoyControlStick::setButtonsVelocityDecay(double value)
+{
+    QHashIterator<JoyStickDirections, JoyControlStickButton*> iter(buttons);
+    while (iter.hasNext())
+    {
+        JoyControlStickButton *button = iter.next().value();
+        button->setVelocityDecay(value);
+    }
+}
+
+double JoyControlStick::getButtonsPresetVelocityDecay()
+{
+    double presetVelocityDecay = JoyButton::DEFAULTVELOCITYDECAY;
+
+    QHash<JoyStickDirections, JoyControlStickButton*> temphash;
+    temphash.insert(StickUp, buttons.value(StickUp));
+    temphash.insert(StickDown, buttons.value(StickDown));
+    temphash.insert(StickLeft, buttons.value(StickLeft));
+    temphash.insert(StickRight, buttons.value(StickRight));
+    if (currentMode == EightWayMode)
+    {
+        temphash.insert(StickLeftUp, buttons.value(StickLeftUp));
+        temphash.insert(StickRightUp, buttons.value(StickRightUp));
+        temphash.insert(StickRightDown, buttons.value(StickRightDown));
+        temphash.insert(StickLeftDown, buttons.value(StickLeftDown));
+    }
+
+    QHashIterator<JoyStickDirections, JoyControlStickButton*> iter(temphash);
+    while (iter.hasNext())
+    {
+        if (!iter.hasPrevious())
+        {
+            JoyControlStickButton *button = iter.next().value();
+            presetVelocityDecay = button->getVelocityDecay();
+        }
+        else
+        {
+            JoyControlStickButton *button = iter.next().value();
+            double temp = button->getVelocityDecay();
+            if (temp != presetVelocityDecay)
+            {
+                presetVelocityDecay = JoyButton::DEFAULTVELOCITYDECAY;
+                iter.toBack();
+            }
+        }
+    }
+
+    return presetVelocityDecay;
+}
@@ -12,6 +12,33 @@
 #include "joycontrolstickdirectionstype.h"
 #include "joycontrolstickbutton.h"
 
+// Edges of a direction zone as fixed point unit vectors
+struct StickZone
+{
+    qint64 startCos;
+    qint64 startSin;
+    qint64 endCos;
+    qint64 endSin;
+};
+
+// Values derived from the stick position. Built at most once for
+// each version of the stick state and shared by all direction buttons
+struct StickSnapshot
+{
+    unsigned int version;
+    int xvalue;
+    int yvalue;
+    double normalizedX;
+    double normalizedY;
+    double radius;
+    double normalizedRadius;
+    double bearing;
+    double deadZoneDistance;
+    double xDeadZoneDistance;
+    double yDeadZoneDistance;
+    double diagonalDistance;
+};
+
 class JoyControlStick : public QObject, public JoyStickDirectionsType
 {
     Q_OBJECT
@@ -20,6 +47,8 @@ public:
     ~JoyControlStick();
 
     enum JoyMode {StandardMode=0, EightWayMode};
+    enum DeadZoneType {RadialDeadZone=0, ScaledRadialDeadZone, AxialDeadZone,
+                       HybridDeadZone, SquareToCircleDeadZone};
 
     void joyEvent(bool ignoresets=false);
     bool inDeadZone();
@@ -56,9 +85,20 @@ public:
     double calculateNormalizedAxis2Placement();
     double calculateDirectionalDistance(JoyControlStickButton *button, JoyButton::JoyMouseMovementMode=JoyButton::MouseCursor);
 
+    const StickSnapshot& getSnapshot();
+
     void setJoyMode(JoyMode mode);
     JoyMode getJoyMode();
 
+    void setDeadZoneType(DeadZoneType type);
+    DeadZoneType getDeadZoneType();
+    void setDeadZoneHysteresis(int value);
+    int getDeadZoneHysteresis();
+    void setDirectionHysteresis(int value);
+    int getDirectionHysteresis();
+    int getAvoidedDeadZoneChanges();
+    int getAvoidedDirectionChanges();
+
     void setButtonsMouseMode(JoyButton::JoyMouseMovementMode mode);
     bool hasSameButtonsMouseMode();
     JoyButton::JoyMouseMovementMode getButtonsPresetMouseMode();
@@ -75,6 +115,14 @@ public:
 
     void setButtonsSensitivity(double value);
     double getButtonsPresetSensitivity();
+    void setButtonsVelocityAcceleration(bool enabled);
+    bool getButtonsPresetVelocityAcceleration();
+    void setButtonsVelocityGain(double value);
+    double getButtonsPresetVelocityGain();
+    void setButtonsVelocityCap(double value);
+    double getButtonsPresetVelocityCap();
+    void setButtonsVelocityDecay(double value);
+    double getButtonsPresetVelocityDecay();
 
     void releaseButtonEvents();
 
@@ -84,16 +132,27 @@ public:
     virtual void writeConfig(QXmlStreamWriter *xml);
 
     static const double PI;
+    static const int ZONESCALE;
 
 protected:
     virtual void populateButtons();
     void createDeskEvent(bool ignoresets = false);
     void changeButtonEvent(JoyControlStickButton *eventbutton, JoyControlStickButton *&activebutton, bool ignoresets);
+    JoyStickDirections calculateStickDirection(int xvalue, int yvalue);
+    bool isInZone(const StickZone &zone, int xvalue, int yvalue);
+    void refreshZones();
+    void setZoneEdges(StickZone &zone, double startAngle, double endAngle);
+    bool isWithinRadius(int radius);
+    bool isWithinDeadZone(int radius);
+    void mapSquareToCircle(int &xvalue, int &yvalue);
+    void calculateDeadZoneOutput(int xvalue, int yvalue, double &outputX, double &outputY);
     void refreshButtons();
     void deleteButtons();
     void resetButtons();
     double calculateXDistanceFromDeadZone();
     double calculateYDistanceFromDeadZone();
+    void invalidateSnapshot();
+    void buildSnapshot();
 
     JoyAxis *axisX;
     JoyAxis *axisY;
@@ -109,6 +168,30 @@ protected:
     int index;
     JoyStickDirections currentDirection;
     JoyMode currentMode;
+    DeadZoneType deadZoneType;
+
+    // Distance below the dead zone that an active stick has to
+    // return to before it is released
+    int deadZoneHysteresis;
+    // Degrees that the bearing can move past the zone of the
+    // current direction before the direction changes
+    int directionHysteresis;
+    JoyStickDirections unfilteredDirection;
+    bool previousUnfilteredSafeZone;
+    int avoidedDeadZoneChanges;
+    int avoidedDirectionChanges;
+
+    // Boundaries returned by getDiagonalZoneAngles()
+    int zoneAngles[9];
+    // Zone of each direction starting from StickUp going clockwise
+    // and the same zones widened by the direction hysteresis
+    StickZone directionZones[8];
+    StickZone hysteresisZones[8];
+
+    // Incremented whenever the position or the zones of the
+    // stick change so an older snapshot is never read
+    unsigned int stateVersion;
+    StickSnapshot snapshot;
 
     QHash<JoyStickDirections, JoyControlStickButton*> buttons;
 
@@ -637,3 +637,203 @@ double JoyDPad::getButtonsPresetSensitivity()
 
     return presetSensitivity;
 }
+
+void JoyDPad::setButtonsVelocityAcceleration(bool enabled)
+{
+    QHashIterator<int, JoyDPadButton*> iter(buttons);
+    while (iter.hasNext())
+    {
+        JoyDPadButton *button = iter.next().value();
+        button->setVelocityAcceleration(enabled);
+    }
+}
+
+bool JoyDPad::getButtonsPresetVelocityAcceleration()
+{
+    bool presetVelocityAcceleration = false;
+
+    QHash<int, JoyDPadButton*> temphash;
+    temphash.insert(JoyDPadButton::DpadUp, buttons.value(JoyDPadButton::DpadUp));
+    temphash.insert(JoyDPadButton::DpadDown, buttons.value(JoyDPadButton::DpadDown));
+    temphash.insert(JoyDPadButton::DpadLeft, buttons.value(JoyDPadButton::DpadLeft));
+    temphash.insert(JoyDPadButton::DpadRight, buttons.value(JoyDPadButton::DpadRight));
+    if (currentMode == EightWayMode)
+    {
+        temphash.insert(JoyDPadButton::DpadLeftUp, buttons.value(JoyDPadButton::DpadLeftUp));
+        temphash.insert(JoyDPadButton::DpadRightUp, buttons.value(JoyDPadButton::DpadRightUp));
+        temphash.insert(JoyDPadButton::DpadRightDown, buttons.value(JoyDPadButton::DpadRightDown));
+        temphash.insert(JoyDPadButton::DpadLeftDown, buttons.value(JoyDPadButton::DpadLeftDown));
+    }
+
+    QHashIterator<int, JoyDPadButton*> iter(temphash);
+    while (iter.hasNext())
+    {
+        if (!iter.hasPrevious())
+        {
+            JoyDPadButton *button = iter.next().value();
+            presetVelocityAcceleration = button->isVelocityAccelerationEnabled();
+        }
+        else
+        {
+            JoyDPadButton *button = iter.next().value();
+            bool temp = button->isVelocityAccelerationEnabled();
+            if (temp != presetVelocityAcceleration)
+            {
+                presetVelocityAcceleration = false;
+                iter.toBack();
+            }
+        }
+    }
+
+    return presetVelocityAcceleration;
+}
+
+void JoyDPad::setButtonsVelocityGain(double value)
+{
+    QHashIterator<int, JoyDPadButton*> iter(buttons);
+    while (iter.hasNext())
+    {
+        JoyDPadButton *button = iter.next().value();
+        button->setVelocityGain(value);
+    }
+}
+
+double JoyDPad::getButtonsPresetVelocityGain()
+{
+    double presetVelocityGain = JoyButton::DEFAULTVELOCITYGAIN;
+
+    QHash<int, JoyDPadButton*> temphash;
+    temphash.insert(JoyDPadButton::DpadUp, buttons.value(JoyDPadButton::DpadUp));
+    temphash.insert(JoyDPadButton::DpadDown, buttons.value(JoyDPadButton::DpadDown));
+    temphash.insert(JoyDPadButton::DpadLeft, buttons.value(JoyDPadButton::DpadLeft));
+    temphash.insert(JoyDPadButton::DpadRight, buttons.value(JoyDPadButton::DpadRight));
+    if (currentMode == EightWayMode)
+    {
+        temphash.insert(JoyDPadButton::DpadLeftUp, buttons.value(JoyDPadButton::DpadLeftUp));
+        temphash.insert(JoyDPadButton::DpadRightUp, buttons.value(JoyDPadButton::DpadRightUp));
+        temphash.insert(JoyDPadButton::DpadRightDown, buttons.value(JoyDPadButton::DpadRightDown));
+        temphash.insert(JoyDPadButton::DpadLeftDown, buttons.value(JoyDPadButton::DpadLeftDown));
+    }
+
+    QHashIterator<int, JoyDPadButton*> iter(temphash);
+    while (iter.hasNext())
+    {
+        if (!iter.hasPrevious())
+        {
+            JoyDPadButton *button = iter.next().value();
+            presetVelocityGain = button->getVelocityGain();
+        }
+        else
+        {
+            JoyDPadButton *button = iter.next().value();
+            double temp = button->getVelocityGain();
+            if (temp != presetVelocityGain)
+            {
+                presetVelocityGain = JoyButton::DEFAULTVELOCITYGAIN;
+                iter.toBack();
+            }
+        }
+    }
+
+    return presetVelocityGain;
+}
+
+void JoyDPad::setButtonsVelocityCap(double value)
+{
+    QHashIterator<int, JoyDPadButton*> iter(buttons);
+    while (iter.hasNext())
+    {
+        JoyDPadButton *button = iter.next().value();
+        button->setVelocityCap(value);
+    }
+}
+
+double JoyDPad::getButtonsPresetVelocityCap()
+{
+    double presetVelocityCap = JoyButton::DEFAULTVELOCITYCAP;
+
+    QHash<int, JoyDPadButton*> temphash;
+    temphash.insert(JoyDPadButton::DpadUp, buttons.value(JoyDPadButton::DpadUp));
+    temphash.insert(JoyDPadButton::DpadDown, buttons.value(JoyDPadButton::DpadDown));
+    temphash.insert(JoyDPadButton::DpadLeft, buttons.value(JoyDPadButton::DpadLeft));
+    temphash.insert(JoyDPadButton::DpadRight, buttons.value(JoyDPadButton::DpadRight));
+    if (currentMode == EightWayMode)
+    {
+        temphash.insert(JoyDPadButton::DpadLeftUp, buttons.value(JoyDPadButton::DpadLeftUp));
+        temphash.insert(JoyDPadButton::DpadRightUp, buttons.value(JoyDPadButton::DpadRightUp));
+        temphash.insert(JoyDPadButton::DpadRightDown, buttons.value(JoyDPadButton::DpadRightDown));
+        temphash.insert(JoyDPadButton::DpadLeftDown, buttons.value(JoyDPadButton::DpadLeftDown));
+    }
+
+    QHashIterator<int, JoyDPadButton*> iter(temphash);
+    while (iter.hasNext())
+    {
+        if (!iter.hasPrevious())
+        {
+            JoyDPadButton *button = iter.next().value();
+            presetVelocityCap = button->getVelocityCap();
+        }
+        else
+        {
+            JoyDPadButton *button = iter.next().value();
+            double temp = button->getVelocityCap();
+            if (temp != presetVelocityCap)
+            {
+                presetVelocityCap = JoyButton::DEFAULTVELOCITYCAP;
+                iter.toBack();
+            }
+        }
+    }
+
+    return presetVelocityCap;
+}
+
+void JoyDPad::setButtonsVelocityDecay(double value)
+{
+    QHashIterator<int, JoyDPadButton*> iter(buttons);
+    while (iter.hasNext())
+    {
+        JoyDPadButton *button = iter.next().value();
+        button->setVelocityDecay(value);
+    }
+}
+
+double JoyDPad::getButtonsPresetVelocityDecay()
+{
+    double presetVelocityDecay = JoyButton::DEFAULTVELOCITYDECAY;
+
+    QHash<int, JoyDPadButton*> temphash;
+    temphash.insert(JoyDPadButton::DpadUp, buttons.value(JoyDPadButton::DpadUp));
+    temphash.insert(JoyDPadButton::DpadDown, buttons.value(JoyDPadButton::DpadDown));
+    temphash.insert(JoyDPadButton::DpadLeft, buttons.value(JoyDPadButton::DpadLeft));
+    temphash.insert(JoyDPadButton::DpadRight, buttons.value(JoyDPadButton::DpadRight));
+    if (currentMode == EightWayMode)
+    {
+        temphash.insert(JoyDPadButton::DpadLeftUp, buttons.value(JoyDPadButton::DpadLeftUp));
+        temphash.insert(JoyDPadButton::DpadRightUp, buttons.value(JoyDPadButton::DpadRightUp));
+        temphash.insert(JoyDPadButton::DpadRightDown, buttons.value(JoyDPadButton::DpadRightDown));
+        temphash.insert(JoyDPadButton::DpadLeftDown, buttons.value(JoyDPadButton::DpadLeftDown));
+    }
+
+    QHashIterator<int, JoyDPadButton*> iter(temphash);
+    while (iter.hasNext())
+    {
+        if (!iter.hasPrevious())
+        {
+            JoyDPadButton *button = iter.next().value();
+            presetVelocityDecay = button->getVelocityDecay();
+        }
+        else
+        {
+            JoyDPadButton *button = iter.next().value();
+            double temp = button->getVelocityDecay();
+            if (temp != presetVelocityDecay)
+            {
+                presetVelocityDecay = JoyButton::DEFAULTVELOCITYDECAY;
+                iter.toBack();
+            }
+        }
+    }
+
+    return presetVelocityDecay;
+}
@@ -50,6 +50,14 @@ public:
 
     void setButtonsSensitivity(double value);
     double getButtonsPresetSensitivity();
+    void setButtonsVelocityAcceleration(bool enabled);
+    bool getButtonsPresetVelocityAcceleration();
+    void setButtonsVelocityGain(double value);
+    double getButtonsPresetVelocityGain();
+    void setButtonsVelocityCap(double value);
+    double getButtonsPresetVelocityCap();
+    void setButtonsVelocityDecay(double value);
+    double getButtonsPresetVelocityDecay();
 
     virtual bool isDefault();
 
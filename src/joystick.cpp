@@ -2,6 +2,7 @@
 
 #include <QDebug>
 #include <QHashIterator>
+#include <QSettings>
 
 #include "joystick.h"
 
@@ -12,23 +13,50 @@ Joystick::Joystick(SDL_Joystick *joyhandle, QObject *parent) :
 {
     this->joyhandle = joyhandle;
     joyNumber= SDL_JoystickIndex(joyhandle);
+    sdlName = QString(SDL_JoystickName(joyNumber));
     joystick_sets = QHash<int, SetJoystick*> ();
     for (int i=0; i < NUMBER_JOYSETS; i++)
     {
-        SetJoystick *setstick = new SetJoystick(joyhandle, i, this);
-        joystick_sets.insert(i, setstick);
-        connect(setstick, SIGNAL(setChangeActivated(int)), this, SLOT(setActiveSetNumber(int)));
-        connect(setstick, SIGNAL(setChangeActivated(int)), this, SLOT(propogateSetChange(int)));
-        connect(setstick, SIGNAL(setAssignmentButtonChanged(int,int,int,int)), this, SLOT(changeSetButtonAssociation(int,int,int,int)));
+        addSetJoystick(new SetJoystick(joyhandle, i, this));
+    }
 
-        connect(setstick, SIGNAL(setAssignmentAxisChanged(int,int,int,int,int)), this, SLOT(changeSetAxisButtonAssociation(int,int,int,int,int)));
-        connect(setstick, SIGNAL(setAssignmentDPadChanged(int,int,int,int,int)), this, SLOT(changeSetDPadButtonAssociation(int,int,int,int,int)));
-        connect(setstick, SIGNAL(setAssignmentStickChanged(int,int,int,int,int)), this, SLOT(changeSetStickButtonAssociation(int,int,int,int,int)));
+    active_set = 0;
+    refreshDispatchTable();
+    readCalibration();
+}
 
-        connect(setstick, SIGNAL(setAssignmentAxisThrottleChanged(int,int)), this, SLOT(propogateSetAxisThrottleChange(int, int)));
+/* Create a joystick that is not backed by an SDL handle. Used
+ * to build controllers without the hardware.
+ */
+Joystick::Joystick(QString name, int index, int buttons, int axes, int hats, QObject *parent) :
+    QObject(parent)
+{
+    this->joyhandle = 0;
+    joyNumber = index;
+    sdlName = name;
+    joystick_sets = QHash<int, SetJoystick*> ();
+    for (int i=0; i < NUMBER_JOYSETS; i++)
+    {
+        addSetJoystick(new SetJoystick(buttons, axes, hats, i, this));
     }
 
     active_set = 0;
+    refreshDispatchTable();
+    readCalibration();
+}
+
+void Joystick::addSetJoystick(SetJoystick *setstick)
+{
+    joystick_sets.insert(setstick->getIndex(), setstick);
+    connect(setstick, SIGNAL(setChangeActivated(int)), this, SLOT(setActiveSetNumber(int)));
+    connect(setstick, SIGNAL(setChangeActivated(int)), this, SLOT(propogateSetChange(int)));
+    connect(setstick, SIGNAL(setAssignmentButtonChanged(int,int,int,int)), this, SLOT(changeSetButtonAssociation(int,int,int,int)));
+
+    connect(setstick, SIGNAL(setAssignmentAxisChanged(int,int,int,int,int)), this, SLOT(changeSetAxisButtonAssociation(int,int,int,int,int)));
+    connect(setstick, SIGNAL(setAssignmentDPadChanged(int,int,int,int,int)), this, SLOT(changeSetDPadButtonAssociation(int,int,int,int,int)));
+    connect(setstick, SIGNAL(setAssignmentStickChanged(int,int,int,int,int)), this, SLOT(changeSetStickButtonAssociation(int,int,int,int,int)));
+
+    connect(setstick, SIGNAL(setAssignmentAxisThrottleChanged(int,int)), this, SLOT(propogateSetAxisThrottleChange(int, int)));
 }
 
 Joystick::~Joystick()
@@ -52,6 +80,38 @@ SDL_Joystick* Joystick::getSDLHandle()
     return joyhandle;
 }
 
+/* Point the joystick at a new SDL handle after the SDL joystick
+ * subsystem has been restarted. Sets and any loaded profile are
+ * left untouched.
+ */
+void Joystick::setSDLHandle(SDL_Joystick *joyhandle)
+{
+    this->joyhandle = joyhandle;
+    joyNumber = SDL_JoystickIndex(joyhandle);
+    sdlName = QString(SDL_JoystickName(joyNumber));
+
+    QHashIterator<int, SetJoystick*> iter(joystick_sets);
+    while (iter.hasNext())
+    {
+        iter.next().value()->setSDLHandle(joyhandle);
+    }
+}
+
+QString Joystick::getSDLName()
+{
+    return sdlName;
+}
+
+void Joystick::setDeviceIdentity(QString identity)
+{
+    deviceIdentity = identity;
+}
+
+QString Joystick::getDeviceIdentity()
+{
+    return deviceIdentity;
+}
+
 int Joystick::getJoyNumber()
 {
     return joyNumber;
@@ -70,11 +130,37 @@ QString Joystick::getName()
 
 void Joystick::reset()
 {
+    // Resetting the sets creates new axes. Keep the calibration of
+    // the old ones since it belongs to the controller, not the profile
+    QList<int> calibratedAxes;
+    QList<int> centers;
+    QList<int> minimums;
+    QList<int> maximums;
+    SetJoystick *currentset = joystick_sets.value(0);
+    for (int i=0; i < currentset->getNumberAxes(); i++)
+    {
+        JoyAxis *axis = currentset->getJoyAxis(i);
+        if (axis->isCalibrated())
+        {
+            calibratedAxes.append(i);
+            centers.append(axis->getCalibrationCenter());
+            minimums.append(axis->getCalibrationMin());
+            maximums.append(axis->getCalibrationMax());
+        }
+    }
+
     for (int i=0; i < NUMBER_JOYSETS; i++)
     {
         SetJoystick* set = joystick_sets.value(i);
         set->reset();
     }
+
+    for (int i=0; i < calibratedAxes.size(); i++)
+    {
+        setAxisCalibration(calibratedAxes.at(i), centers.at(i), minimums.at(i), maximums.at(i));
+    }
+
+    refreshDispatchTable();
 }
 
 void Joystick::setActiveSetNumber(int index)
@@ -95,7 +181,7 @@ void Joystick::setActiveSetNumber(int index)
         for (int i = 0; i < current_set->getNumberAxes(); i++)
         {
             JoyAxis *axis = current_set->getJoyAxis(i);
-            axesstates.append(axis->getCurrentRawValue());
+            axesstates.append(axis->getUncalibratedValue());
         }
 
         for (int i = 0; i < current_set->getNumberHats(); i++)
@@ -106,6 +192,7 @@ void Joystick::setActiveSetNumber(int index)
 
         joystick_sets.value(active_set)->release();
         active_set = index;
+        refreshDispatchTable();
 
         current_set = joystick_sets.value(active_set);
         for (int i = 0; i < current_set->getNumberButtons(); i++)
@@ -171,6 +258,66 @@ SetJoystick* Joystick::getSetJoystick(int index)
     return joystick_sets.value(index);
 }
 
+JoyButton* Joystick::getActiveJoyButton(int index)
+{
+    JoyButton *button = 0;
+    if (index >= 0 && index < activeButtons.size())
+    {
+        button = activeButtons.at(index);
+    }
+
+    return button;
+}
+
+JoyAxis* Joystick::getActiveJoyAxis(int index)
+{
+    JoyAxis *axis = 0;
+    if (index >= 0 && index < activeAxes.size())
+    {
+        axis = activeAxes.at(index);
+    }
+
+    return axis;
+}
+
+JoyDPad* Joystick::getActiveJoyDPad(int index)
+{
+    JoyDPad *dpad = 0;
+    if (index >= 0 && index < activeHats.size())
+    {
+        dpad = activeHats.at(index);
+    }
+
+    return dpad;
+}
+
+/* Copy the element pointers of the active set into flat tables.
+ * Has to be called whenever the active set changes or the
+ * elements of the sets are recreated.
+ */
+void Joystick::refreshDispatchTable()
+{
+    SetJoystick *current_set = joystick_sets.value(active_set);
+
+    activeButtons.resize(current_set->getNumberButtons());
+    for (int i=0; i < activeButtons.size(); i++)
+    {
+        activeButtons[i] = current_set->getJoyButton(i);
+    }
+
+    activeAxes.resize(current_set->getNumberAxes());
+    for (int i=0; i < activeAxes.size(); i++)
+    {
+        activeAxes[i] = current_set->getJoyAxis(i);
+    }
+
+    activeHats.resize(current_set->getNumberHats());
+    for (int i=0; i < activeHats.size(); i++)
+    {
+        activeHats[i] = current_set->getJoyDPad(i);
+    }
+}
+
 void Joystick::propogateSetChange(int index)
 {
     emit setChangeActivated(index);
@@ -608,3 +755,102 @@ void Joystick::propogateSetAxisThrottleChange(int index, int originset)
         }
     }
 }
+
+/* Apply a calibration to the axis in every set since each set
+ * has its own copy of the axis.
+ */
+void Joystick::setAxisCalibration(int index, int center, int min, int max)
+{
+    QHashIterator<int, SetJoystick*> iter(joystick_sets);
+    while (iter.hasNext())
+    {
+        JoyAxis *axis = iter.next().value()->getJoyAxis(index);
+        if (axis)
+        {
+            axis->setCalibration(center, min, max);
+        }
+    }
+}
+
+void Joystick::setDeviceAxisValue(int index, int value)
+{
+    if (index >= 0)
+    {
+        if (index >= deviceAxisValues.size())
+        {
+            deviceAxisValues.resize(index + 1);
+            knownDeviceAxisValues.resize(index + 1);
+        }
+
+        deviceAxisValues[index] = value;
+        knownDeviceAxisValues[index] = true;
+    }
+}
+
+// True once an event has been seen for the axis
+bool Joystick::hasDeviceAxisValue(int index)
+{
+    return index >= 0 && index < knownDeviceAxisValues.size() && knownDeviceAxisValues.at(index);
+}
+
+int Joystick::getDeviceAxisValue(int index)
+{
+    int value = 0;
+    if (hasDeviceAxisValue(index))
+    {
+        value = deviceAxisValues.at(index);
+    }
+
+    return value;
+}
+
+// Calibration is stored per controller name
+QString Joystick::getCalibrationGroup()
+{
+    QString group = sdlName;
+    group.replace('/', '_').replace('\\', '_');
+    return group;
+}
+
+void Joystick::readCalibration()
+{
+    QSettings settings(PadderCommon::calibrationFilePath, QSettings::IniFormat);
+    settings.beginGroup(getCalibrationGroup());
+
+    SetJoystick *currentset = joystick_sets.value(0);
+    for (int i=0; i < currentset->getNumberAxes(); i++)
+    {
+        QString prefix = QString("Axis%1").arg(i+1);
+        if (settings.contains(prefix + "Center"))
+        {
+            int center = settings.value(prefix + "Center").toInt();
+            int min = settings.value(prefix + "Min").toInt();
+            int max = settings.value(prefix + "Max").toInt();
+            setAxisCalibration(i, center, min, max);
+        }
+    }
+
+    settings.endGroup();
+}
+
+void Joystick::writeCalibration()
+{
+    QSettings settings(PadderCommon::calibrationFilePath, QSettings::IniFormat);
+    settings.beginGroup(getCalibrationGroup());
+    settings.remove("");
+
+    SetJoystick *currentset = joystick_sets.value(0);
+    for (int i=0; i < currentset->getNumberAxes(); i++)
+    {
+        JoyAxis *axis = currentset->getJoyAxis(i);
+        if (axis->isCalibrated())
+        {
+            QString prefix = QString("Axis%1").arg(i+1);
+            settings.setValue(prefix + "Center", axis->getCalibrationCenter());
+            settings.setValue(prefix + "Min", axis->getCalibrationMin());
+            settings.setValue(prefix + "Max", axis->getCalibrationMax());
+        }
+    }
+
+    settings.endGroup();
+}
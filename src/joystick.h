@@ -2,6 +2,7 @@
 #define JOYSTICK_H
 
 #include <QObject>
+#include <QVector>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 #include <SDL/SDL.h>
@@ -17,6 +18,7 @@ class Joystick : public QObject
     Q_OBJECT
 public:
     explicit Joystick(SDL_Joystick *joyhandle, QObject *parent=0);
+    explicit Joystick(QString name, int index, int buttons, int axes, int hats, QObject *parent=0);
     ~Joystick();
 
     int getNumberButtons ();
@@ -25,16 +27,30 @@ public:
     int getNumberSticks();
     int getNumberVDPads();
     SDL_Joystick* getSDLHandle ();
+    void setSDLHandle(SDL_Joystick *joyhandle);
+    QString getSDLName();
+    void setDeviceIdentity(QString identity);
+    QString getDeviceIdentity();
     int getJoyNumber ();
     int getRealJoyNumber ();
     QString getName();
     int getActiveSetNumber();
     SetJoystick* getActiveSetJoystick();
     SetJoystick* getSetJoystick(int index);
+    JoyButton* getActiveJoyButton(int index);
+    JoyAxis* getActiveJoyAxis(int index);
+    JoyDPad* getActiveJoyDPad(int index);
 
     virtual void readConfig(QXmlStreamReader *xml);
     virtual void writeConfig(QXmlStreamWriter *xml);
 
+    void setAxisCalibration(int index, int center, int min, int max);
+    void readCalibration();
+    void writeCalibration();
+    void setDeviceAxisValue(int index, int value);
+    bool hasDeviceAxisValue(int index);
+    int getDeviceAxisValue(int index);
+
     static const int NUMBER_JOYSETS;
 
 protected:
@@ -42,6 +58,26 @@ protected:
     QHash<int, SetJoystick*> joystick_sets;
     int active_set;
     int joyNumber;
+    QString sdlName;
+    // Identifies the device the controller was opened from. Used to
+    // keep the Joystick of a controller when others are plugged in
+    QString deviceIdentity;
+
+    // Elements of the active set indexed by SDL number. Used by
+    // InputDaemon so dispatching an event does not need any hashing
+    QVector<JoyButton*> activeButtons;
+    QVector<JoyAxis*> activeAxes;
+    QVector<JoyDPad*> activeHats;
+
+    // Latest value the device reported for each axis. Kept apart
+    // from the axes of the sets so it does not change with the
+    // active set or when the axes are reset
+    QVector<int> deviceAxisValues;
+    QVector<bool> knownDeviceAxisValues;
+
+    void refreshDispatchTable();
+    void addSetJoystick(SetJoystick *setstick);
+    QString getCalibrationGroup();
 
 signals:
     void setChangeActivated(int index);
@@ -313,6 +313,12 @@ JoyTabWidget::JoyTabWidget(Joystick *joystick, QWidget *parent) :
     quickSetPushButton->setObjectName(QString::fromUtf8("quickSetPushButton"));
     horizontalLayout_3->addWidget(quickSetPushButton);
 
+    calibratePushButton = new QPushButton(tr("Calibrate"), this);
+    calibratePushButton->setObjectName(QString::fromUtf8("calibratePushButton"));
+    calibratePushButton->setToolTip(tr("Leave every stick centered, click this button and then move each axis to its limits until calibration finishes"));
+    horizontalLayout_3->addWidget(calibratePushButton);
+    calibration = new AxisCalibration(joystick, this);
+
     QSpacerItem *horizontalSpacer_2 = new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum);
 
     horizontalLayout_3->addItem(horizontalSpacer_2);
@@ -343,6 +349,8 @@ JoyTabWidget::JoyTabWidget(Joystick *joystick, QWidget *parent) :
 
     connect(stickAssignPushButton, SIGNAL(clicked()), this, SLOT(showStickAssignmentDialog()));
     connect(quickSetPushButton, SIGNAL(clicked()), this, SLOT(showQuickSetDialog()));
+    connect(calibratePushButton, SIGNAL(clicked()), this, SLOT(startCalibration()));
+    connect(calibration, SIGNAL(finished(int)), this, SLOT(finishCalibration(int)));
 }
 
 void JoyTabWidget::openConfigFileDialog()
@@ -1268,6 +1276,11 @@ void JoyTabWidget::loadConfigFile(QString fileLocation)
     }
 }
 
+Joystick* JoyTabWidget::getJoystick()
+{
+    return joystick;
+}
+
 void JoyTabWidget::openStickButtonDialog()
 {
     JoyControlStickButtonPushButton *pushbutton = static_cast<JoyControlStickButtonPushButton*> (sender());
@@ -1291,6 +1304,24 @@ void JoyTabWidget::showQuickSetDialog()
     connect(dialog, SIGNAL(finished(int)), this, SLOT(fillButtons()));
 }
 
+void JoyTabWidget::startCalibration()
+{
+    if (!calibration->isRunning())
+    {
+        calibratePushButton->setEnabled(false);
+        calibratePushButton->setText(tr("Calibrating"));
+        calibration->start();
+    }
+}
+
+void JoyTabWidget::finishCalibration(int calibratedAxes)
+{
+    calibratePushButton->setText(tr("Calibrate"));
+    calibratePushButton->setEnabled(true);
+    calibratePushButton->setToolTip(tr("Leave every stick centered, click this button and then move each axis to its limits until calibration finishes")
+                                    .append("\n").append(tr("Last calibration: %n axis(es) calibrated", "", calibratedAxes)));
+}
+
 void JoyTabWidget::removeCurrentButtons()
 {
     for (int i=0; i < Joystick::NUMBER_JOYSETS; i++)
@@ -17,6 +17,7 @@
 
 #include "joystick.h"
 #include "axiseditdialog.h"
+#include "axiscalibration.h"
 
 class JoyTabWidget : public QWidget
 {
@@ -31,6 +32,7 @@ public:
     int getCurrentConfigIndex();
     QString getCurrentConfigName();
     void loadConfigFile(QString fileLocation);
+    Joystick* getJoystick();
 
 protected:
     void removeCurrentButtons();
@@ -67,6 +69,8 @@ protected:
     QHBoxLayout *horizontalLayout_3;
     QPushButton *stickAssignPushButton;
     QPushButton *quickSetPushButton;
+    QPushButton *calibratePushButton;
+    AxisCalibration *calibration;
     QSpacerItem *verticalSpacer_2;
     QStackedWidget *stackedWidget_2;
     QWidget *page;
@@ -103,6 +107,8 @@ private slots:
     void showStickAssignmentDialog();
     void showDPadDialog();
     void showQuickSetDialog();
+    void startCalibration();
+    void finishCalibration(int calibratedAxes);
 
     void changeSetOne();
     void changeSetTwo();
@@ -0,0 +1,103 @@
+#include "latencyhistogram.h"
+
+const int LatencyHistogram::SUBBUCKETBITS = 4;
+const int LatencyHistogram::SUBBUCKETS = 1 << LatencyHistogram::SUBBUCKETBITS;
+// Linear buckets below SUBBUCKETS plus one group per remaining bit of an int
+const int LatencyHistogram::BUCKETCOUNT = (32 - LatencyHistogram::SUBBUCKETBITS) * LatencyHistogram::SUBBUCKETS;
+
+LatencyHistogram::LatencyHistogram()
+{
+    buckets.resize(BUCKETCOUNT);
+    reset();
+}
+
+void LatencyHistogram::record(qint64 nanoseconds)
+{
+    qint64 tempmicro = qMax(nanoseconds, (qint64)0) / 1000;
+    int microseconds = (int)qMin(tempmicro, (qint64)0x7FFFFFFF);
+
+    buckets[bucketIndex(microseconds)].fetchAndAddRelaxed(1);
+    count.fetchAndAddRelaxed(1);
+
+    int currentMax = maximum.fetchAndAddRelaxed(0);
+    while (microseconds > currentMax && !maximum.testAndSetRelaxed(currentMax, microseconds))
+    {
+        currentMax = maximum.fetchAndAddRelaxed(0);
+    }
+}
+
+int LatencyHistogram::getCount()
+{
+    return count.fetchAndAddRelaxed(0);
+}
+
+int LatencyHistogram::getMaximum()
+{
+    return maximum.fetchAndAddRelaxed(0);
+}
+
+/* Return the upper bound, in microseconds, of the bucket holding
+ * the sample at the given fraction of all recorded samples.
+ */
+int LatencyHistogram::getPercentile(double fraction)
+{
+    int result = 0;
+    int total = getCount();
+    if (total > 0)
+    {
+        int target = qMax((int)(fraction * total + 0.5), 1);
+        int seen = 0;
+        for (int i=0; i < BUCKETCOUNT && seen < target; i++)
+        {
+            seen += buckets[i].fetchAndAddRelaxed(0);
+            result = bucketUpperBound(i);
+        }
+
+        result = qMin(result, getMaximum());
+    }
+
+    return result;
+}
+
+void LatencyHistogram::reset()
+{
+    for (int i=0; i < BUCKETCOUNT; i++)
+    {
+        buckets[i].fetchAndStoreRelaxed(0);
+    }
+
+    count.fetchAndStoreRelaxed(0);
+    maximum.fetchAndStoreRelaxed(0);
+}
+
+int LatencyHistogram::bucketIndex(int microseconds)
+{
+    int index = microseconds;
+    if (microseconds >= SUBBUCKETS)
+    {
+        int exponent = SUBBUCKETBITS;
+        while ((microseconds >> (exponent + 1)) > 0)
+        {
+            exponent++;
+        }
+
+        int subbucket = (microseconds >> (exponent - SUBBUCKETBITS)) & (SUBBUCKETS - 1);
+        index = (exponent - SUBBUCKETBITS + 1) * SUBBUCKETS + subbucket;
+    }
+
+    return index;
+}
+
+int LatencyHistogram::bucketUpperBound(int index)
+{
+    int bound = index;
+    if (index >= SUBBUCKETS)
+    {
+        int exponent = index / SUBBUCKETS + SUBBUCKETBITS - 1;
+        int subbucket = index % SUBBUCKETS;
+        qint64 upper = ((qint64)(SUBBUCKETS + subbucket + 1) << (exponent - SUBBUCKETBITS)) - 1;
+        bound = (int)qMin(upper, (qint64)0x7FFFFFFF);
+    }
+
+    return bound;
+}
@@ -0,0 +1,36 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QAtomicInt>
+#include <QVector>
+
+/* Log-linear histogram of latencies in microseconds. Every power of
+ * two range is split into SUBBUCKETS equal buckets so percentiles
+ * are accurate to about 6% at any magnitude. Buckets are atomic so
+ * the histogram can be read while samples are being recorded.
+ */
+class LatencyHistogram
+{
+public:
+    explicit LatencyHistogram();
+
+    void record(qint64 nanoseconds);
+    int getCount();
+    int getMaximum();
+    int getPercentile(double fraction);
+    void reset();
+
+    static const int SUBBUCKETBITS;
+    static const int SUBBUCKETS;
+    static const int BUCKETCOUNT;
+
+protected:
+    int bucketIndex(int microseconds);
+    int bucketUpperBound(int index);
+
+    QVector<QAtomicInt> buckets;
+    QAtomicInt count;
+    QAtomicInt maximum;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -24,6 +24,11 @@
 #include "common.h"
 #include "advancebuttondialog.h"
 #include "commandlineutility.h"
+#include "outputsink.h"
+#include "nulloutputsink.h"
+#include "recordingoutputsink.h"
+#include "event.h"
+#include "mousescheduler.h"
 
 MainWindow *appWindow = 0;
 
@@ -36,17 +41,150 @@ void catchSIGUSR1(int sig) {
     signal(sig, catchSIGUSR1);
 }
 
+void catchSIGUSR2(int sig) {
+    // Statistics are printed later from the event loop
+    InputDaemon::requestStatistics();
+
+    signal(sig, catchSIGUSR2);
+}
+
+void deleteJoysticks(QHash<int, Joystick*> *joysticks)
+{
+    QHashIterator<int, Joystick*> iter(*joysticks);
+    while (iter.hasNext())
+    {
+        Joystick *joystick = iter.next().value();
+        if (joystick)
+        {
+            delete joystick;
+            joystick = 0;
+        }
+    }
+
+    joysticks->clear();
+    delete joysticks;
+}
+
+OutputSink* createOutputSink(CommandLineUtility &cmdutility)
+{
+    OutputSink *outputSink = 0;
+    if (cmdutility.hasOutputTraceFile())
+    {
+        outputSink = new RecordingOutputSink();
+    }
+    else if (cmdutility.getOutputSink() == CommandLineUtility::NullOutput)
+    {
+        outputSink = new NullOutputSink();
+    }
+
+    OutputSink::setInstance(outputSink);
+    setOutputBatching(cmdutility.isOutputBatchingEnabled());
+    if (cmdutility.hasMouseRate())
+    {
+        MouseScheduler::getInstance()->setRate(cmdutility.getMouseRate());
+    }
+
+    return outputSink;
+}
+
+void finishOutput(CommandLineUtility &cmdutility, OutputSink *outputSink)
+{
+    flushOutput();
+
+    if (cmdutility.hasOutputTraceFile())
+    {
+        RecordingOutputSink *traceSink = static_cast<RecordingOutputSink*>(outputSink);
+        QFile traceFile(cmdutility.getOutputTraceFile());
+        if (traceFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            QTextStream traceStream(&traceFile);
+            traceSink->writeTrace(traceStream, !cmdutility.isTraceTimingDisabled());
+            traceFile.close();
+        }
+    }
+
+    OutputSink::setInstance(0);
+    if (outputSink)
+    {
+        delete outputSink;
+        outputSink = 0;
+    }
+}
+
+/* Replay a recording without any window when generated events are
+ * not sent to X so no display is needed. Only the profile given on
+ * the command line is applied to the replayed controllers. This
+ * does not count as the running instance so no pid file is used.
+ */
+int runHeadlessReplay(int argc, char *argv[], CommandLineUtility &cmdutility)
+{
+    QCoreApplication a(argc, argv);
+
+    // SDL still gets initialized by the event reader
+    qputenv("SDL_VIDEODRIVER", "dummy");
+
+    QHash<int, Joystick*> *joysticks = new QHash<int, Joystick*> ();
+    OutputSink *outputSink = createOutputSink(cmdutility);
+    InputDaemon *joypad_worker = new InputDaemon (joysticks, &cmdutility);
+
+    if (cmdutility.hasProfile())
+    {
+        int controllerNumber = cmdutility.hasControllerNumber() ? cmdutility.getControllerNumber() : 0;
+        for (int i=0; i < joysticks->count(); i++)
+        {
+            if (controllerNumber <= 0 || controllerNumber - 1 == i)
+            {
+                XMLConfigReader reader;
+                reader.setFileName(cmdutility.getProfileLocation());
+                reader.configJoystick(joysticks->value(i));
+            }
+        }
+    }
+
+    signal(SIGUSR2, catchSIGUSR2);
+
+    QObject::connect(joypad_worker, SIGNAL(replayFinished()), &a, SLOT(quit()));
+    QObject::connect(&a, SIGNAL(aboutToQuit()), joypad_worker, SLOT(quit()));
+
+    int app_result = a.exec();
+
+    deleteJoysticks(joysticks);
+    joysticks = 0;
+
+    delete joypad_worker;
+    joypad_worker = 0;
+
+    finishOutput(cmdutility, outputSink);
+    outputSink = 0;
+
+    return app_result;
+}
+
 int main(int argc, char *argv[])
 {
     qRegisterMetaType<JoyButtonSlot*>();
     qRegisterMetaType<AdvanceButtonDialog*>();
     qRegisterMetaType<Joystick*>();
 
-    QApplication a(argc, argv);
+    // Arguments are parsed before the application object is created
+    // since a replay without X output does not use QtGui
     CommandLineUtility cmdutility;
-    QStringList cmdarguments = a.arguments();
+    QStringList cmdarguments;
+    for (int i=0; i < argc; i++)
+    {
+        cmdarguments.append(QString::fromLocal8Bit(argv[i]));
+    }
     cmdutility.parseArguments(cmdarguments);
 
+    if (!cmdutility.hasError() && !cmdutility.isHelpRequested() && !cmdutility.isVersionRequested() &&
+        cmdutility.hasReplayFile() &&
+        (cmdutility.hasOutputTraceFile() || cmdutility.getOutputSink() == CommandLineUtility::NullOutput))
+    {
+        return runHeadlessReplay(argc, argv, cmdutility);
+    }
+
+    QApplication a(argc, argv);
+
     QTranslator qtTranslator;
     qtTranslator.load("qt_" + QLocale::system().name(), QLibraryInfo::location(QLibraryInfo::TranslationsPath));
     a.installTranslator(&qtTranslator);
@@ -91,7 +229,7 @@ int main(int argc, char *argv[])
         {
             // An instance of this program is already running.
             // Save app config and exit.
-            InputDaemon *joypad_worker = new InputDaemon (joysticks, false);
+            InputDaemon *joypad_worker = new InputDaemon (joysticks, &cmdutility, false);
             MainWindow w(joysticks, &cmdutility, false);
             appWindow = &w;
 
@@ -111,19 +249,7 @@ int main(int argc, char *argv[])
             joypad_worker->quit();
             w.removeJoyTabs();
 
-            QHashIterator<int, Joystick*> iter(*joysticks);
-            while (iter.hasNext())
-            {
-                Joystick *joystick = iter.next().value();
-                if (joystick)
-                {
-                    delete joystick;
-                    joystick = 0;
-                }
-            }
-
-            joysticks->clear();
-            delete joysticks;
+            deleteJoysticks(joysticks);
             joysticks = 0;
 
             delete joypad_worker;
@@ -137,15 +263,21 @@ int main(int argc, char *argv[])
         QTextStream(&pidFile) << getpid();
     }
 
-    InputDaemon *joypad_worker = new InputDaemon (joysticks);
+    OutputSink *outputSink = createOutputSink(cmdutility);
+
+    InputDaemon *joypad_worker = new InputDaemon (joysticks, &cmdutility);
     MainWindow w(joysticks, &cmdutility);
     appWindow = &w;
 
     signal(SIGUSR1, catchSIGUSR1);
+    signal(SIGUSR2, catchSIGUSR2);
 
     QObject::connect(joypad_worker, SIGNAL(joysticksRefreshed(QHash<int,Joystick*>*)), &w, SLOT(fillButtons(QHash<int,Joystick*>*)));
     QObject::connect(&w, SIGNAL(joystickRefreshRequested()), joypad_worker, SLOT(refresh()));
     QObject::connect(joypad_worker, SIGNAL(joystickRefreshed(Joystick*)), &w, SLOT(fillButtons(Joystick*)));
+    QObject::connect(joypad_worker, SIGNAL(joystickAdded(Joystick*)), &w, SLOT(addJoyTab(Joystick*)));
+    QObject::connect(joypad_worker, SIGNAL(joystickRemoved(Joystick*)), &w, SLOT(removeJoyTab(Joystick*)));
+    QObject::connect(joypad_worker, SIGNAL(replayFinished()), &a, SLOT(quit()));
     //QObject::connect(&w, SIGNAL(joystickRefreshRequested(Joystick*)), joypad_worker, SLOT(refreshJoystick(Joystick*)));
     QObject::connect(&a, SIGNAL(lastWindowClosed()), &a, SLOT(quit()));
     QObject::connect(&a, SIGNAL(aboutToQuit()), &w, SLOT(saveAppConfig()));
@@ -167,23 +299,14 @@ int main(int argc, char *argv[])
         pidFile.remove();
     }
 
-    QHashIterator<int, Joystick*> iter(*joysticks);
-    while (iter.hasNext())
-    {
-        Joystick *joystick = iter.next().value();
-        if (joystick)
-        {
-            delete joystick;
-            joystick = 0;
-        }
-    }
-
-    joysticks->clear();
-    delete joysticks;
+    deleteJoysticks(joysticks);
     joysticks = 0;
 
     delete joypad_worker;
     joypad_worker = 0;
 
+    finishOutput(cmdutility, outputSink);
+    outputSink = 0;
+
     return app_result;
 }
@@ -132,12 +132,12 @@ void MainWindow::populateTrayIcon()
 {
     trayIconMenu->clear();
 
-    if (joysticks->count() > 0)
+    if (ui->tabWidget->count() > 0)
     {
-        for (int i=0; i < joysticks->count(); i++)
+        for (int i=0; i < ui->tabWidget->count(); i++)
         {
-            QMenu *joysticksub = trayIconMenu->addMenu(joysticks->value(i)->getName());
             JoyTabWidget *widget = (JoyTabWidget*)ui->tabWidget->widget(i);
+            QMenu *joysticksub = trayIconMenu->addMenu(widget->getJoystick()->getName());
             QHash<int, QString> *configs = widget->recentConfigs();
             QHashIterator<int, QString> iter(*configs);
             while (iter.hasNext())
@@ -549,3 +549,66 @@ void MainWindow::removeJoyTabs()
 
     ui->tabWidget->clear();
 }
+
+/* Add a tab for a controller that was connected while the program
+ * is running. Tabs of other controllers are left alone.
+ */
+void MainWindow::addJoyTab(Joystick *joystick)
+{
+    JoyTabWidget *tabwidget = new JoyTabWidget(joystick, this);
+    tabwidget->fillButtons();
+    ui->tabWidget->insertTab(joystick->getJoyNumber(), tabwidget, QString(tr("Joystick %1")).arg(joystick->getRealJoyNumber()));
+    if (showTrayIcon)
+    {
+        connect(tabwidget, SIGNAL(joystickConfigChanged(int)), this, SLOT(populateTrayIcon()));
+    }
+
+    QSettings settings(PadderCommon::configFilePath, QSettings::IniFormat);
+    tabwidget->loadSettings(&settings);
+
+    refreshJoyTabTitles();
+    ui->stackedWidget->setCurrentIndex(1);
+
+    if (showTrayIcon)
+    {
+        populateTrayIcon();
+    }
+}
+
+/* Remove the tab of a controller that was disconnected. Has to be
+ * called before the Joystick instance is deleted.
+ */
+void MainWindow::removeJoyTab(Joystick *joystick)
+{
+    for (int i = ui->tabWidget->count()-1; i >= 0; i--)
+    {
+        JoyTabWidget *tabwidget = static_cast<JoyTabWidget*> (ui->tabWidget->widget(i));
+        if (tabwidget && tabwidget->getJoystick() == joystick)
+        {
+            ui->tabWidget->removeTab(i);
+            delete tabwidget;
+            tabwidget = 0;
+        }
+    }
+
+    refreshJoyTabTitles();
+    if (ui->tabWidget->count() == 0)
+    {
+        ui->stackedWidget->setCurrentIndex(0);
+    }
+
+    if (showTrayIcon)
+    {
+        populateTrayIcon();
+    }
+}
+
+// Joystick numbers shift when a controller is added or removed
+void MainWindow::refreshJoyTabTitles()
+{
+    for (int i=0; i < ui->tabWidget->count(); i++)
+    {
+        JoyTabWidget *tabwidget = static_cast<JoyTabWidget*> (ui->tabWidget->widget(i));
+        ui->tabWidget->setTabText(i, QString(tr("Joystick %1")).arg(tabwidget->getJoystick()->getRealJoyNumber()));
+    }
+}
@@ -30,6 +30,7 @@ protected:
     virtual void hideEvent(QHideEvent * event);
     virtual void showEvent(QShowEvent *event);
     void loadConfigFile(QString fileLocation, int joystickIndex=0);
+    void refreshJoyTabTitles();
 
     QHash<int, Joystick*> *joysticks;
     QSystemTrayIcon *trayIcon;
@@ -59,6 +60,8 @@ public slots:
     void saveAppConfig();
     void loadAppConfig(bool forceRefresh=false);
     void removeJoyTabs();
+    void addJoyTab(Joystick *joystick);
+    void removeJoyTab(Joystick *joystick);
 
 private slots:
     void quitProgram();
@@ -18,6 +18,10 @@ MouseAxisSettingsDialog::MouseAxisSettingsDialog(JoyAxis *axis, QWidget *parent)
         ui->sensitivityDoubleSpinBox->setValue(axis->getButtonsPresetSensitivity());
     }
     updateAccelerationCurvePresetComboBox();
+    ui->velocityGroupBox->setChecked(axis->getButtonsPresetVelocityAcceleration());
+    ui->velocityGainDoubleSpinBox->setValue(axis->getButtonsPresetVelocityGain());
+    ui->velocityCapDoubleSpinBox->setValue(axis->getButtonsPresetVelocityCap());
+    ui->velocityDecayDoubleSpinBox->setValue(axis->getButtonsPresetVelocityDecay());
 
     setWindowTitle(tr("Mouse Settings - ").append(tr("Axis %1").arg(axis->getRealJoyIndex())));
 
@@ -31,6 +35,11 @@ MouseAxisSettingsDialog::MouseAxisSettingsDialog(JoyAxis *axis, QWidget *parent)
     connect(ui->springHeightSpinBox, SIGNAL(valueChanged(int)), this, SLOT(updateSpringHeight(int)));
 
     connect(ui->sensitivityDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateSensitivity(double)));
+
+    connect(ui->velocityGroupBox, SIGNAL(toggled(bool)), this, SLOT(updateVelocityAcceleration(bool)));
+    connect(ui->velocityGainDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityGain(double)));
+    connect(ui->velocityCapDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityCap(double)));
+    connect(ui->velocityDecayDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityDecay(double)));
 }
 
 void MouseAxisSettingsDialog::changeMouseMode(int index)
@@ -145,6 +154,26 @@ void MouseAxisSettingsDialog::updateSensitivity(double value)
     axis->setButtonsSensitivity(value);
 }
 
+void MouseAxisSettingsDialog::updateVelocityAcceleration(bool enabled)
+{
+    axis->setButtonsVelocityAcceleration(enabled);
+}
+
+void MouseAxisSettingsDialog::updateVelocityGain(double value)
+{
+    axis->setButtonsVelocityGain(value);
+}
+
+void MouseAxisSettingsDialog::updateVelocityCap(double value)
+{
+    axis->setButtonsVelocityCap(value);
+}
+
+void MouseAxisSettingsDialog::updateVelocityDecay(double value)
+{
+    axis->setButtonsVelocityDecay(value);
+}
+
 void MouseAxisSettingsDialog::updateAccelerationCurvePresetComboBox()
 {
     JoyButton::JoyMouseCurve temp = axis->getButtonsPresetMouseCurve();
@@ -27,6 +27,10 @@ public slots:
     void updateSpringWidth(int value);
     void updateSpringHeight(int value);
     void updateSensitivity(double value);
+    void updateVelocityAcceleration(bool enabled);
+    void updateVelocityGain(double value);
+    void updateVelocityCap(double value);
+    void updateVelocityDecay(double value);
     void updateAccelerationCurvePresetComboBox();
 };
 
@@ -19,6 +19,10 @@ MouseButtonSettingsDialog::MouseButtonSettingsDialog(JoyButton *button, QWidget
         ui->sensitivityDoubleSpinBox->setValue(button->getSensitivity());
     }
     updateAccelerationCurvePresetComboBox();
+    ui->velocityGroupBox->setChecked(button->isVelocityAccelerationEnabled());
+    ui->velocityGainDoubleSpinBox->setValue(button->getVelocityGain());
+    ui->velocityCapDoubleSpinBox->setValue(button->getVelocityCap());
+    ui->velocityDecayDoubleSpinBox->setValue(button->getVelocityDecay());
 
     setWindowTitle(tr("Mouse Settings - ").append(tr("Button %1").arg(button->getRealJoyNumber())));
 
@@ -32,6 +36,11 @@ MouseButtonSettingsDialog::MouseButtonSettingsDialog(JoyButton *button, QWidget
     connect(ui->springHeightSpinBox, SIGNAL(valueChanged(int)), this, SLOT(updateSpringHeight(int)));
 
     connect(ui->sensitivityDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateSensitivity(double)));
+
+    connect(ui->velocityGroupBox, SIGNAL(toggled(bool)), this, SLOT(updateVelocityAcceleration(bool)));
+    connect(ui->velocityGainDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityGain(double)));
+    connect(ui->velocityCapDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityCap(double)));
+    connect(ui->velocityDecayDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityDecay(double)));
 }
 
 void MouseButtonSettingsDialog::changeMouseMode(int index)
@@ -133,6 +142,26 @@ void MouseButtonSettingsDialog::updateSensitivity(double value)
     button->setSensitivity(value);
 }
 
+void MouseButtonSettingsDialog::updateVelocityAcceleration(bool enabled)
+{
+    button->setVelocityAcceleration(enabled);
+}
+
+void MouseButtonSettingsDialog::updateVelocityGain(double value)
+{
+    button->setVelocityGain(value);
+}
+
+void MouseButtonSettingsDialog::updateVelocityCap(double value)
+{
+    button->setVelocityCap(value);
+}
+
+void MouseButtonSettingsDialog::updateVelocityDecay(double value)
+{
+    button->setVelocityDecay(value);
+}
+
 void MouseButtonSettingsDialog::updateAccelerationCurvePresetComboBox()
 {
     JoyButton::JoyMouseCurve temp = button->getMouseCurve();
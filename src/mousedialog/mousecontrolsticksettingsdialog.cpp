@@ -20,6 +20,10 @@ MouseControlStickSettingsDialog::MouseControlStickSettingsDialog(JoyControlStick
         ui->sensitivityDoubleSpinBox->setValue(stick->getButtonsPresetSensitivity());
     }
     updateAccelerationCurvePresetComboBox();
+    ui->velocityGroupBox->setChecked(stick->getButtonsPresetVelocityAcceleration());
+    ui->velocityGainDoubleSpinBox->setValue(stick->getButtonsPresetVelocityGain());
+    ui->velocityCapDoubleSpinBox->setValue(stick->getButtonsPresetVelocityCap());
+    ui->velocityDecayDoubleSpinBox->setValue(stick->getButtonsPresetVelocityDecay());
 
     setWindowTitle(tr("Mouse Settings - ").append(tr("Stick %1").arg(stick->getRealJoyIndex())));
 
@@ -33,6 +37,11 @@ MouseControlStickSettingsDialog::MouseControlStickSettingsDialog(JoyControlStick
     connect(ui->springHeightSpinBox, SIGNAL(valueChanged(int)), this, SLOT(updateSpringHeight(int)));
 
     connect(ui->sensitivityDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateSensitivity(double)));
+
+    connect(ui->velocityGroupBox, SIGNAL(toggled(bool)), this, SLOT(updateVelocityAcceleration(bool)));
+    connect(ui->velocityGainDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityGain(double)));
+    connect(ui->velocityCapDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityCap(double)));
+    connect(ui->velocityDecayDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityDecay(double)));
 }
 
 void MouseControlStickSettingsDialog::changeMouseMode(int index)
@@ -165,6 +174,26 @@ void MouseControlStickSettingsDialog::updateSensitivity(double value)
     stick->setButtonsSensitivity(value);
 }
 
+void MouseControlStickSettingsDialog::updateVelocityAcceleration(bool enabled)
+{
+    stick->setButtonsVelocityAcceleration(enabled);
+}
+
+void MouseControlStickSettingsDialog::updateVelocityGain(double value)
+{
+    stick->setButtonsVelocityGain(value);
+}
+
+void MouseControlStickSettingsDialog::updateVelocityCap(double value)
+{
+    stick->setButtonsVelocityCap(value);
+}
+
+void MouseControlStickSettingsDialog::updateVelocityDecay(double value)
+{
+    stick->setButtonsVelocityDecay(value);
+}
+
 void MouseControlStickSettingsDialog::updateAccelerationCurvePresetComboBox()
 {
     JoyButton::JoyMouseCurve temp = stick->getButtonsPresetMouseCurve();
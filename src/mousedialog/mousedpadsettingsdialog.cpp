@@ -18,6 +18,10 @@ MouseDPadSettingsDialog::MouseDPadSettingsDialog(JoyDPad *dpad, QWidget *parent)
         ui->sensitivityDoubleSpinBox->setValue(dpad->getButtonsPresetSensitivity());
     }
     updateAccelerationCurvePresetComboBox();
+    ui->velocityGroupBox->setChecked(dpad->getButtonsPresetVelocityAcceleration());
+    ui->velocityGainDoubleSpinBox->setValue(dpad->getButtonsPresetVelocityGain());
+    ui->velocityCapDoubleSpinBox->setValue(dpad->getButtonsPresetVelocityCap());
+    ui->velocityDecayDoubleSpinBox->setValue(dpad->getButtonsPresetVelocityDecay());
 
     setWindowTitle(tr("Mouse Settings - ").append(tr("DPad %1").arg(dpad->getRealJoyNumber())));
 
@@ -31,6 +35,11 @@ MouseDPadSettingsDialog::MouseDPadSettingsDialog(JoyDPad *dpad, QWidget *parent)
     connect(ui->springHeightSpinBox, SIGNAL(valueChanged(int)), this, SLOT(updateSpringHeight(int)));
 
     connect(ui->sensitivityDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateSensitivity(double)));
+
+    connect(ui->velocityGroupBox, SIGNAL(toggled(bool)), this, SLOT(updateVelocityAcceleration(bool)));
+    connect(ui->velocityGainDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityGain(double)));
+    connect(ui->velocityCapDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityCap(double)));
+    connect(ui->velocityDecayDoubleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateVelocityDecay(double)));
 }
 
 void MouseDPadSettingsDialog::changeMouseMode(int index)
@@ -163,6 +172,26 @@ void MouseDPadSettingsDialog::updateSensitivity(double value)
     dpad->setButtonsSensitivity(value);
 }
 
+void MouseDPadSettingsDialog::updateVelocityAcceleration(bool enabled)
+{
+    dpad->setButtonsVelocityAcceleration(enabled);
+}
+
+void MouseDPadSettingsDialog::updateVelocityGain(double value)
+{
+    dpad->setButtonsVelocityGain(value);
+}
+
+void MouseDPadSettingsDialog::updateVelocityCap(double value)
+{
+    dpad->setButtonsVelocityCap(value);
+}
+
+void MouseDPadSettingsDialog::updateVelocityDecay(double value)
+{
+    dpad->setButtonsVelocityDecay(value);
+}
+
 void MouseDPadSettingsDialog::updateAccelerationCurvePresetComboBox()
 {
     JoyButton::JoyMouseCurve temp = dpad->getButtonsPresetMouseCurve();
@@ -0,0 +1,173 @@
+#include "mousescheduler.h"
+#include "joybutton.h"
+#include "event.h"
+#include "common.h"
+
+const int MouseScheduler::DEFAULTRATE = 250;
+const int MouseScheduler::MINRATE = 60;
+const int MouseScheduler::MAXRATE = 1000;
+
+MouseTickTimer::MouseTickTimer(MouseScheduler *scheduler) :
+    WheelTimer(0, 0)
+{
+    this->scheduler = scheduler;
+}
+
+void MouseTickTimer::fire()
+{
+    scheduler->tick();
+}
+
+MouseScheduler::MouseScheduler(QObject *parent) :
+    QObject(parent),
+    tickTimer(this)
+{
+    nextTick = 0;
+    pendingX = 0;
+    pendingY = 0;
+    springPending = false;
+    springX = -2.0;
+    springY = -2.0;
+    springWidth = 0;
+    springHeight = 0;
+
+    setRate(DEFAULTRATE);
+
+    resetStatistics();
+}
+
+MouseScheduler* MouseScheduler::getInstance()
+{
+    static MouseScheduler scheduler;
+    return &scheduler;
+}
+
+// Start polling a button on every tick. The timer only runs
+// while at least one button is registered
+void MouseScheduler::addButton(JoyButton *button)
+{
+    if (!buttons.contains(button))
+    {
+        buttons.append(button);
+    }
+
+    if (!tickTimer.isActive())
+    {
+        nextTick = PadderCommon::getMonotonicTime() + tickInterval;
+        tickTimer.startAt(nextTick);
+    }
+}
+
+void MouseScheduler::removeButton(JoyButton *button)
+{
+    buttons.removeAll(button);
+    if (buttons.isEmpty())
+    {
+        tickTimer.stop();
+    }
+}
+
+// Called by buttons while they are polled during a tick
+void MouseScheduler::addRelativeMotion(int dx, int dy)
+{
+    pendingX += dx;
+    pendingY += dy;
+}
+
+/* Spring mode coordinates use -2.0 for an axis that should be left
+ * alone. Buttons only ever set one axis so the X and Y values from
+ * different buttons are merged into one warp.
+ */
+void MouseScheduler::addSpringMotion(double xcoor, double ycoor, int springWidth, int springHeight)
+{
+    if (xcoor >= -1.0)
+    {
+        springX = xcoor;
+    }
+
+    if (ycoor >= -1.0)
+    {
+        springY = ycoor;
+    }
+
+    this->springWidth = springWidth;
+    this->springHeight = springHeight;
+    springPending = true;
+}
+
+/* Ticks are scheduled on the timer wheel with nanosecond deadlines
+ * so any rate is kept exactly instead of being rounded to a whole
+ * number of milliseconds between ticks.
+ */
+void MouseScheduler::setRate(int rate)
+{
+    this->rate = qBound(MINRATE, rate, MAXRATE);
+    tickInterval = 1000000000LL / this->rate;
+}
+
+int MouseScheduler::getRate()
+{
+    return rate;
+}
+
+void MouseScheduler::tick()
+{
+    // Keep the ticks on a fixed grid. Skip the ticks that were
+    // missed instead of running them back to back
+    qint64 currentTime = PadderCommon::getMonotonicTime();
+    nextTick += tickInterval;
+    if (nextTick <= currentTime)
+    {
+        nextTick = currentTime + tickInterval;
+    }
+
+    tickTimer.startAt(nextTick);
+
+    pendingX = 0;
+    pendingY = 0;
+    springPending = false;
+    springX = -2.0;
+    springY = -2.0;
+
+    // Iterate over a copy. Buttons remove themselves once
+    // they no longer have an active movement slot
+    QList<JoyButton*> tempbuttons = buttons;
+    QListIterator<JoyButton*> iter(tempbuttons);
+    while (iter.hasNext())
+    {
+        JoyButton *button = iter.next();
+        button->mouseEvent();
+    }
+
+    if (pendingX != 0 || pendingY != 0)
+    {
+        sendevent(pendingX, pendingY);
+        motionCount++;
+    }
+
+    if (springPending)
+    {
+        sendSpringEvent(springX, springY, springWidth, springHeight);
+        motionCount++;
+    }
+
+    tickCount++;
+}
+
+void MouseScheduler::writeStatistics(QTextStream &out)
+{
+    double elapsed = (PadderCommon::getMonotonicTime() - statisticsStart) / 1000000000.0;
+    double tickRate = elapsed > 0.0 ? tickCount / elapsed : 0.0;
+
+    out << tr("Mouse rate:") << " " << rate << endl;
+    out << tr("Mouse ticks:") << " " << tickCount << endl;
+    out << tr("Mouse ticks per second:") << " " << tickRate << endl;
+    out << tr("Mouse motion events:") << " " << motionCount << endl;
+}
+
+void MouseScheduler::resetStatistics()
+{
+    tickCount = 0;
+    motionCount = 0;
+    statisticsStart = PadderCommon::getMonotonicTime();
+}
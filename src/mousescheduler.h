@@ -0,0 +1,77 @@
+#ifndef MOUSESCHEDULER_H
+#define MOUSESCHEDULER_H
+
+#include <QObject>
+#include <QList>
+#include <QTextStream>
+
+#include "timerwheel.h"
+
+class JoyButton;
+class MouseScheduler;
+
+// Wheel timer that runs the ticks of a MouseScheduler
+class MouseTickTimer : public WheelTimer
+{
+public:
+    explicit MouseTickTimer(MouseScheduler *scheduler);
+
+protected:
+    virtual void fire();
+
+    MouseScheduler *scheduler;
+};
+
+/* Drives mouse movement for every button that has an active mouse
+ * movement slot. Buttons are polled once per tick and the movement
+ * they produce is summed so a single relative motion event, or a
+ * single spring mode warp, is generated per tick.
+ */
+class MouseScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MouseScheduler(QObject *parent = 0);
+
+    void addButton(JoyButton *button);
+    void removeButton(JoyButton *button);
+    void addRelativeMotion(int dx, int dy);
+    void addSpringMotion(double xcoor, double ycoor, int springWidth, int springHeight);
+    void setRate(int rate);
+    int getRate();
+    void writeStatistics(QTextStream &out);
+    void resetStatistics();
+
+    static MouseScheduler* getInstance();
+
+    static const int DEFAULTRATE;
+    static const int MINRATE;
+    static const int MAXRATE;
+
+protected:
+    MouseTickTimer tickTimer;
+    QList<JoyButton*> buttons;
+    int rate;
+    // Time between ticks and deadline of the next tick in nanoseconds
+    qint64 tickInterval;
+    qint64 nextTick;
+
+    int pendingX;
+    int pendingY;
+    bool springPending;
+    double springX;
+    double springY;
+    int springWidth;
+    int springHeight;
+
+    int tickCount;
+    int motionCount;
+    qint64 statisticsStart;
+
+signals:
+
+public slots:
+    void tick();
+};
+
+#endif // MOUSESCHEDULER_H
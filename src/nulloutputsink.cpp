@@ -0,0 +1,49 @@
+#include <QtGlobal>
+
+#include "nulloutputsink.h"
+
+const int NullOutputSink::DEFAULTWIDTH = 1920;
+const int NullOutputSink::DEFAULTHEIGHT = 1080;
+
+NullOutputSink::NullOutputSink(int width, int height)
+{
+    this->screenWidth = width;
+    this->screenHeight = height;
+    this->pointerX = width / 2;
+    this->pointerY = height / 2;
+}
+
+void NullOutputSink::sendButtonEvent(int code, bool pressed, JoyButtonSlot::JoySlotInputAction device)
+{
+    Q_UNUSED(code);
+    Q_UNUSED(pressed);
+    Q_UNUSED(device);
+}
+
+void NullOutputSink::sendRelativeMotion(int dx, int dy)
+{
+    pointerX = qBound(0, pointerX + dx, screenWidth - 1);
+    pointerY = qBound(0, pointerY + dy, screenHeight - 1);
+}
+
+void NullOutputSink::sendAbsoluteMotion(int x, int y)
+{
+    pointerX = qBound(0, x, screenWidth - 1);
+    pointerY = qBound(0, y, screenHeight - 1);
+}
+
+void NullOutputSink::getPointerPosition(int &x, int &y)
+{
+    x = pointerX;
+    y = pointerY;
+}
+
+void NullOutputSink::getScreenSize(int &width, int &height)
+{
+    width = screenWidth;
+    height = screenHeight;
+}
+
+void NullOutputSink::flush()
+{
+}
@@ -0,0 +1,31 @@
+#ifndef NULLOUTPUTSINK_H
+#define NULLOUTPUTSINK_H
+
+#include "outputsink.h"
+
+/* Discards all output. The pointer position is still tracked on
+ * a virtual screen so spring mode behaves like it does under X.
+ */
+class NullOutputSink : public OutputSink
+{
+public:
+    explicit NullOutputSink(int width=DEFAULTWIDTH, int height=DEFAULTHEIGHT);
+
+    virtual void sendButtonEvent(int code, bool pressed, JoyButtonSlot::JoySlotInputAction device);
+    virtual void sendRelativeMotion(int dx, int dy);
+    virtual void sendAbsoluteMotion(int x, int y);
+    virtual void getPointerPosition(int &x, int &y);
+    virtual void getScreenSize(int &width, int &height);
+    virtual void flush();
+
+    static const int DEFAULTWIDTH;
+    static const int DEFAULTHEIGHT;
+
+protected:
+    int screenWidth;
+    int screenHeight;
+    int pointerX;
+    int pointerY;
+};
+
+#endif // NULLOUTPUTSINK_H
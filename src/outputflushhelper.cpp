@@ -0,0 +1,86 @@
+#include "outputflushhelper.h"
+#include "outputsink.h"
+#include "common.h"
+
+OutputFlushHelper::OutputFlushHelper(QObject *parent) :
+    QObject(parent)
+{
+    batching = false;
+    pendingRequests = 0;
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(0);
+    connect(&flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+
+    resetStatistics();
+}
+
+// Called after every request written to the current sink
+void OutputFlushHelper::requestSent()
+{
+    pendingRequests++;
+
+    if (!batching)
+    {
+        flush();
+    }
+    else if (!flushTimer.isActive())
+    {
+        flushTimer.start();
+    }
+}
+
+void OutputFlushHelper::flush()
+{
+    flushTimer.stop();
+
+    if (pendingRequests > 0)
+    {
+        OutputSink::getInstance()->flush();
+
+        flushCount++;
+        requestCount += pendingRequests;
+        if (pendingRequests > largestFlush)
+        {
+            largestFlush = pendingRequests;
+        }
+
+        pendingRequests = 0;
+    }
+}
+
+void OutputFlushHelper::setBatching(bool enabled)
+{
+    if (!enabled && batching)
+    {
+        flush();
+    }
+
+    batching = enabled;
+}
+
+bool OutputFlushHelper::isBatching()
+{
+    return batching;
+}
+
+void OutputFlushHelper::writeStatistics(QTextStream &out)
+{
+    double elapsed = (PadderCommon::getMonotonicTime() - statisticsStart) / 1000000000.0;
+    double flushRate = elapsed > 0.0 ? flushCount / elapsed : 0.0;
+    double averageFlush = flushCount > 0 ? requestCount / (double)flushCount : 0.0;
+
+    out << tr("Output batching:") << " " << (batching ? tr("enabled") : tr("disabled")) << endl;
+    out << tr("Output requests:") << " " << requestCount << endl;
+    out << tr("Output flushes:") << " " << flushCount << endl;
+    out << tr("Output flushes per second:") << " " << flushRate << endl;
+    out << tr("Average requests per flush:") << " " << averageFlush << endl;
+    out << tr("Largest flush:") << " " << largestFlush << endl;
+}
+
+void OutputFlushHelper::resetStatistics()
+{
+    flushCount = 0;
+    requestCount = 0;
+    largestFlush = 0;
+    statisticsStart = PadderCommon::getMonotonicTime();
+}
@@ -0,0 +1,42 @@
+#ifndef OUTPUTFLUSHHELPER_H
+#define OUTPUTFLUSHHELPER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QTextStream>
+
+/* Decides when requests written to the current OutputSink are
+ * flushed. Without batching every request is flushed right away.
+ * With batching a flush is queued for the next pass of the event
+ * loop so every request caused by one batch of controller events
+ * goes out with a single flush.
+ */
+class OutputFlushHelper : public QObject
+{
+    Q_OBJECT
+public:
+    explicit OutputFlushHelper(QObject *parent = 0);
+
+    void requestSent();
+    void setBatching(bool enabled);
+    bool isBatching();
+    void writeStatistics(QTextStream &out);
+    void resetStatistics();
+
+protected:
+    QTimer flushTimer;
+    bool batching;
+    int pendingRequests;
+
+    int flushCount;
+    int requestCount;
+    int largestFlush;
+    qint64 statisticsStart;
+
+signals:
+
+public slots:
+    void flush();
+};
+
+#endif // OUTPUTFLUSHHELPER_H
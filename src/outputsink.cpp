@@ -0,0 +1,31 @@
+#include "outputsink.h"
+#include "x11outputsink.h"
+
+OutputSink* OutputSink::currentSink = 0;
+
+OutputSink::~OutputSink()
+{
+}
+
+/* Return the sink set with setInstance. Output goes to the X
+ * server when no sink has been set.
+ */
+OutputSink* OutputSink::getInstance()
+{
+    static X11OutputSink defaultSink;
+
+    OutputSink *sink = currentSink;
+    if (!sink)
+    {
+        sink = &defaultSink;
+    }
+
+    return sink;
+}
+
+/* The sink is not owned. Pass 0 to go back to the X server.
+ */
+void OutputSink::setInstance(OutputSink *sink)
+{
+    currentSink = sink;
+}
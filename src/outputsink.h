@@ -0,0 +1,30 @@
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+
+#include "joybuttonslot.h"
+
+/* Destination of every key, mouse button and mouse movement event
+ * generated by the mapping engine. The functions in event.cpp write
+ * to the current sink so output can be sent somewhere other than
+ * the X server.
+ */
+class OutputSink
+{
+public:
+    virtual ~OutputSink();
+
+    virtual void sendButtonEvent(int code, bool pressed, JoyButtonSlot::JoySlotInputAction device) = 0;
+    virtual void sendRelativeMotion(int dx, int dy) = 0;
+    virtual void sendAbsoluteMotion(int x, int y) = 0;
+    virtual void getPointerPosition(int &x, int &y) = 0;
+    virtual void getScreenSize(int &width, int &height) = 0;
+    virtual void flush() = 0;
+
+    static OutputSink* getInstance();
+    static void setInstance(OutputSink *sink);
+
+protected:
+    static OutputSink *currentSink;
+};
+
+#endif // OUTPUTSINK_H
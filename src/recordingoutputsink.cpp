@@ -0,0 +1,90 @@
+#include <QListIterator>
+
+#include "recordingoutputsink.h"
+#include "common.h"
+
+RecordingOutputSink::RecordingOutputSink(int width, int height) :
+    NullOutputSink(width, height)
+{
+    startTime = PadderCommon::getMonotonicTime();
+}
+
+void RecordingOutputSink::sendButtonEvent(int code, bool pressed, JoyButtonSlot::JoySlotInputAction device)
+{
+    if (device == JoyButtonSlot::JoyKeyboard)
+    {
+        appendEvent(KeyOutput, code, pressed ? 1 : 0);
+    }
+    else if (device == JoyButtonSlot::JoyMouseButton)
+    {
+        appendEvent(MouseButtonOutput, code, pressed ? 1 : 0);
+    }
+}
+
+void RecordingOutputSink::sendRelativeMotion(int dx, int dy)
+{
+    NullOutputSink::sendRelativeMotion(dx, dy);
+    appendEvent(RelativeMotionOutput, dx, dy);
+}
+
+void RecordingOutputSink::sendAbsoluteMotion(int x, int y)
+{
+    NullOutputSink::sendAbsoluteMotion(x, y);
+    appendEvent(AbsoluteMotionOutput, x, y);
+}
+
+QList<RecordingOutputSink::OutputEvent>* RecordingOutputSink::getEvents()
+{
+    return &events;
+}
+
+void RecordingOutputSink::clear()
+{
+    events.clear();
+    startTime = PadderCommon::getMonotonicTime();
+}
+
+/* Write one line per output event. Times are in microseconds since
+ * the sink was created or last cleared. Leave them out to get a
+ * trace that only depends on the input and the profile.
+ */
+void RecordingOutputSink::writeTrace(QTextStream &out, bool includeTimes)
+{
+    QListIterator<OutputEvent> iter(events);
+    while (iter.hasNext())
+    {
+        const OutputEvent &event = iter.next();
+        if (includeTimes)
+        {
+            out << (event.timestamp - startTime) / 1000 << " ";
+        }
+
+        switch (event.type)
+        {
+            case KeyOutput:
+                out << "key";
+                break;
+            case MouseButtonOutput:
+                out << "mousebutton";
+                break;
+            case RelativeMotionOutput:
+                out << "move";
+                break;
+            case AbsoluteMotionOutput:
+                out << "moveto";
+                break;
+        }
+
+        out << " " << event.code << " " << event.value << endl;
+    }
+}
+
+void RecordingOutputSink::appendEvent(OutputEventType type, int code, int value)
+{
+    OutputEvent event;
+    event.timestamp = PadderCommon::getMonotonicTime();
+    event.type = type;
+    event.code = code;
+    event.value = value;
+    events.append(event);
+}
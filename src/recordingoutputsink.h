@@ -0,0 +1,43 @@
+#ifndef RECORDINGOUTPUTSINK_H
+#define RECORDINGOUTPUTSINK_H
+
+#include <QList>
+#include <QTextStream>
+
+#include "nulloutputsink.h"
+
+/* Keeps every output event in memory along with the monotonic time
+ * it was generated at. The trace can be written out as text and
+ * compared against a known good trace.
+ */
+class RecordingOutputSink : public NullOutputSink
+{
+public:
+    enum OutputEventType {KeyOutput=0, MouseButtonOutput, RelativeMotionOutput, AbsoluteMotionOutput};
+
+    struct OutputEvent
+    {
+        qint64 timestamp;
+        OutputEventType type;
+        int code;
+        int value;
+    };
+
+    explicit RecordingOutputSink(int width=DEFAULTWIDTH, int height=DEFAULTHEIGHT);
+
+    virtual void sendButtonEvent(int code, bool pressed, JoyButtonSlot::JoySlotInputAction device);
+    virtual void sendRelativeMotion(int dx, int dy);
+    virtual void sendAbsoluteMotion(int x, int y);
+
+    QList<OutputEvent>* getEvents();
+    void clear();
+    void writeTrace(QTextStream &out, bool includeTimes=true);
+
+protected:
+    void appendEvent(OutputEventType type, int code, int value);
+
+    QList<OutputEvent> events;
+    qint64 startTime;
+};
+
+#endif // RECORDINGOUTPUTSINK_H
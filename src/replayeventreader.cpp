@@ -0,0 +1,109 @@
+#include <QFile>
+#include <QDataStream>
+
+#include "replayeventreader.h"
+#include "common.h"
+
+ReplayEventReader::ReplayEventReader(QHash<int, Joystick*> *joysticks, QString path, bool realTime, QObject *parent) :
+    SDLEventReader(joysticks, parent)
+{
+    this->path = path;
+    this->realTime = realTime;
+    this->valid = false;
+
+    // Controllers have to be known before InputDaemon creates joysticks
+    QFile replayFile(path);
+    if (replayFile.open(QIODevice::ReadOnly))
+    {
+        QDataStream replayStream(&replayFile);
+        valid = EventRecorder::readHeader(replayStream, devices);
+        replayFile.close();
+    }
+}
+
+QList<RecordedDevice> ReplayEventReader::getDevices()
+{
+    return devices;
+}
+
+bool ReplayEventReader::isValid()
+{
+    return valid;
+}
+
+/* Push every recorded event into the ring. Once the recording is
+ * exhausted the reader waits for stop() like the other readers wait
+ * for SDL_QUIT so InputDaemon can shut down the same way.
+ */
+void ReplayEventReader::performWork()
+{
+    stopRequested.fetchAndStoreRelaxed(0);
+    while (stopSemaphore.tryAcquire())
+    {
+    }
+
+    QFile replayFile(path);
+    if (valid && replayFile.open(QIODevice::ReadOnly))
+    {
+        QDataStream replayStream(&replayFile);
+        QList<RecordedDevice> tempdevices;
+        EventRecorder::readHeader(replayStream, tempdevices);
+
+        qint64 startTime = PadderCommon::getMonotonicTime();
+        qint64 eventTime = 0;
+        SDL_Event event;
+
+        while (!stopRequested.fetchAndAddRelaxed(0) && EventRecorder::readEvent(replayStream, eventTime, event))
+        {
+            if (realTime)
+            {
+                qint64 remaining = startTime + eventTime - PadderCommon::getMonotonicTime();
+                if (remaining > 0)
+                {
+                    // Hand over what is queued before waiting for the next event
+                    if (eventRing.markPending())
+                    {
+                        emit eventRaised();
+                    }
+
+                    int waitms = (int)((remaining + 999999) / 1000000);
+                    stopSemaphore.tryAcquire(1, waitms);
+                }
+            }
+
+            if (!stopRequested.fetchAndAddRelaxed(0))
+            {
+                pushEvent(event, PadderCommon::getMonotonicTime());
+            }
+        }
+
+        replayFile.close();
+    }
+
+    if (eventRing.markPending())
+    {
+        emit eventRaised();
+    }
+
+    if (!stopRequested.fetchAndAddRelaxed(0))
+    {
+        emit replayFinished();
+        stopSemaphore.acquire();
+    }
+
+    SDL_Event quitEvent;
+    quitEvent.type = SDL_QUIT;
+    pushEvent(quitEvent, PadderCommon::getMonotonicTime());
+    if (eventRing.markPending())
+    {
+        emit eventRaised();
+    }
+
+    emit finished();
+}
+
+void ReplayEventReader::stop()
+{
+    stopRequested.fetchAndStoreRelaxed(1);
+    stopSemaphore.release();
+}
@@ -0,0 +1,43 @@
+#ifndef REPLAYEVENTREADER_H
+#define REPLAYEVENTREADER_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QAtomicInt>
+#include <QSemaphore>
+
+#include "sdleventreader.h"
+#include "eventrecorder.h"
+
+/* Reader that feeds InputDaemon from a file written by EventRecorder
+ * instead of from controllers. Events are either replayed with their
+ * original timing or pushed as fast as InputDaemon takes them.
+ */
+class ReplayEventReader : public SDLEventReader
+{
+    Q_OBJECT
+public:
+    explicit ReplayEventReader(QHash<int, Joystick*> *joysticks, QString path, bool realTime=true, QObject *parent = 0);
+
+    QList<RecordedDevice> getDevices();
+    bool isValid();
+
+protected:
+    QString path;
+    bool realTime;
+    bool valid;
+    QList<RecordedDevice> devices;
+    QAtomicInt stopRequested;
+    QSemaphore stopSemaphore;
+
+signals:
+    void replayFinished();
+
+public slots:
+    virtual void performWork();
+    virtual void stop();
+};
+
+#endif // REPLAYEVENTREADER_H
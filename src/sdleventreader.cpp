@@ -1,4 +1,5 @@
 #include "sdleventreader.h"
+#include "common.h"
 
 SDLEventReader::SDLEventReader(QHash<int, Joystick*> *joysticks, QObject *parent) :
     QObject(parent)
@@ -42,22 +43,66 @@ void SDLEventReader::closeSDL()
     sdlIsOpen = false;
 }
 
+/* Wait for the next SDL event and then grab everything else that
+ * is already queued so InputDaemon can handle the whole batch in
+ * one pass. The loop keeps running until an SDL_QUIT event is seen
+ * so no queued signal round trip is needed between events.
+ */
 void SDLEventReader::performWork()
 {
-    if (sdlIsOpen)
+    bool quit = false;
+    bool waitError = false;
+
+    while (sdlIsOpen && !quit && !waitError)
     {
         SDL_Event event;
 
         int status = SDL_WaitEvent(&event);
         if (status)
         {
-            currentEvent = event;
-            emit eventRaised();
-            if (event.type == SDL_QUIT)
+            qint64 timestamp = PadderCommon::getMonotonicTime();
+
+            do
+            {
+                pushEvent(event, timestamp);
+                if (event.type == SDL_QUIT)
+                {
+                    quit = true;
+                }
+            }
+            while (!quit && SDL_PollEvent(&event) > 0);
+
+            if (eventRing.markPending())
             {
-                emit finished();
+                emit eventRaised();
             }
         }
+        else
+        {
+            waitError = true;
+        }
+    }
+
+    if (quit)
+    {
+        emit finished();
+    }
+}
+
+/* Push an event into the ring. If the ring is full, wait for
+ * InputDaemon to catch up rather than dropping the event.
+ */
+void SDLEventReader::pushEvent(SDL_Event &event, qint64 timestamp)
+{
+    while (!eventRing.push(event, timestamp))
+    {
+        eventRing.recordOverflow();
+        if (eventRing.markPending())
+        {
+            emit eventRaised();
+        }
+
+        SDL_Delay(1);
     }
 }
 
@@ -71,9 +116,9 @@ void SDLEventReader::stop()
     }
 }
 
-SDL_Event& SDLEventReader::getCurrentEvent()
+SDLEventRing* SDLEventReader::getEventRing()
 {
-    return currentEvent;
+    return &eventRing;
 }
 
 void SDLEventReader::refresh()
@@ -97,6 +142,21 @@ void SDLEventReader::secondaryRefresh()
     initSDL();
 }
 
+/* Restart only the SDL joystick subsystem so controllers that
+ * were connected or removed are enumerated again. Must only be
+ * called while performWork is not running. Every SDL_Joystick
+ * handle opened before the call is invalid afterwards.
+ */
+void SDLEventReader::resetJoysticks()
+{
+    if (sdlIsOpen)
+    {
+        SDL_QuitSubSystem(SDL_INIT_JOYSTICK);
+        SDL_InitSubSystem(SDL_INIT_JOYSTICK);
+        SDL_JoystickEventState(SDL_ENABLE);
+    }
+}
+
 void SDLEventReader::clearEvents()
 {
     if (sdlIsOpen)
@@ -6,6 +6,7 @@
 #include <SDL/SDL.h>
 
 #include "joystick.h"
+#include "sdleventring.h"
 
 class SDLEventReader : public QObject
 {
@@ -13,16 +14,18 @@ class SDLEventReader : public QObject
 public:
     explicit SDLEventReader(QHash<int, Joystick*> *joysticks, QObject *parent = 0);
     ~SDLEventReader();
-    SDL_Event& getCurrentEvent();
+    SDLEventRing* getEventRing();
     bool isSDLOpen();
+    void resetJoysticks();
 
 protected:
     void initSDL();
     void closeSDL();
     void clearEvents();
+    void pushEvent(SDL_Event &event, qint64 timestamp);
 
     QHash<int, Joystick*> *joysticks;
-    SDL_Event currentEvent;
+    SDLEventRing eventRing;
     bool sdlIsOpen;
 
 signals:
@@ -31,8 +34,8 @@ signals:
     void sdlStarted();
 
 public slots:
-    void performWork();
-    void stop();
+    virtual void performWork();
+    virtual void stop();
     void refresh();
 
 private slots:
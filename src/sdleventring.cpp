@@ -0,0 +1,144 @@
+#include "sdleventring.h"
+
+const int SDLEventRing::DEFAULTCAPACITY = 1024;
+
+SDLEventRing::SDLEventRing(int capacity)
+{
+    // Round capacity up to a power of two so indices can be masked
+    int tempcapacity = 2;
+    while (tempcapacity < capacity)
+    {
+        tempcapacity = tempcapacity << 1;
+    }
+
+    events.resize(tempcapacity);
+    mask = tempcapacity - 1;
+    readIndex = 0;
+    writeIndex = 0;
+    pending = 0;
+
+    resetStatistics();
+}
+
+/* One slot is always kept empty to tell a full ring apart
+ * from an empty one. Returns false if the ring is full.
+ */
+bool SDLEventRing::push(const SDL_Event &event, qint64 timestamp)
+{
+    bool result = false;
+
+    int currentWrite = writeIndex.fetchAndAddRelaxed(0);
+    int nextWrite = (currentWrite + 1) & mask;
+    if (nextWrite != readIndex.fetchAndAddAcquire(0))
+    {
+        TimedSDLEvent &entry = events[currentWrite];
+        entry.event = event;
+        entry.timestamp = timestamp;
+        writeIndex.fetchAndStoreRelease(nextWrite);
+        result = true;
+    }
+
+    return result;
+}
+
+/* Copy every event currently queued, up to maxEvents, into
+ * the passed buffer. Returns the number of events copied.
+ */
+int SDLEventRing::drain(TimedSDLEvent *events, int maxEvents)
+{
+    int count = 0;
+    int currentRead = readIndex.fetchAndAddRelaxed(0);
+    int currentWrite = writeIndex.fetchAndAddAcquire(0);
+
+    while (currentRead != currentWrite && count < maxEvents)
+    {
+        events[count] = this->events.at(currentRead);
+        currentRead = (currentRead + 1) & mask;
+        count++;
+    }
+
+    if (count > 0)
+    {
+        readIndex.fetchAndStoreRelease(currentRead);
+
+        batchCount++;
+        eventCount += count;
+        if (count > largestBatchSize)
+        {
+            largestBatchSize = count;
+        }
+    }
+
+    return count;
+}
+
+int SDLEventRing::getCapacity()
+{
+    return mask;
+}
+
+bool SDLEventRing::isEmpty()
+{
+    return readIndex.fetchAndAddAcquire(0) == writeIndex.fetchAndAddAcquire(0);
+}
+
+/* Called by the producer after pushing a batch. Returns true
+ * if the consumer has to be notified; false if a notification
+ * is already waiting to be handled.
+ */
+bool SDLEventRing::markPending()
+{
+    return pending.testAndSetOrdered(0, 1);
+}
+
+/* Called by the consumer before draining the ring so that
+ * events pushed during the drain cause a new notification.
+ */
+void SDLEventRing::clearPending()
+{
+    pending.fetchAndStoreOrdered(0);
+}
+
+void SDLEventRing::recordOverflow()
+{
+    overflowCount.fetchAndAddRelaxed(1);
+}
+
+int SDLEventRing::getOverflowCount()
+{
+    return overflowCount.fetchAndAddRelaxed(0);
+}
+
+int SDLEventRing::getBatchCount()
+{
+    return batchCount;
+}
+
+int SDLEventRing::getEventCount()
+{
+    return eventCount;
+}
+
+int SDLEventRing::getLargestBatchSize()
+{
+    return largestBatchSize;
+}
+
+double SDLEventRing::getAverageBatchSize()
+{
+    double average = 0.0;
+    if (batchCount > 0)
+    {
+        average = eventCount / (double)batchCount;
+    }
+
+    return average;
+}
+
+void SDLEventRing::resetStatistics()
+{
+    overflowCount.fetchAndStoreRelaxed(0);
+    batchCount = 0;
+    eventCount = 0;
+    largestBatchSize = 0;
+}
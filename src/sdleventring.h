@@ -0,0 +1,60 @@
+#ifndef SDLEVENTRING_H
+#define SDLEVENTRING_H
+
+#include <QAtomicInt>
+#include <QVector>
+#include <SDL/SDL.h>
+
+// SDL event along with the monotonic time, in nanoseconds,
+// at which the event was generated
+struct TimedSDLEvent
+{
+    SDL_Event event;
+    qint64 timestamp;
+};
+
+/* Bounded single producer/single consumer queue used to hand
+ * batches of SDL events from the reader thread to InputDaemon.
+ * push() may only be called from the reader thread and drain()
+ * may only be called from the thread that owns InputDaemon.
+ */
+class SDLEventRing
+{
+public:
+    explicit SDLEventRing(int capacity=DEFAULTCAPACITY);
+
+    bool push(const SDL_Event &event, qint64 timestamp);
+    int drain(TimedSDLEvent *events, int maxEvents);
+    int getCapacity();
+    bool isEmpty();
+
+    bool markPending();
+    void clearPending();
+
+    void recordOverflow();
+    int getOverflowCount();
+    int getBatchCount();
+    int getEventCount();
+    int getLargestBatchSize();
+    double getAverageBatchSize();
+    void resetStatistics();
+
+    static const int DEFAULTCAPACITY;
+
+protected:
+    QVector<TimedSDLEvent> events;
+    int mask;
+    // Next slot to be read. Only written by the consumer
+    QAtomicInt readIndex;
+    // Next slot to be written. Only written by the producer
+    QAtomicInt writeIndex;
+    // Set while a notification is waiting to be handled by the consumer
+    QAtomicInt pending;
+
+    QAtomicInt overflowCount;
+    int batchCount;
+    int eventCount;
+    int largestBatchSize;
+};
+
+#endif // SDLEVENTRING_H
@@ -8,6 +8,23 @@ SetJoystick::SetJoystick(SDL_Joystick *joyhandle, int index, QObject *parent) :
 {
     this->joyhandle = joyhandle;
     this->index = index;
+    this->hardwareButtons = SDL_JoystickNumButtons(joyhandle);
+    this->hardwareAxes = SDL_JoystickNumAxes(joyhandle);
+    this->hardwareHats = SDL_JoystickNumHats(joyhandle);
+    this->reset();
+}
+
+/* Create a set for a controller that is not opened through SDL,
+ * such as one built by a benchmark.
+ */
+SetJoystick::SetJoystick(int buttons, int axes, int hats, int index, QObject *parent) :
+    QObject(parent)
+{
+    this->joyhandle = 0;
+    this->index = index;
+    this->hardwareButtons = buttons;
+    this->hardwareAxes = axes;
+    this->hardwareHats = hats;
     this->reset();
 }
 
@@ -49,7 +66,7 @@ void SetJoystick::refreshButtons()
 {
     deleteButtons();
 
-    for (int i=0; i < SDL_JoystickNumButtons(joyhandle); i++)
+    for (int i=0; i < hardwareButtons; i++)
     {
         JoyButton *button = new JoyButton (i, index, this);
         buttons.insert(i, button);
@@ -62,7 +79,7 @@ void SetJoystick::refreshAxes()
 {
     deleteAxes();
 
-    for (int i=0; i < SDL_JoystickNumAxes(joyhandle); i++)
+    for (int i=0; i < hardwareAxes; i++)
     {
         JoyAxis *axis = new JoyAxis(i, index, this);
         axes.insert(i, axis);
@@ -83,7 +100,7 @@ void SetJoystick::refreshHats()
 {
     deleteHats();
 
-    for (int i=0; i < SDL_JoystickNumHats(joyhandle); i++)
+    for (int i=0; i < hardwareHats; i++)
     {
         JoyDPad *dpad = new JoyDPad(i, index, this);
         hats.insert(i, dpad);
@@ -304,6 +321,14 @@ SDL_Joystick* SetJoystick::getSDLHandle()
     return joyhandle;
 }
 
+void SetJoystick::setSDLHandle(SDL_Joystick *joyhandle)
+{
+    this->joyhandle = joyhandle;
+    this->hardwareButtons = SDL_JoystickNumButtons(joyhandle);
+    this->hardwareAxes = SDL_JoystickNumAxes(joyhandle);
+    this->hardwareHats = SDL_JoystickNumHats(joyhandle);
+}
+
 void SetJoystick::propogateSetChange(int index)
 {
     emit setChangeActivated(index);
@@ -354,7 +379,7 @@ void SetJoystick::release()
     while (iter2.hasNext())
     {
         JoyAxis *axis = iter2.next().value();
-        axis->joyEvent(axis->getCurrentThrottledDeadValue(), true);
+        axis->release(true);
     }
 
     QHashIterator<int, JoyDPad*> iter3(hats);
@@ -18,9 +18,11 @@ class SetJoystick : public QObject
     Q_OBJECT
 public:
     explicit SetJoystick(SDL_Joystick *joyhandle, int index, QObject *parent=0);
+    explicit SetJoystick(int buttons, int axes, int hats, int index, QObject *parent=0);
     ~SetJoystick();
 
     SDL_Joystick* getSDLHandle ();
+    void setSDLHandle(SDL_Joystick *joyhandle);
     JoyAxis* getJoyAxis(int index);
     JoyButton* getJoyButton(int index);
     JoyDPad* getJoyDPad(int index);
@@ -62,6 +64,10 @@ protected:
 
     int index;
     SDL_Joystick* joyhandle;
+    // Number of elements reported by the controller
+    int hardwareButtons;
+    int hardwareAxes;
+    int hardwareHats;
 
 signals:
     void setChangeActivated(int index);
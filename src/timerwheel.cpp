@@ -0,0 +1,469 @@
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#include "timerwheel.h"
+#include "joybutton.h"
+#include "common.h"
+
+// Length of a tick of the root wheel in nanoseconds
+const qint64 TimerWheel::TICKLENGTH = 1000000;
+const int TimerWheel::ROOTBITS = 8;
+const int TimerWheel::LEVELBITS = 6;
+const int TimerWheel::UPPERLEVELS = 3;
+
+WheelTimer::WheelTimer(JoyButton *owner, WheelTimerHandler handler)
+{
+    this->owner = owner;
+    this->handler = handler;
+    timerInterval = 0;
+    deadline = 0;
+    active = false;
+    previous = 0;
+    next = 0;
+    listHead = 0;
+}
+
+WheelTimer::~WheelTimer()
+{
+    stop();
+}
+
+// Restart the timer using the current interval
+void WheelTimer::start()
+{
+    startAt(PadderCommon::getMonotonicTime() + timerInterval * TimerWheel::TICKLENGTH);
+}
+
+void WheelTimer::start(int msec)
+{
+    timerInterval = qMax(0, msec);
+    start();
+}
+
+/* Fire once at an absolute monotonic time in nanoseconds. Once it
+ * fires the timer repeats using its interval like start() would.
+ */
+void WheelTimer::startAt(qint64 deadline)
+{
+    if (active)
+    {
+        TimerWheel::getInstance()->cancel(this);
+    }
+
+    this->deadline = deadline;
+    TimerWheel::getInstance()->schedule(this);
+}
+
+void WheelTimer::stop()
+{
+    if (active)
+    {
+        TimerWheel::getInstance()->cancel(this);
+    }
+}
+
+bool WheelTimer::isActive()
+{
+    return active;
+}
+
+int WheelTimer::interval()
+{
+    return timerInterval;
+}
+
+void WheelTimer::fire()
+{
+    (owner->*handler)();
+}
+
+TimerWheel::TimerWheel(QObject *parent) :
+    QObject(parent)
+{
+    rootSlots.fill(0, 1 << ROOTBITS);
+    upperSlots.fill(0, UPPERLEVELS << LEVELBITS);
+    dueTimers = 0;
+    firingTimers = 0;
+    deferredTimers = 0;
+    processing = false;
+    currentTick = PadderCommon::getMonotonicTime() / TICKLENGTH;
+    armedDeadline = -1;
+    timerCount = 0;
+
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    notifier = new QSocketNotifier(timerFd, QSocketNotifier::Read, this);
+    connect(notifier, SIGNAL(activated(int)), this, SLOT(processTimers()));
+
+    resetStatistics();
+}
+
+TimerWheel::~TimerWheel()
+{
+    // Buttons that outlive the wheel must not touch it again
+    for (int i=0; i < rootSlots.size(); i++)
+    {
+        while (rootSlots.at(i))
+        {
+            removeTimer(rootSlots.at(i));
+        }
+    }
+
+    for (int i=0; i < upperSlots.size(); i++)
+    {
+        while (upperSlots.at(i))
+        {
+            removeTimer(upperSlots.at(i));
+        }
+    }
+
+    while (dueTimers)
+    {
+        removeTimer(dueTimers);
+    }
+
+    while (firingTimers)
+    {
+        removeTimer(firingTimers);
+    }
+
+    while (deferredTimers)
+    {
+        removeTimer(deferredTimers);
+    }
+
+    if (timerFd >= 0)
+    {
+        close(timerFd);
+    }
+}
+
+TimerWheel* TimerWheel::getInstance()
+{
+    static TimerWheel wheel;
+    return &wheel;
+}
+
+void TimerWheel::schedule(WheelTimer *timer)
+{
+    timer->active = true;
+    timerCount++;
+    scheduledCount++;
+
+    if (processing)
+    {
+        // Placed on the wheel and armed for once the current pass is done
+        appendTimer(timer, &deferredTimers);
+    }
+    else
+    {
+        if (timerCount == 1)
+        {
+            // Nothing else is pending so the wheel can skip ahead
+            currentTick = PadderCommon::getMonotonicTime() / TICKLENGTH;
+        }
+
+        insertTimer(timer);
+
+        if (timer->listHead == &dueTimers)
+        {
+            if (armedDeadline != 0)
+            {
+                armTimer(0);
+            }
+        }
+        else if (armedDeadline < 0 || timer->deadline < armedDeadline)
+        {
+            armTimer(timer->deadline);
+        }
+    }
+}
+
+// The timerfd is left armed. An early wakeup only re-arms it
+void TimerWheel::cancel(WheelTimer *timer)
+{
+    if (timer->active)
+    {
+        removeTimer(timer);
+        timerCount--;
+    }
+}
+
+/* Put the timer in the slot for its deadline relative to the
+ * current tick. Deadlines past the range of the top wheel are
+ * parked in its last slot and placed again when it cascades.
+ */
+void TimerWheel::insertTimer(WheelTimer *timer)
+{
+    qint64 tick = timer->deadline / TICKLENGTH;
+    qint64 delta = tick - currentTick;
+    WheelTimer **list = &dueTimers;
+
+    if (delta >= 0 && delta < (1 << ROOTBITS))
+    {
+        list = &rootSlots[tick & ((1 << ROOTBITS) - 1)];
+    }
+    else if (delta > 0)
+    {
+        bool placed = false;
+        for (int level=0; level < UPPERLEVELS && !placed; level++)
+        {
+            int shift = ROOTBITS + (level * LEVELBITS);
+            if (delta < ((qint64)1 << (shift + LEVELBITS)))
+            {
+                int slot = (tick >> shift) & ((1 << LEVELBITS) - 1);
+                list = &upperSlots[(level << LEVELBITS) + slot];
+                placed = true;
+            }
+        }
+
+        if (!placed)
+        {
+            int level = UPPERLEVELS - 1;
+            int shift = ROOTBITS + (level * LEVELBITS);
+            int slot = ((currentTick >> shift) - 1) & ((1 << LEVELBITS) - 1);
+            list = &upperSlots[(level << LEVELBITS) + slot];
+        }
+    }
+
+    appendTimer(timer, list);
+}
+
+void TimerWheel::appendTimer(WheelTimer *timer, WheelTimer **list)
+{
+    timer->previous = 0;
+    timer->next = *list;
+    if (*list)
+    {
+        (*list)->previous = timer;
+    }
+
+    *list = timer;
+    timer->listHead = list;
+}
+
+void TimerWheel::removeTimer(WheelTimer *timer)
+{
+    if (timer->previous)
+    {
+        timer->previous->next = timer->next;
+    }
+    else if (timer->listHead)
+    {
+        *timer->listHead = timer->next;
+    }
+
+    if (timer->next)
+    {
+        timer->next->previous = timer->previous;
+    }
+
+    timer->previous = 0;
+    timer->next = 0;
+    timer->listHead = 0;
+    timer->active = false;
+}
+
+// Move the timers of the current slot of an upper wheel down
+void TimerWheel::cascade(int level)
+{
+    int shift = ROOTBITS + (level * LEVELBITS);
+    int slot = (currentTick >> shift) & ((1 << LEVELBITS) - 1);
+    WheelTimer **list = &upperSlots[(level << LEVELBITS) + slot];
+
+    if (slot == 0 && level + 1 < UPPERLEVELS)
+    {
+        cascade(level + 1);
+    }
+
+    WheelTimer *timer = *list;
+    *list = 0;
+    while (timer)
+    {
+        WheelTimer *nextTimer = timer->next;
+        insertTimer(timer);
+        timer = nextTimer;
+    }
+}
+
+// Handlers may cancel timers that are waiting to be fired
+void TimerWheel::moveToFiring(WheelTimer *timer)
+{
+    removeTimer(timer);
+    timer->active = true;
+    appendTimer(timer, &firingTimers);
+}
+
+// Queue the timers of the current root slot that are due by now
+void TimerWheel::expireSlot(qint64 now)
+{
+    WheelTimer *timer = rootSlots.at(currentTick & ((1 << ROOTBITS) - 1));
+    while (timer)
+    {
+        WheelTimer *nextTimer = timer->next;
+        if (timer->deadline <= now)
+        {
+            moveToFiring(timer);
+        }
+
+        timer = nextTimer;
+    }
+
+    if (firingTimers)
+    {
+        fireTimers(now);
+    }
+}
+
+/* Fire every queued timer. Repeating timers are scheduled again
+ * before their handler runs so the handler can stop or restart
+ * them like it would a QTimer. They only go back on the wheel
+ * after the pass so a zero interval timer is not fired again by
+ * the slots that are still to be walked.
+ */
+void TimerWheel::fireTimers(qint64 now)
+{
+    while (firingTimers)
+    {
+        WheelTimer *timer = firingTimers;
+        removeTimer(timer);
+
+        timer->deadline = now + timer->timerInterval * TICKLENGTH;
+        timer->active = true;
+        scheduledCount++;
+        appendTimer(timer, &deferredTimers);
+        expiredCount++;
+
+        timer->fire();
+    }
+}
+
+void TimerWheel::armTimer(qint64 deadline)
+{
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = 0;
+    spec.it_interval.tv_nsec = 0;
+
+    // A deadline in the past makes the timerfd expire right away.
+    // A zero value would disarm it instead
+    qint64 tempDeadline = qMax((qint64)1, deadline);
+    spec.it_value.tv_sec = tempDeadline / 1000000000LL;
+    spec.it_value.tv_nsec = tempDeadline % 1000000000LL;
+
+    timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, 0);
+    armedDeadline = deadline;
+}
+
+/* Arm the timerfd for the earliest deadline in the next occupied
+ * slot of the root wheel or, when the rest of the root wheel is
+ * empty, for the next cascade.
+ */
+void TimerWheel::refreshArmedTimer()
+{
+    if (dueTimers)
+    {
+        armTimer(0);
+    }
+    else if (timerCount > 0)
+    {
+        int rootMask = (1 << ROOTBITS) - 1;
+        qint64 boundary = (currentTick | rootMask) + 1;
+        qint64 deadline = boundary * TICKLENGTH;
+        bool found = false;
+        for (qint64 i = currentTick; i < boundary && !found; i++)
+        {
+            WheelTimer *timer = rootSlots.at(i & rootMask);
+            while (timer)
+            {
+                deadline = found ? qMin(deadline, timer->deadline) : timer->deadline;
+                found = true;
+                timer = timer->next;
+            }
+        }
+
+        armTimer(deadline);
+    }
+    else
+    {
+        struct itimerspec spec;
+        spec.it_interval.tv_sec = 0;
+        spec.it_interval.tv_nsec = 0;
+        spec.it_value.tv_sec = 0;
+        spec.it_value.tv_nsec = 0;
+        timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, 0);
+        armedDeadline = -1;
+    }
+}
+
+void TimerWheel::processTimers()
+{
+    quint64 expirations = 0;
+    ssize_t bytesRead = read(timerFd, &expirations, sizeof(expirations));
+    Q_UNUSED(bytesRead);
+    wakeupCount++;
+
+    qint64 now = PadderCommon::getMonotonicTime();
+    qint64 nowTick = now / TICKLENGTH;
+    int rootMask = (1 << ROOTBITS) - 1;
+
+    // Only the timers due now are fired. Timers scheduled during
+    // the pass, including zero interval timers scheduled again by
+    // their handler, wait for the next wakeup
+    processing = true;
+    while (dueTimers)
+    {
+        moveToFiring(dueTimers);
+    }
+
+    if (firingTimers)
+    {
+        fireTimers(now);
+    }
+
+    expireSlot(now);
+    while (currentTick < nowTick && timerCount > 0)
+    {
+        currentTick++;
+        if ((currentTick & rootMask) == 0)
+        {
+            cascade(0);
+        }
+
+        expireSlot(now);
+    }
+
+    processing = false;
+    if (timerCount == 0)
+    {
+        currentTick = nowTick;
+    }
+
+    while (deferredTimers)
+    {
+        WheelTimer *timer = deferredTimers;
+        removeTimer(timer);
+        timer->active = true;
+        insertTimer(timer);
+    }
+
+    refreshArmedTimer();
+}
+
+void TimerWheel::writeStatistics(QTextStream &out)
+{
+    double elapsed = (PadderCommon::getMonotonicTime() - statisticsStart) / 1000000000.0;
+    double wakeupRate = elapsed > 0.0 ? wakeupCount / elapsed : 0.0;
+
+    out << tr("Button timers pending:") << " " << timerCount << endl;
+    out << tr("Button timers scheduled:") << " " << scheduledCount << endl;
+    out << tr("Button timers expired:") << " " << expiredCount << endl;
+    out << tr("Button timer wakeups:") << " " << wakeupCount << endl;
+    out << tr("Button timer wakeups per second:") << " " << wakeupRate << endl;
+}
+
+void TimerWheel::resetStatistics()
+{
+    scheduledCount = 0;
+    expiredCount = 0;
+    wakeupCount = 0;
+    statisticsStart = PadderCommon::getMonotonicTime();
+}
@@ -0,0 +1,115 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QObject>
+#include <QVector>
+#include <QSocketNotifier>
+#include <QTextStream>
+
+class JoyButton;
+
+typedef void (JoyButton::*WheelTimerHandler)();
+
+/* Lightweight replacement for a repeating QTimer owned by a
+ * JoyButton. The timer is not a QObject; TimerWheel calls the
+ * handler of the owning button directly once the deadline passes.
+ * Timers of other classes override fire() instead.
+ */
+class WheelTimer
+{
+public:
+    WheelTimer(JoyButton *owner, WheelTimerHandler handler);
+    virtual ~WheelTimer();
+
+    void start();
+    void start(int msec);
+    void startAt(qint64 deadline);
+    void stop();
+    bool isActive();
+    int interval();
+
+protected:
+    virtual void fire();
+
+    JoyButton *owner;
+    WheelTimerHandler handler;
+    int timerInterval;
+    // Monotonic time in nanoseconds
+    qint64 deadline;
+    bool active;
+
+    // Links of the wheel slot that currently holds the timer
+    WheelTimer *previous;
+    WheelTimer *next;
+    WheelTimer **listHead;
+
+    friend class TimerWheel;
+};
+
+/* Hierarchical timer wheel shared by the timers of every button.
+ * Deadlines are bucketed by millisecond in a root wheel and coarser
+ * upper wheels which are cascaded down as time advances. A single
+ * timerfd is armed for the earliest deadline in the next occupied
+ * slot so the process only wakes up when a timer expires and timers
+ * fire at their exact deadline rather than at a tick boundary.
+ */
+class TimerWheel : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TimerWheel(QObject *parent = 0);
+    ~TimerWheel();
+
+    void schedule(WheelTimer *timer);
+    void cancel(WheelTimer *timer);
+    void writeStatistics(QTextStream &out);
+    void resetStatistics();
+
+    static TimerWheel* getInstance();
+
+    static const qint64 TICKLENGTH;
+    static const int ROOTBITS;
+    static const int LEVELBITS;
+    static const int UPPERLEVELS;
+
+protected:
+    void insertTimer(WheelTimer *timer);
+    void appendTimer(WheelTimer *timer, WheelTimer **list);
+    void removeTimer(WheelTimer *timer);
+    void cascade(int level);
+    void moveToFiring(WheelTimer *timer);
+    void expireSlot(qint64 now);
+    void fireTimers(qint64 now);
+    void armTimer(qint64 deadline);
+    void refreshArmedTimer();
+
+    QVector<WheelTimer*> rootSlots;
+    QVector<WheelTimer*> upperSlots;
+    // Timers whose deadline already passed when they were scheduled
+    WheelTimer *dueTimers;
+    // Timers currently being fired. Handlers may cancel them
+    WheelTimer *firingTimers;
+    // Timers scheduled while timers are fired. They are put on the
+    // wheel after the pass so each fires at most once per wakeup
+    WheelTimer *deferredTimers;
+    bool processing;
+    qint64 currentTick;
+    // Deadline the timerfd is armed for. -1 while disarmed
+    qint64 armedDeadline;
+    int timerCount;
+
+    int timerFd;
+    QSocketNotifier *notifier;
+
+    int scheduledCount;
+    int expiredCount;
+    int wakeupCount;
+    qint64 statisticsStart;
+
+signals:
+
+private slots:
+    void processTimers();
+};
+
+#endif // TIMERWHEEL_H
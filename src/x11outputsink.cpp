@@ -0,0 +1,147 @@
+#include <X11/Xlib.h>
+#include <X11/extensions/XTest.h>
+
+#include "x11outputsink.h"
+#include "x11info.h"
+#include "common.h"
+
+// Time in milliseconds before the cached pointer position is
+// checked against the server again. The pointer can also be moved
+// by a real mouse so the cache cannot be trusted forever.
+const int X11OutputSink::POINTERRESYNCINTERVAL = 500;
+
+X11OutputSink::X11OutputSink()
+{
+    structureEventsSelected = false;
+    geometryValid = false;
+    screenWidth = 0;
+    screenHeight = 0;
+
+    pointerValid = false;
+    pointerX = 0;
+    pointerY = 0;
+    pointerSyncTime = 0;
+}
+
+void X11OutputSink::sendButtonEvent(int code, bool pressed, JoyButtonSlot::JoySlotInputAction device)
+{
+    Display *display = X11Info::display();
+
+    if (device == JoyButtonSlot::JoyKeyboard)
+    {
+        XTestFakeKeyEvent(display, code, pressed, 0);
+    }
+    else if (device == JoyButtonSlot::JoyMouseButton)
+    {
+        XTestFakeButtonEvent(display, code, pressed, 0);
+    }
+}
+
+void X11OutputSink::sendRelativeMotion(int dx, int dy)
+{
+    XTestFakeRelativeMotionEvent(X11Info::display(), dx, dy, 0);
+
+    // The server may apply pointer acceleration so the new position
+    // cannot be worked out locally
+    pointerValid = false;
+}
+
+void X11OutputSink::sendAbsoluteMotion(int x, int y)
+{
+    XTestFakeMotionEvent(X11Info::display(), -1, x, y, 0);
+
+    pointerX = x;
+    pointerY = y;
+    if (geometryValid)
+    {
+        pointerX = qBound(0, x, screenWidth - 1);
+        pointerY = qBound(0, y, screenHeight - 1);
+    }
+    pointerValid = true;
+}
+
+/* Return the last position the pointer was warped to. The server is
+ * only queried when nothing is known about the position or when the
+ * last query is older than POINTERRESYNCINTERVAL.
+ */
+void X11OutputSink::getPointerPosition(int &x, int &y)
+{
+    qint64 currentTime = PadderCommon::getMonotonicTime();
+    if (!pointerValid || (currentTime - pointerSyncTime) >= (qint64)POINTERRESYNCINTERVAL * 1000000)
+    {
+        Display *display = X11Info::display();
+        XEvent mouseEvent;
+        Window wid = DefaultRootWindow(display);
+
+        XQueryPointer(display, wid,
+            &mouseEvent.xbutton.root, &mouseEvent.xbutton.window,
+            &mouseEvent.xbutton.x_root, &mouseEvent.xbutton.y_root,
+            &mouseEvent.xbutton.x, &mouseEvent.xbutton.y,
+            &mouseEvent.xbutton.state);
+
+        pointerX = mouseEvent.xbutton.x_root;
+        pointerY = mouseEvent.xbutton.y_root;
+        pointerValid = true;
+        pointerSyncTime = currentTime;
+    }
+
+    x = pointerX;
+    y = pointerY;
+}
+
+/* Root window geometry is read once and then kept up to date from
+ * ConfigureNotify events, which the server also sends when the
+ * screen is resized through RandR.
+ */
+void X11OutputSink::getScreenSize(int &width, int &height)
+{
+    Display *display = X11Info::display();
+    Window root = DefaultRootWindow(display);
+
+    if (!structureEventsSelected)
+    {
+        XSelectInput(display, root, StructureNotifyMask);
+        structureEventsSelected = true;
+    }
+
+    processConfigureEvents();
+
+    if (!geometryValid)
+    {
+        XWindowAttributes xwAttr;
+        XGetWindowAttributes(display, root, &xwAttr);
+        screenWidth = xwAttr.width;
+        screenHeight = xwAttr.height;
+        geometryValid = true;
+    }
+
+    width = screenWidth;
+    height = screenHeight;
+}
+
+void X11OutputSink::flush()
+{
+    XFlush(X11Info::display());
+}
+
+/* Handle events that have arrived on the connection without
+ * flushing requests or waiting on the server.
+ */
+void X11OutputSink::processConfigureEvents()
+{
+    Display *display = X11Info::display();
+    Window root = DefaultRootWindow(display);
+
+    while (XEventsQueued(display, QueuedAfterReading) > 0)
+    {
+        XEvent event;
+        XNextEvent(display, &event);
+        if (event.type == ConfigureNotify && event.xconfigure.window == root)
+        {
+            screenWidth = event.xconfigure.width;
+            screenHeight = event.xconfigure.height;
+            geometryValid = true;
+            pointerValid = false;
+        }
+    }
+}
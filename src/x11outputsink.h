@@ -0,0 +1,38 @@
+#ifndef X11OUTPUTSINK_H
+#define X11OUTPUTSINK_H
+
+#include "outputsink.h"
+
+/* Sends output to the X server through the XTest extension. The
+ * root window geometry and the pointer position are cached so spring
+ * mode does not need a round trip to the server on every tick.
+ */
+class X11OutputSink : public OutputSink
+{
+public:
+    explicit X11OutputSink();
+
+    virtual void sendButtonEvent(int code, bool pressed, JoyButtonSlot::JoySlotInputAction device);
+    virtual void sendRelativeMotion(int dx, int dy);
+    virtual void sendAbsoluteMotion(int x, int y);
+    virtual void getPointerPosition(int &x, int &y);
+    virtual void getScreenSize(int &width, int &height);
+    virtual void flush();
+
+    static const int POINTERRESYNCINTERVAL;
+
+protected:
+    void processConfigureEvents();
+
+    bool structureEventsSelected;
+    bool geometryValid;
+    int screenWidth;
+    int screenHeight;
+
+    bool pointerValid;
+    int pointerX;
+    int pointerY;
+    qint64 pointerSyncTime;
+};
+
+#endif // X11OUTPUTSINK_H
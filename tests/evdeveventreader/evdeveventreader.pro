@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_evdeveventreader
+
+SOURCES += tst_evdeveventreader.cpp
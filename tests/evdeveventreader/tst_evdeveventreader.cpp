@@ -0,0 +1,376 @@
+#include <QtTest>
+#include <QHash>
+#include <QDir>
+#include <QThread>
+#include <QSignalSpy>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <linux/uinput.h>
+
+#include "evdeveventreader.h"
+#include "common.h"
+
+#if QT_VERSION >= 0x050000
+#define SKIPTEST(message) QSKIP(message)
+#else
+#define SKIPTEST(message) QSKIP(message, SkipAll)
+#endif
+
+static const char *DEVICENAME = "antimicro test gamepad";
+
+// Gives the tests access to the device handling of the reader
+class TestEvdevEventReader : public EvdevEventReader
+{
+public:
+    explicit TestEvdevEventReader(QHash<int, Joystick*> *joysticks) :
+        EvdevEventReader(joysticks)
+    {
+    }
+
+    using EvdevEventReader::openDevice;
+    using EvdevEventReader::readDevice;
+};
+
+/* Feeds a virtual gamepad created through uinput to the evdev reader
+ * and checks that it produces the same SDL events as SDL 1.2 would.
+ * The tests are skipped when /dev/uinput or the event device cannot
+ * be opened.
+ */
+class TestEvdevEventReaderCase : public QObject
+{
+    Q_OBJECT
+
+protected:
+    void sendInput(int type, int code, int value);
+    void sendSync();
+    int readEvents(TimedSDLEvent *events, int maxEvents);
+    QString findDeviceNode();
+
+    int uinputFd;
+    QString devicePath;
+    QHash<int, Joystick*> joysticks;
+    TestEvdevEventReader *reader;
+    EvdevDevice *device;
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void deviceLayout();
+    void buttonEvents();
+    void repeatedButtonState();
+    void axisCorrection();
+    void hatEvents();
+    void monotonicTimestamps();
+    void stopWakesReader();
+};
+
+void TestEvdevEventReaderCase::sendInput(int type, int code, int value)
+{
+    struct input_event inputEvent;
+    memset(&inputEvent, 0, sizeof(inputEvent));
+    inputEvent.type = type;
+    inputEvent.code = code;
+    inputEvent.value = value;
+    QVERIFY(write(uinputFd, &inputEvent, sizeof(inputEvent)) == sizeof(inputEvent));
+}
+
+void TestEvdevEventReaderCase::sendSync()
+{
+    sendInput(EV_SYN, SYN_REPORT, 0);
+}
+
+// Wait for the events sent to the virtual device and translate them
+int TestEvdevEventReaderCase::readEvents(TimedSDLEvent *events, int maxEvents)
+{
+    struct pollfd devicePoll;
+    devicePoll.fd = device->fd;
+    devicePoll.events = POLLIN;
+    devicePoll.revents = 0;
+    poll(&devicePoll, 1, 1000);
+
+    bool deviceLost = false;
+    reader->readDevice(device, deviceLost);
+    return reader->getEventRing()->drain(events, maxEvents);
+}
+
+// udev might need a moment to create the node of the new device
+QString TestEvdevEventReaderCase::findDeviceNode()
+{
+    QString result;
+    for (int attempt=0; attempt < 100 && result.isEmpty(); attempt++)
+    {
+        QDir deviceDir("/dev/input");
+        QStringList nodes = deviceDir.entryList(QStringList() << "event*", QDir::System);
+        for (int i=0; i < nodes.size() && result.isEmpty(); i++)
+        {
+            QString path = deviceDir.absoluteFilePath(nodes.at(i));
+            int fd = open(path.toUtf8().constData(), O_RDONLY | O_NONBLOCK);
+            if (fd >= 0)
+            {
+                char name[256];
+                memset(name, 0, sizeof(name));
+                ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name);
+                if (QString(name) == DEVICENAME)
+                {
+                    result = path;
+                }
+
+                close(fd);
+            }
+        }
+
+        if (result.isEmpty())
+        {
+            QTest::qWait(20);
+        }
+    }
+
+    return result;
+}
+
+void TestEvdevEventReaderCase::initTestCase()
+{
+    reader = 0;
+    device = 0;
+
+    // SDL is initialized by the reader and must not need a display
+    qputenv("SDL_VIDEODRIVER", "dummy");
+
+    uinputFd = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+    if (uinputFd < 0)
+    {
+        SKIPTEST("/dev/uinput is not available");
+    }
+
+    ioctl(uinputFd, UI_SET_EVBIT, EV_KEY);
+    ioctl(uinputFd, UI_SET_KEYBIT, BTN_A);
+    ioctl(uinputFd, UI_SET_KEYBIT, BTN_B);
+    ioctl(uinputFd, UI_SET_EVBIT, EV_ABS);
+    ioctl(uinputFd, UI_SET_ABSBIT, ABS_X);
+    ioctl(uinputFd, UI_SET_ABSBIT, ABS_Y);
+    ioctl(uinputFd, UI_SET_ABSBIT, ABS_HAT0X);
+    ioctl(uinputFd, UI_SET_ABSBIT, ABS_HAT0Y);
+
+    struct uinput_user_dev setup;
+    memset(&setup, 0, sizeof(setup));
+    strncpy(setup.name, DEVICENAME, UINPUT_MAX_NAME_SIZE - 1);
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.absmin[ABS_X] = 0;
+    setup.absmax[ABS_X] = 255;
+    setup.absmin[ABS_Y] = 0;
+    setup.absmax[ABS_Y] = 255;
+    setup.absmin[ABS_HAT0X] = -1;
+    setup.absmax[ABS_HAT0X] = 1;
+    setup.absmin[ABS_HAT0Y] = -1;
+    setup.absmax[ABS_HAT0Y] = 1;
+
+    if (write(uinputFd, &setup, sizeof(setup)) != sizeof(setup) ||
+        ioctl(uinputFd, UI_DEV_CREATE) < 0)
+    {
+        close(uinputFd);
+        uinputFd = -1;
+        SKIPTEST("Virtual gamepad could not be created");
+    }
+
+    devicePath = findDeviceNode();
+    if (devicePath.isEmpty())
+    {
+        SKIPTEST("Event device of the virtual gamepad cannot be opened");
+    }
+
+    reader = new TestEvdevEventReader(&joysticks);
+}
+
+void TestEvdevEventReaderCase::cleanupTestCase()
+{
+    if (reader)
+    {
+        delete reader;
+        reader = 0;
+    }
+
+    if (uinputFd >= 0)
+    {
+        ioctl(uinputFd, UI_DEV_DESTROY);
+        close(uinputFd);
+        uinputFd = -1;
+    }
+}
+
+void TestEvdevEventReaderCase::init()
+{
+    device = reader->openDevice(devicePath, 0);
+    QVERIFY(device != 0);
+}
+
+// Put the virtual device back at rest for the next test
+void TestEvdevEventReaderCase::cleanup()
+{
+    if (device)
+    {
+        sendInput(EV_KEY, BTN_A, 0);
+        sendInput(EV_KEY, BTN_B, 0);
+        sendInput(EV_ABS, ABS_X, 0);
+        sendInput(EV_ABS, ABS_Y, 0);
+        sendInput(EV_ABS, ABS_HAT0X, 0);
+        sendInput(EV_ABS, ABS_HAT0Y, 0);
+        sendSync();
+
+        TimedSDLEvent events[16];
+        readEvents(events, 16);
+
+        close(device->fd);
+        delete device;
+        device = 0;
+    }
+}
+
+void TestEvdevEventReaderCase::deviceLayout()
+{
+    QCOMPARE(device->numberButtons, 2);
+    QCOMPARE(device->numberAxes, 2);
+    QCOMPARE(device->numberHats, 1);
+}
+
+void TestEvdevEventReaderCase::buttonEvents()
+{
+    TimedSDLEvent events[16];
+
+    sendInput(EV_KEY, BTN_B, 1);
+    sendSync();
+    QCOMPARE(readEvents(events, 16), 1);
+    QCOMPARE((int)events[0].event.type, (int)SDL_JOYBUTTONDOWN);
+    QCOMPARE((int)events[0].event.button.which, 0);
+    QCOMPARE((int)events[0].event.button.button, 1);
+    QCOMPARE((int)events[0].event.button.state, (int)SDL_PRESSED);
+
+    sendInput(EV_KEY, BTN_B, 0);
+    sendInput(EV_KEY, BTN_A, 1);
+    sendSync();
+    QCOMPARE(readEvents(events, 16), 2);
+    QCOMPARE((int)events[0].event.type, (int)SDL_JOYBUTTONUP);
+    QCOMPARE((int)events[0].event.button.button, 1);
+    QCOMPARE((int)events[1].event.type, (int)SDL_JOYBUTTONDOWN);
+    QCOMPARE((int)events[1].event.button.button, 0);
+}
+
+// Key repeat events must not produce extra button presses
+void TestEvdevEventReaderCase::repeatedButtonState()
+{
+    TimedSDLEvent events[16];
+
+    sendInput(EV_KEY, BTN_A, 1);
+    sendSync();
+    sendInput(EV_KEY, BTN_A, 2);
+    sendSync();
+    QCOMPARE(readEvents(events, 16), 1);
+    QCOMPARE((int)events[0].event.type, (int)SDL_JOYBUTTONDOWN);
+}
+
+// Values are scaled into the SDL range like SDL 1.2 does
+void TestEvdevEventReaderCase::axisCorrection()
+{
+    TimedSDLEvent events[16];
+
+    sendInput(EV_ABS, ABS_X, 255);
+    sendSync();
+    QCOMPARE(readEvents(events, 16), 1);
+    QCOMPARE((int)events[0].event.type, (int)SDL_JOYAXISMOTION);
+    QCOMPARE((int)events[0].event.jaxis.axis, 0);
+    QCOMPARE((int)events[0].event.jaxis.value, 32767);
+
+    sendInput(EV_ABS, ABS_X, 127);
+    sendInput(EV_ABS, ABS_Y, 255);
+    sendSync();
+    QCOMPARE(readEvents(events, 16), 2);
+    QCOMPARE((int)events[0].event.jaxis.axis, 0);
+    QCOMPARE((int)events[0].event.jaxis.value, 0);
+    QCOMPARE((int)events[1].event.jaxis.axis, 1);
+    QCOMPARE((int)events[1].event.jaxis.value, 32767);
+
+    sendInput(EV_ABS, ABS_X, 0);
+    sendSync();
+    QCOMPARE(readEvents(events, 16), 1);
+    QCOMPARE((int)events[0].event.jaxis.value, -32768);
+}
+
+void TestEvdevEventReaderCase::hatEvents()
+{
+    TimedSDLEvent events[16];
+
+    sendInput(EV_ABS, ABS_HAT0X, -1);
+    sendSync();
+    QCOMPARE(readEvents(events, 16), 1);
+    QCOMPARE((int)events[0].event.type, (int)SDL_JOYHATMOTION);
+    QCOMPARE((int)events[0].event.jhat.hat, 0);
+    QCOMPARE((int)events[0].event.jhat.value, (int)SDL_HAT_LEFT);
+
+    sendInput(EV_ABS, ABS_HAT0Y, 1);
+    sendSync();
+    QCOMPARE(readEvents(events, 16), 1);
+    QCOMPARE((int)events[0].event.jhat.value, (int)SDL_HAT_LEFTDOWN);
+
+    sendInput(EV_ABS, ABS_HAT0X, 0);
+    sendInput(EV_ABS, ABS_HAT0Y, 0);
+    sendSync();
+    QCOMPARE(readEvents(events, 16), 2);
+    QCOMPARE((int)events[1].event.jhat.value, (int)SDL_HAT_CENTERED);
+}
+
+// Event times have to be comparable with PadderCommon::getMonotonicTime
+void TestEvdevEventReaderCase::monotonicTimestamps()
+{
+    TimedSDLEvent events[16];
+
+    qint64 before = PadderCommon::getMonotonicTime();
+    sendInput(EV_KEY, BTN_A, 1);
+    sendSync();
+    int count = readEvents(events, 16);
+    qint64 after = PadderCommon::getMonotonicTime();
+
+    QCOMPARE(count, 1);
+    // Kernel timestamps only have microsecond resolution
+    QVERIFY(events[0].timestamp >= before - 1000);
+    QVERIFY(events[0].timestamp <= after);
+}
+
+// stop() has to wake the reader while it waits on the devices
+void TestEvdevEventReaderCase::stopWakesReader()
+{
+    QHash<int, Joystick*> threadJoysticks;
+    EvdevEventReader *threadReader = new EvdevEventReader(&threadJoysticks);
+    QThread thread;
+    threadReader->moveToThread(&thread);
+    connect(&thread, SIGNAL(started()), threadReader, SLOT(performWork()));
+
+    QSignalSpy finishedSpy(threadReader, SIGNAL(finished()));
+    thread.start();
+    QTest::qWait(50);
+    threadReader->stop();
+
+    for (int i=0; i < 100 && finishedSpy.count() == 0; i++)
+    {
+        QTest::qWait(10);
+    }
+
+    QCOMPARE(finishedSpy.count(), 1);
+
+    TimedSDLEvent events[64];
+    int count = threadReader->getEventRing()->drain(events, 64);
+    QVERIFY(count > 0);
+    QCOMPARE((int)events[count - 1].event.type, (int)SDL_QUIT);
+
+    thread.quit();
+    thread.wait();
+    delete threadReader;
+}
+
+QTEST_MAIN(TestEvdevEventReaderCase)
+
+#include "tst_evdeveventreader.moc"
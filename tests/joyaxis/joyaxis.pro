@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_joyaxis
+
+SOURCES += tst_joyaxis.cpp
@@ -0,0 +1,71 @@
+#include <QtTest>
+
+#include "joyaxis.h"
+#include "axisfilter.h"
+
+/* Checks that releasing an axis returns it to its dead value right
+ * away, whatever filter or calibration it uses.
+ */
+class TestJoyAxis : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void plainRelease();
+    void filteredRelease();
+    void calibratedRelease();
+};
+
+void TestJoyAxis::plainRelease()
+{
+    JoyAxis axis(0, 0);
+    QSignalSpy releasedSpy(&axis, SIGNAL(released(int)));
+
+    axis.joyEvent(JoyAxis::AXISMAX);
+    axis.release();
+
+    QCOMPARE(axis.getCurrentRawValue(), axis.getCurrentThrottledDeadValue());
+    QCOMPARE(releasedSpy.count(), 1);
+}
+
+// A smoothed release would take until the filter settles
+void TestJoyAxis::filteredRelease()
+{
+    JoyAxis axis(0, 0);
+    axis.setFilterMode(AxisFilter::EMAFilter);
+    axis.setFilterCutoff(AxisFilter::MINCUTOFF);
+    QSignalSpy releasedSpy(&axis, SIGNAL(released(int)));
+
+    axis.joyEvent(JoyAxis::AXISMAX);
+    QVERIFY(axis.getCurrentRawValue() > JoyAxis::AXISDEADZONE);
+
+    axis.release();
+    QCOMPARE(axis.getCurrentRawValue(), axis.getCurrentThrottledDeadValue());
+    QCOMPARE(releasedSpy.count(), 1);
+
+    // The filter must not bring back the old value later
+    QTest::qWait(JoyAxis::FILTERSETTLEINTERVAL * 4);
+    QCOMPARE(axis.getCurrentRawValue(), axis.getCurrentThrottledDeadValue());
+    QCOMPARE(releasedSpy.count(), 1);
+}
+
+// The dead value is not a device value so it is not calibrated
+void TestJoyAxis::calibratedRelease()
+{
+    JoyAxis axis(0, 0);
+    axis.setCalibration(4000, -28000, 30000);
+
+    axis.joyEvent(4000);
+    QCOMPARE(axis.getCurrentRawValue(), 0);
+
+    axis.joyEvent(30000);
+    QCOMPARE(axis.getCurrentRawValue(), JoyAxis::AXISMAX);
+
+    axis.release();
+    QCOMPARE(axis.getCurrentRawValue(), 0);
+    QCOMPARE(axis.getUncalibratedValue(), 30000);
+}
+
+QTEST_MAIN(TestJoyAxis)
+
+#include "tst_joyaxis.moc"
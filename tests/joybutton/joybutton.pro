@@ -0,0 +1,8 @@
+include(../tests.pri)
+
+TARGET = tst_joybutton
+
+# The test moves the monotonic clock itself
+DEFINES += MOCK_MONOTONIC_TIME
+
+SOURCES += tst_joybutton.cpp
@@ -0,0 +1,289 @@
+#include <QtTest>
+#include <QList>
+
+#include "joybutton.h"
+#include "joybuttonslot.h"
+#include "timerwheel.h"
+#include "recordingoutputsink.h"
+#include "common.h"
+
+// Far beyond the real monotonic time so the timerfd never fires
+// on its own while the test runs. Starts on a millisecond boundary
+qint64 PadderCommon::mockMonotonicTime = 1000000LL << 40;
+
+// Key codes assigned to the slots
+static const int FIRSTKEYCODE = 10;
+static const int SECONDKEYCODE = 11;
+static const int THIRDKEYCODE = 12;
+static const int FOURTHKEYCODE = 13;
+// Time in milliseconds
+static const int SETTLETIME = 20;
+
+static const qint64 MILLISECOND = 1000000;
+// Step of the mocked clock in nanoseconds
+static const qint64 CLOCKSTEP = 100000;
+
+// Reports a distance set by the test instead of an axis distance
+class DistanceButton : public JoyButton
+{
+public:
+    explicit DistanceButton() :
+        JoyButton(0, 0)
+    {
+        distance = 0.0;
+    }
+
+    virtual double getDistanceFromDeadZone()
+    {
+        return distance;
+    }
+
+    double distance;
+};
+
+/* Checks the slot program that a button compiles from its assigned
+ * slots. Buttons run on a mocked monotonic clock and the keys they
+ * send are recorded.
+ */
+class TestJoyButton : public QObject
+{
+    Q_OBJECT
+
+protected:
+    void advance(qint64 nanoseconds);
+    void tap();
+    QList<int> findKeyPresses();
+
+    RecordingOutputSink *sink;
+    DistanceButton *button;
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void cycleAdvancesEachPress();
+    void cycleWrapsWithoutTrailingCycle();
+    void changingSlotsRestartsProgram();
+    void programFlags();
+    void distanceZones_data();
+    void distanceZones();
+    void distanceZonesOfLaterSegment();
+};
+
+/* Move the clock in small steps. Each step runs the timer wheel like
+ * a timerfd wakeup would and then the events it posted.
+ */
+void TestJoyButton::advance(qint64 nanoseconds)
+{
+    qint64 target = PadderCommon::mockMonotonicTime + nanoseconds;
+    while (PadderCommon::mockMonotonicTime < target)
+    {
+        PadderCommon::mockMonotonicTime = qMin(target, PadderCommon::mockMonotonicTime + CLOCKSTEP);
+        QMetaObject::invokeMethod(TimerWheel::getInstance(), "processTimers");
+        QCoreApplication::processEvents();
+    }
+}
+
+// Press and release the button
+void TestJoyButton::tap()
+{
+    button->joyEvent(true);
+    advance(SETTLETIME * MILLISECOND);
+    button->joyEvent(false);
+    advance(SETTLETIME * MILLISECOND);
+}
+
+// Codes of the keys pressed in the order they were sent
+QList<int> TestJoyButton::findKeyPresses()
+{
+    QList<int> result;
+
+    QList<RecordingOutputSink::OutputEvent> *events = sink->getEvents();
+    for (int i=0; i < events->size(); i++)
+    {
+        const RecordingOutputSink::OutputEvent &event = events->at(i);
+        if (event.type == RecordingOutputSink::KeyOutput && event.value != 0)
+        {
+            result.append(event.code);
+        }
+    }
+
+    return result;
+}
+
+void TestJoyButton::initTestCase()
+{
+    sink = new RecordingOutputSink();
+    OutputSink::setInstance(sink);
+}
+
+void TestJoyButton::cleanupTestCase()
+{
+    OutputSink::setInstance(0);
+    delete sink;
+    sink = 0;
+}
+
+void TestJoyButton::init()
+{
+    button = new DistanceButton();
+    sink->clear();
+}
+
+void TestJoyButton::cleanup()
+{
+    delete button;
+    button = 0;
+}
+
+void TestJoyButton::cycleAdvancesEachPress()
+{
+    button->setAssignedSlot(FIRSTKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button->setAssignedSlot(1, JoyButtonSlot::JoyCycle);
+    button->setAssignedSlot(SECONDKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button->setAssignedSlot(1, JoyButtonSlot::JoyCycle);
+    button->setAssignedSlot(THIRDKEYCODE, JoyButtonSlot::JoyKeyboard);
+
+    for (int i=0; i < 4; i++)
+    {
+        tap();
+    }
+
+    QList<int> expected;
+    expected << FIRSTKEYCODE << SECONDKEYCODE << THIRDKEYCODE << FIRSTKEYCODE;
+    QCOMPARE(findKeyPresses(), expected);
+}
+
+// A trailing cycle slot returns to the front like the end of the slots
+void TestJoyButton::cycleWrapsWithoutTrailingCycle()
+{
+    button->setAssignedSlot(FIRSTKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button->setAssignedSlot(1, JoyButtonSlot::JoyCycle);
+    button->setAssignedSlot(SECONDKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button->setAssignedSlot(1, JoyButtonSlot::JoyCycle);
+
+    for (int i=0; i < 3; i++)
+    {
+        tap();
+    }
+
+    QList<int> expected;
+    expected << FIRSTKEYCODE << SECONDKEYCODE << FIRSTKEYCODE;
+    QCOMPARE(findKeyPresses(), expected);
+}
+
+void TestJoyButton::changingSlotsRestartsProgram()
+{
+    button->setAssignedSlot(FIRSTKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button->setAssignedSlot(1, JoyButtonSlot::JoyCycle);
+    button->setAssignedSlot(SECONDKEYCODE, JoyButtonSlot::JoyKeyboard);
+    tap();
+
+    button->setAssignedSlot(THIRDKEYCODE, JoyButtonSlot::JoyKeyboard);
+    tap();
+    tap();
+
+    QList<int> expected;
+    expected << FIRSTKEYCODE << FIRSTKEYCODE << SECONDKEYCODE << THIRDKEYCODE;
+    QCOMPARE(findKeyPresses(), expected);
+}
+
+void TestJoyButton::programFlags()
+{
+    button->setAssignedSlot(FIRSTKEYCODE, JoyButtonSlot::JoyKeyboard);
+    QVERIFY(!button->containsSequence());
+    QVERIFY(!button->containsDistanceSlots());
+    QVERIFY(!button->containsReleaseSlots());
+
+    button->setAssignedSlot(100, JoyButtonSlot::JoyRelease);
+    QVERIFY(button->containsReleaseSlots());
+    QVERIFY(!button->containsSequence());
+
+    button->setAssignedSlot(50, JoyButtonSlot::JoyPause);
+    QVERIFY(button->containsSequence());
+
+    // Turbo cannot be used with a sequence
+    button->setUseTurbo(true);
+    QVERIFY(!button->isUsingTurbo());
+
+    button->clearSlotsEventReset();
+    QVERIFY(!button->containsSequence());
+    QVERIFY(!button->containsReleaseSlots());
+
+    button->setAssignedSlot(30, JoyButtonSlot::JoyDistance);
+    QVERIFY(button->containsDistanceSlots());
+    QVERIFY(button->containsSequence());
+
+    button->removeAssignedSlot(0);
+    QVERIFY(!button->containsDistanceSlots());
+}
+
+void TestJoyButton::distanceZones_data()
+{
+    QTest::addColumn<double>("distance");
+    QTest::addColumn<int>("code");
+
+    QTest::newRow("centered") << 0.0 << FIRSTKEYCODE;
+    QTest::newRow("before first zone") << 0.29 << FIRSTKEYCODE;
+    QTest::newRow("first zone edge") << 0.3 << SECONDKEYCODE;
+    QTest::newRow("first zone") << 0.5 << SECONDKEYCODE;
+    QTest::newRow("second zone") << 0.75 << THIRDKEYCODE;
+    QTest::newRow("full distance") << 1.0 << THIRDKEYCODE;
+}
+
+// A zone starts at the sum of the distance slots before it
+void TestJoyButton::distanceZones()
+{
+    QFETCH(double, distance);
+    QFETCH(int, code);
+
+    button->setAssignedSlot(FIRSTKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button->setAssignedSlot(30, JoyButtonSlot::JoyDistance);
+    button->setAssignedSlot(SECONDKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button->setAssignedSlot(40, JoyButtonSlot::JoyDistance);
+    button->setAssignedSlot(THIRDKEYCODE, JoyButtonSlot::JoyKeyboard);
+
+    button->distance = distance;
+    tap();
+
+    QList<int> expected;
+    expected << code;
+    QCOMPARE(findKeyPresses(), expected);
+}
+
+// Distances restart at each cycle segment
+void TestJoyButton::distanceZonesOfLaterSegment()
+{
+    button->setAssignedSlot(FIRSTKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button->setAssignedSlot(30, JoyButtonSlot::JoyDistance);
+    button->setAssignedSlot(SECONDKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button->setAssignedSlot(1, JoyButtonSlot::JoyCycle);
+    button->setAssignedSlot(THIRDKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button->setAssignedSlot(50, JoyButtonSlot::JoyDistance);
+    button->setAssignedSlot(FOURTHKEYCODE, JoyButtonSlot::JoyKeyboard);
+
+    button->distance = 0.4;
+    tap();
+
+    // Past the zone of the first segment but not the one of the second
+    button->joyEvent(true);
+    advance(SETTLETIME * MILLISECOND);
+    button->joyEvent(true);
+    advance(SETTLETIME * MILLISECOND);
+
+    button->distance = 0.6;
+    button->joyEvent(true);
+    advance(SETTLETIME * MILLISECOND);
+    button->joyEvent(false);
+    advance(SETTLETIME * MILLISECOND);
+
+    QList<int> expected;
+    expected << SECONDKEYCODE << THIRDKEYCODE << FOURTHKEYCODE;
+    QCOMPARE(findKeyPresses(), expected);
+}
+
+QTEST_MAIN(TestJoyButton)
+
+#include "tst_joybutton.moc"
@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_joycontrolstick
+
+SOURCES += tst_joycontrolstick.cpp
@@ -0,0 +1,410 @@
+#include <QtTest>
+#include <math.h>
+
+#include "joyaxis.h"
+#include "joycontrolstick.h"
+
+// Radius well outside the default dead zone of 8000
+static const int ACTIVERADIUS = 20000;
+// Bearings closer than this many degrees to a half degree are skipped
+// when zones are compared. Rounding the bearing and the fixed point
+// edges may disagree there
+static const double EDGEMARGIN = 0.01;
+
+// Gives the test direct control of the axis values
+class StickAxis : public JoyAxis
+{
+public:
+    explicit StickAxis(int index) :
+        JoyAxis(index, 0)
+    {
+    }
+
+    using JoyAxis::setCurrentRawValue;
+};
+
+// Gives the test access to the zone lookup
+class ZoneStick : public JoyControlStick
+{
+public:
+    explicit ZoneStick(JoyAxis *axisX, JoyAxis *axisY) :
+        JoyControlStick(axisX, axisY, 0)
+    {
+    }
+
+    using JoyControlStick::calculateStickDirection;
+};
+
+/* Moves a control stick to given bearings and distances and checks
+ * the direction it settles on. The stick is handled directly so both
+ * axes change together.
+ */
+class TestJoyControlStick : public QObject
+{
+    Q_OBJECT
+
+protected:
+    void moveStick(double bearing, int radius=ACTIVERADIUS);
+
+    StickAxis *axisX;
+    StickAxis *axisY;
+    JoyControlStick *stick;
+
+private slots:
+    void init();
+    void cleanup();
+
+    void directionWithoutHysteresis();
+    void directionHysteresisHoldsAtZoneEdge();
+    void directionHysteresisReleasesPastBand();
+    void deadZoneHysteresisKeepsStickActive();
+    void zonesMatchRoundedBearing_data();
+    void zonesMatchRoundedBearing();
+    void snapshotMatchesAxes_data();
+    void snapshotMatchesAxes();
+    void snapshotFollowsChanges();
+    void deadZoneTypeShapes();
+    void deadZoneTypeDistances();
+    void deadZoneTypeConfig();
+};
+
+static bool isClose(double value, double expected)
+{
+    return qAbs(value - expected) < 1e-9;
+}
+
+/* Direction that the stick chose before its zones were precomputed:
+ * the bearing rounded to whole degrees checked against the zone
+ * boundaries of getDiagonalZoneAngles().
+ */
+static JoyControlStick::JoyStickDirections roundedBearingDirection(QList<int> &angles, double bearing)
+{
+    JoyControlStick::JoyStickDirections direction = JoyControlStick::StickUp;
+
+    bearing = round(bearing);
+    for (int i=2; i < 8; i++)
+    {
+        if (bearing >= angles.at(i) && bearing < angles.at(i + 1))
+        {
+            direction = (JoyControlStick::JoyStickDirections)i;
+        }
+    }
+
+    if (bearing >= angles.at(8) && bearing < angles.at(0))
+    {
+        direction = JoyControlStick::StickLeftUp;
+    }
+
+    return direction;
+}
+
+// Bearings are in degrees clockwise from up like calculateBearing()
+void TestJoyControlStick::moveStick(double bearing, int radius)
+{
+    double angle = bearing * JoyControlStick::PI / 180.0;
+    axisX->setCurrentRawValue(qRound(radius * sin(angle)));
+    axisY->setCurrentRawValue(qRound(-radius * cos(angle)));
+    stick->joyEvent();
+}
+
+void TestJoyControlStick::init()
+{
+    axisX = new StickAxis(0);
+    axisY = new StickAxis(1);
+    stick = new JoyControlStick(axisX, axisY, 0);
+}
+
+void TestJoyControlStick::cleanup()
+{
+    delete stick;
+    stick = 0;
+    delete axisX;
+    axisX = 0;
+    delete axisY;
+    axisY = 0;
+}
+
+// With the default diagonal range the up zone ends at 22 degrees
+void TestJoyControlStick::directionWithoutHysteresis()
+{
+    moveStick(10);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickUp);
+
+    moveStick(30);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickRightUp);
+
+    moveStick(15);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickUp);
+    QCOMPARE(stick->getAvoidedDirectionChanges(), 0);
+}
+
+// Bearings just past a zone edge keep the direction on either side
+void TestJoyControlStick::directionHysteresisHoldsAtZoneEdge()
+{
+    stick->setDirectionHysteresis(10);
+
+    moveStick(10);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickUp);
+
+    moveStick(23);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickUp);
+    moveStick(30);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickUp);
+    QCOMPARE(stick->getAvoidedDirectionChanges(), 1);
+
+    moveStick(40);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickRightUp);
+
+    moveStick(22);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickRightUp);
+    moveStick(15);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickRightUp);
+    QCOMPARE(stick->getAvoidedDirectionChanges(), 2);
+}
+
+void TestJoyControlStick::directionHysteresisReleasesPastBand()
+{
+    stick->setDirectionHysteresis(10);
+
+    moveStick(10);
+    moveStick(33);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickRightUp);
+
+    moveStick(12);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickUp);
+    QCOMPARE(stick->getAvoidedDirectionChanges(), 0);
+}
+
+void TestJoyControlStick::deadZoneHysteresisKeepsStickActive()
+{
+    moveStick(90);
+    moveStick(90, 7000);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickCentered);
+
+    stick->setDeadZoneHysteresis(2000);
+    moveStick(90);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickRight);
+
+    moveStick(90, 7000);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickRight);
+    QCOMPARE(stick->getAvoidedDeadZoneChanges(), 1);
+
+    moveStick(90, 5000);
+    QCOMPARE(stick->getCurrentDirection(), JoyControlStick::StickCentered);
+}
+
+void TestJoyControlStick::zonesMatchRoundedBearing_data()
+{
+    QTest::addColumn<int>("diagonalRange");
+
+    QTest::newRow("diagonal range 1") << 1;
+    QTest::newRow("diagonal range 20") << 20;
+    QTest::newRow("diagonal range 45") << 45;
+    QTest::newRow("diagonal range 60") << 60;
+    QTest::newRow("diagonal range 89") << 89;
+}
+
+void TestJoyControlStick::zonesMatchRoundedBearing()
+{
+    QFETCH(int, diagonalRange);
+
+    StickAxis zoneAxisX(0);
+    StickAxis zoneAxisY(1);
+    ZoneStick zoneStick(&zoneAxisX, &zoneAxisY);
+    zoneStick.setDiagonalRange(diagonalRange);
+    QList<int> angles = zoneStick.getDiagonalZoneAngles();
+
+    int radii[] = {9000, 20000, JoyAxis::AXISMAX};
+    int compared = 0;
+    for (int i=0; i < 3; i++)
+    {
+        for (int step=0; step < 36000; step++)
+        {
+            double angle = step * JoyControlStick::PI / 18000.0;
+            int xvalue = qRound(radii[i] * sin(angle));
+            int yvalue = qRound(-radii[i] * cos(angle));
+
+            double bearing = atan2((double)xvalue, (double)-yvalue) * 180.0 / JoyControlStick::PI;
+            if (bearing < 0.0)
+            {
+                bearing += 360.0;
+            }
+
+            if (fabs(bearing - floor(bearing) - 0.5) > EDGEMARGIN)
+            {
+                JoyControlStick::JoyStickDirections expected = roundedBearingDirection(angles, bearing);
+                if (zoneStick.calculateStickDirection(xvalue, yvalue) != expected)
+                {
+                    QFAIL(QString("%1, %2 at %3 degrees is not in zone %4")
+                          .arg(xvalue).arg(yvalue).arg(bearing).arg((int)expected)
+                          .toUtf8().constData());
+                }
+
+                compared++;
+            }
+        }
+    }
+
+    QVERIFY(compared > 100000);
+}
+
+void TestJoyControlStick::snapshotMatchesAxes_data()
+{
+    QTest::addColumn<int>("xvalue");
+    QTest::addColumn<int>("yvalue");
+
+    QTest::newRow("centered") << 0 << 0;
+    QTest::newRow("in dead zone") << -5000 << 3000;
+    QTest::newRow("right") << 20000 << 0;
+    QTest::newRow("up") << 0 << -20000;
+    QTest::newRow("right up") << 14142 << -14142;
+    QTest::newRow("left down") << -9000 << 26000;
+    QTest::newRow("past max zone") << -32767 << 32767;
+}
+
+// Same formulas the stick used on each call before the snapshot
+void TestJoyControlStick::snapshotMatchesAxes()
+{
+    QFETCH(int, xvalue);
+    QFETCH(int, yvalue);
+
+    axisX->setCurrentRawValue(xvalue);
+    axisY->setCurrentRawValue(yvalue);
+    stick->joyEvent();
+
+    const StickSnapshot &snapshot = stick->getSnapshot();
+    int deadZone = stick->getDeadZone();
+    int maxZone = stick->getMaxZone();
+
+    double radius = sqrt((double)xvalue * xvalue + (double)yvalue * yvalue);
+    double bearing = 0.0;
+    if (xvalue != 0 || yvalue != 0)
+    {
+        bearing = atan2((double)xvalue, (double)-yvalue) * 180.0 / JoyControlStick::PI;
+        if (bearing < 0.0)
+        {
+            bearing += 360.0;
+        }
+    }
+
+    double relativeAngle = bearing > 180 ? bearing - 180 : bearing;
+    int deadX = (int)round(deadZone * sin(relativeAngle * JoyControlStick::PI / 180.0));
+    int deadY = abs((int)round(deadZone * cos(relativeAngle * JoyControlStick::PI / 180.0)));
+
+    QCOMPARE(snapshot.xvalue, xvalue);
+    QCOMPARE(snapshot.yvalue, yvalue);
+    QVERIFY(isClose(snapshot.normalizedX, qBound(-1.0, xvalue / (double)maxZone, 1.0)));
+    QVERIFY(isClose(snapshot.normalizedY, qBound(-1.0, yvalue / (double)maxZone, 1.0)));
+    QVERIFY(isClose(snapshot.radius, qMin(radius, (double)JoyAxis::AXISMAX)));
+    QVERIFY(isClose(snapshot.normalizedRadius, qBound(0.0, radius / maxZone, 1.0)));
+    QVERIFY(isClose(snapshot.bearing, bearing));
+    QVERIFY(isClose(snapshot.deadZoneDistance,
+                    qBound(0.0, (radius - deadZone) / (double)(maxZone - deadZone), 1.0)));
+    QVERIFY(isClose(snapshot.xDeadZoneDistance,
+                    qBound(0.0, (abs(xvalue) - deadX) / (double)(maxZone - deadX), 1.0)));
+    QVERIFY(isClose(snapshot.yDeadZoneDistance,
+                    qBound(0.0, (abs(yvalue) - deadY) / (double)(maxZone - deadY), 1.0)));
+}
+
+void TestJoyControlStick::snapshotFollowsChanges()
+{
+    moveStick(90);
+    unsigned int version = stick->getSnapshot().version;
+    double distance = stick->getSnapshot().deadZoneDistance;
+    QCOMPARE(stick->getSnapshot().version, version);
+
+    stick->setDeadZone(10000);
+    QVERIFY(stick->getSnapshot().version != version);
+    QVERIFY(stick->getSnapshot().deadZoneDistance < distance);
+
+    // Read after the axis moved but before the stick handled it
+    axisX->setCurrentRawValue(-ACTIVERADIUS);
+    QCOMPARE(stick->getSnapshot().xvalue, -ACTIVERADIUS);
+    QVERIFY(isClose(stick->getSnapshot().bearing, 270.0));
+}
+
+void TestJoyControlStick::deadZoneTypeShapes()
+{
+    // Outside the default radial dead zone but inside the square one
+    axisX->setCurrentRawValue(7000);
+    axisY->setCurrentRawValue(7000);
+    QVERIFY(!stick->inDeadZone());
+
+    stick->setDeadZoneType(JoyControlStick::AxialDeadZone);
+    QVERIFY(stick->inDeadZone());
+
+    // Just past the radial dead zone on a diagonal. Mapping the square
+    // gate onto a circle pulls it back in
+    axisX->setCurrentRawValue(5700);
+    axisY->setCurrentRawValue(5700);
+    stick->setDeadZoneType(JoyControlStick::RadialDeadZone);
+    QVERIFY(!stick->inDeadZone());
+
+    stick->setDeadZoneType(JoyControlStick::SquareToCircleDeadZone);
+    QVERIFY(stick->inDeadZone());
+
+    // Hybrid activates on the radial dead zone
+    axisX->setCurrentRawValue(7000);
+    axisY->setCurrentRawValue(7000);
+    stick->setDeadZoneType(JoyControlStick::HybridDeadZone);
+    QVERIFY(!stick->inDeadZone());
+}
+
+void TestJoyControlStick::deadZoneTypeDistances()
+{
+    double zoneRange = stick->getMaxZone() - stick->getDeadZone();
+
+    axisX->setCurrentRawValue(20000);
+    axisY->setCurrentRawValue(5000);
+    stick->joyEvent();
+
+    // Radial removes a share of the dead zone from the minor axis
+    QVERIFY(stick->getSnapshot().yDeadZoneDistance > 0.0);
+
+    stick->setDeadZoneType(JoyControlStick::AxialDeadZone);
+    QVERIFY(isClose(stick->getSnapshot().xDeadZoneDistance, 12000 / zoneRange));
+    QCOMPARE(stick->getSnapshot().yDeadZoneDistance, 0.0);
+
+    stick->setDeadZoneType(JoyControlStick::HybridDeadZone);
+    QVERIFY(isClose(stick->getSnapshot().xDeadZoneDistance, 12000 / zoneRange));
+    QCOMPARE(stick->getSnapshot().yDeadZoneDistance, 0.0);
+
+    // Scaled radial keeps the bearing and rescales the radius
+    axisX->setCurrentRawValue(20000);
+    axisY->setCurrentRawValue(0);
+    stick->setDeadZoneType(JoyControlStick::ScaledRadialDeadZone);
+    QVERIFY(isClose(stick->getSnapshot().deadZoneDistance, 12000 / zoneRange));
+    QVERIFY(isClose(stick->getSnapshot().xDeadZoneDistance, 12000 / zoneRange));
+    QCOMPARE(stick->getSnapshot().yDeadZoneDistance, 0.0);
+
+    // The corner of the gate reaches the max zone
+    axisX->setCurrentRawValue(stick->getMaxZone());
+    axisY->setCurrentRawValue(-stick->getMaxZone());
+    stick->setDeadZoneType(JoyControlStick::SquareToCircleDeadZone);
+    QVERIFY(stick->getSnapshot().deadZoneDistance > 0.999);
+}
+
+void TestJoyControlStick::deadZoneTypeConfig()
+{
+    QString profile;
+    QXmlStreamWriter writer(&profile);
+    stick->setDeadZoneType(JoyControlStick::HybridDeadZone);
+    QVERIFY(!stick->isDefault());
+    stick->writeConfig(&writer);
+    QVERIFY(profile.contains("<deadZoneType>hybrid</deadZoneType>"));
+
+    StickAxis otherX(0);
+    StickAxis otherY(1);
+    JoyControlStick other(&otherX, &otherY, 0);
+    QXmlStreamReader reader(profile);
+    reader.readNextStartElement();
+    other.readConfig(&reader);
+    QCOMPARE(other.getDeadZoneType(), JoyControlStick::HybridDeadZone);
+
+    stick->setDeadZoneType(JoyControlStick::RadialDeadZone);
+    QVERIFY(stick->isDefault());
+}
+
+QTEST_MAIN(TestJoyControlStick)
+
+#include "tst_joycontrolstick.moc"
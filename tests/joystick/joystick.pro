@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_joystick
+
+SOURCES += tst_joystick.cpp
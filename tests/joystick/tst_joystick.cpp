@@ -0,0 +1,131 @@
+#include <QtTest>
+#include <QXmlStreamReader>
+
+#include "joystick.h"
+#include "setjoystick.h"
+#include "joyaxis.h"
+
+static const int CALIBRATIONCENTER = 1500;
+static const int CALIBRATIONMIN = -30000;
+static const int CALIBRATIONMAX = 31000;
+
+/* Checks that a controller calibration reaches the axis in every set,
+ * that calibrated axes map the recorded range onto the full axis
+ * range, that the calibration is kept when a profile is loaded and
+ * that axis values carried over to another set are not calibrated
+ * twice.
+ */
+class TestJoystick : public QObject
+{
+    Q_OBJECT
+
+protected:
+    void checkCalibration(Joystick *joystick);
+
+private slots:
+    void calibrationAppliesToEverySet();
+    void calibrationMapsRecordedRange();
+    void calibrationRejectsRangeWithoutCenter();
+    void calibrationSurvivesReadConfig();
+    void calibrationSurvivesReset();
+    void setChangeCarriesDeviceValue();
+};
+
+void TestJoystick::checkCalibration(Joystick *joystick)
+{
+    for (int i=0; i < Joystick::NUMBER_JOYSETS; i++)
+    {
+        SetJoystick *set = joystick->getSetJoystick(i);
+        QVERIFY(!set->getJoyAxis(0)->isCalibrated());
+
+        JoyAxis *axis = set->getJoyAxis(1);
+        QVERIFY(axis->isCalibrated());
+        QCOMPARE(axis->getCalibrationCenter(), CALIBRATIONCENTER);
+        QCOMPARE(axis->getCalibrationMin(), CALIBRATIONMIN);
+        QCOMPARE(axis->getCalibrationMax(), CALIBRATIONMAX);
+    }
+}
+
+void TestJoystick::calibrationAppliesToEverySet()
+{
+    Joystick joystick("Calibration test pad", 0, 0, 2, 0);
+    joystick.setAxisCalibration(1, CALIBRATIONCENTER, CALIBRATIONMIN, CALIBRATIONMAX);
+
+    checkCalibration(&joystick);
+}
+
+void TestJoystick::calibrationMapsRecordedRange()
+{
+    Joystick joystick("Calibration test pad", 0, 0, 2, 0);
+    joystick.setAxisCalibration(1, CALIBRATIONCENTER, CALIBRATIONMIN, CALIBRATIONMAX);
+    JoyAxis *axis = joystick.getActiveJoyAxis(1);
+
+    axis->joyEvent(CALIBRATIONCENTER);
+    QCOMPARE(axis->getCurrentRawValue(), 0);
+
+    axis->joyEvent(CALIBRATIONMAX);
+    QCOMPARE(axis->getCurrentRawValue(), JoyAxis::AXISMAX);
+
+    axis->joyEvent((CALIBRATIONCENTER + CALIBRATIONMAX) / 2);
+    QVERIFY(qAbs(axis->getCurrentRawValue() - JoyAxis::AXISMAX / 2) <= 1);
+
+    // Values past the recorded range are clamped
+    axis->joyEvent(CALIBRATIONMIN - 1000);
+    QCOMPARE(axis->getCurrentRawValue(), JoyAxis::AXISMIN);
+    QCOMPARE(axis->getUncalibratedValue(), CALIBRATIONMIN - 1000);
+
+    // Other axes still see the device values
+    joystick.getActiveJoyAxis(0)->joyEvent(CALIBRATIONCENTER);
+    QCOMPARE(joystick.getActiveJoyAxis(0)->getCurrentRawValue(), CALIBRATIONCENTER);
+}
+
+void TestJoystick::calibrationRejectsRangeWithoutCenter()
+{
+    Joystick joystick("Calibration test pad", 0, 0, 2, 0);
+    joystick.setAxisCalibration(1, CALIBRATIONCENTER, CALIBRATIONMIN, CALIBRATIONMAX);
+    joystick.setAxisCalibration(1, CALIBRATIONMAX, CALIBRATIONMIN, CALIBRATIONCENTER);
+
+    JoyAxis *axis = joystick.getActiveJoyAxis(1);
+    QVERIFY(!axis->isCalibrated());
+
+    axis->joyEvent(CALIBRATIONCENTER);
+    QCOMPARE(axis->getCurrentRawValue(), CALIBRATIONCENTER);
+}
+
+void TestJoystick::calibrationSurvivesReadConfig()
+{
+    Joystick joystick("Calibration test pad", 0, 0, 2, 0);
+    joystick.setAxisCalibration(1, CALIBRATIONCENTER, CALIBRATIONMIN, CALIBRATIONMAX);
+
+    QXmlStreamReader xml(QString("<joystick><sets><set index=\"1\"></set></sets></joystick>"));
+    xml.readNextStartElement();
+    joystick.readConfig(&xml);
+
+    checkCalibration(&joystick);
+}
+
+void TestJoystick::calibrationSurvivesReset()
+{
+    Joystick joystick("Calibration test pad", 0, 0, 2, 0);
+    joystick.setAxisCalibration(1, CALIBRATIONCENTER, CALIBRATIONMIN, CALIBRATIONMAX);
+    joystick.reset();
+
+    checkCalibration(&joystick);
+}
+
+void TestJoystick::setChangeCarriesDeviceValue()
+{
+    Joystick joystick("Calibration test pad", 0, 0, 2, 0);
+    joystick.setAxisCalibration(1, CALIBRATIONCENTER, CALIBRATIONMIN, CALIBRATIONMAX);
+
+    joystick.getActiveJoyAxis(1)->joyEvent(CALIBRATIONCENTER);
+    QCOMPARE(joystick.getActiveJoyAxis(1)->getCurrentRawValue(), 0);
+
+    joystick.setActiveSetNumber(1);
+    QCOMPARE(joystick.getActiveJoyAxis(1)->getUncalibratedValue(), CALIBRATIONCENTER);
+    QCOMPARE(joystick.getActiveJoyAxis(1)->getCurrentRawValue(), 0);
+}
+
+QTEST_MAIN(TestJoystick)
+
+#include "tst_joystick.moc"
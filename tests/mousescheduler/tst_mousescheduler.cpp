@@ -0,0 +1,96 @@
+#include <QtTest>
+
+#include "mousescheduler.h"
+#include "timerwheel.h"
+#include "joybutton.h"
+#include "common.h"
+
+// Far beyond the real monotonic time so the timerfd never fires
+// on its own while the test runs
+qint64 PadderCommon::mockMonotonicTime = 1LL << 60;
+
+static const qint64 MILLISECOND = 1000000;
+// Step of the mocked clock in nanoseconds
+static const qint64 CLOCKSTEP = 50000;
+
+// Gives the test access to the tick count
+class CountingScheduler : public MouseScheduler
+{
+public:
+    int getTickCount()
+    {
+        return tickCount;
+    }
+};
+
+/* Runs a MouseScheduler for one second of mocked time at rates that
+ * are not a whole number of milliseconds apart and checks that the
+ * requested number of ticks happened.
+ */
+class TestMouseScheduler : public QObject
+{
+    Q_OBJECT
+
+protected:
+    void advance(qint64 nanoseconds);
+
+private slots:
+    void tickRate_data();
+    void tickRate();
+    void stopsWithoutButtons();
+};
+
+// Move the clock in small steps like a busy process would see it
+void TestMouseScheduler::advance(qint64 nanoseconds)
+{
+    qint64 target = PadderCommon::mockMonotonicTime + nanoseconds;
+    while (PadderCommon::mockMonotonicTime < target)
+    {
+        PadderCommon::mockMonotonicTime = qMin(target, PadderCommon::mockMonotonicTime + CLOCKSTEP);
+        QMetaObject::invokeMethod(TimerWheel::getInstance(), "processTimers");
+    }
+}
+
+void TestMouseScheduler::tickRate_data()
+{
+    QTest::addColumn<int>("rate");
+
+    QTest::newRow("60 Hz") << 60;
+    QTest::newRow("250 Hz") << 250;
+    QTest::newRow("300 Hz") << 300;
+    QTest::newRow("750 Hz") << 750;
+    QTest::newRow("1000 Hz") << 1000;
+}
+
+void TestMouseScheduler::tickRate()
+{
+    QFETCH(int, rate);
+
+    CountingScheduler scheduler;
+    scheduler.setRate(rate);
+    QCOMPARE(scheduler.getRate(), rate);
+
+    JoyButton button(0, 0);
+    scheduler.addButton(&button);
+    scheduler.resetStatistics();
+    advance(1000 * MILLISECOND);
+    scheduler.removeButton(&button);
+
+    QVERIFY(qAbs(scheduler.getTickCount() - rate) <= 1);
+}
+
+void TestMouseScheduler::stopsWithoutButtons()
+{
+    CountingScheduler scheduler;
+    JoyButton button(0, 0);
+    scheduler.addButton(&button);
+    scheduler.removeButton(&button);
+
+    scheduler.resetStatistics();
+    advance(100 * MILLISECOND);
+    QCOMPARE(scheduler.getTickCount(), 0);
+}
+
+QTEST_MAIN(TestMouseScheduler)
+
+#include "tst_mousescheduler.moc"
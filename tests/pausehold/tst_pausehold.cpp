@@ -0,0 +1,181 @@
+#include <QtTest>
+#include <QList>
+
+#include "joybutton.h"
+#include "joybuttonslot.h"
+#include "timerwheel.h"
+#include "recordingoutputsink.h"
+#include "common.h"
+
+// Far beyond the real monotonic time so the timerfd never fires
+// on its own while the test runs. Starts on a millisecond boundary
+qint64 PadderCommon::mockMonotonicTime = 1000000LL << 40;
+
+// Key codes assigned before and after the pause or hold slot
+static const int FIRSTKEYCODE = 10;
+static const int SECONDKEYCODE = 11;
+// Time in milliseconds
+static const int SETTLETIME = 20;
+
+static const qint64 MILLISECOND = 1000000;
+// Step of the mocked clock in nanoseconds
+static const qint64 CLOCKSTEP = 100000;
+
+/* Runs buttons with a pause or hold slot between two key presses on
+ * a mocked monotonic clock. The second key has to be sent at the
+ * exact deadline of the pause or hold. bench_pausehold measures the
+ * same with the real clock.
+ */
+class TestPauseHold : public QObject
+{
+    Q_OBJECT
+
+protected:
+    void advance(qint64 nanoseconds);
+    qint64 findKeyEvent(int code, bool pressed);
+
+    RecordingOutputSink *sink;
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void pauseDeadline_data();
+    void pauseDeadline();
+    void holdDeadline_data();
+    void holdDeadline();
+    void releaseBeforeHold();
+};
+
+/* Move the clock in small steps. Each step runs the timer wheel like
+ * a timerfd wakeup would and then the events it posted.
+ */
+void TestPauseHold::advance(qint64 nanoseconds)
+{
+    qint64 target = PadderCommon::mockMonotonicTime + nanoseconds;
+    while (PadderCommon::mockMonotonicTime < target)
+    {
+        PadderCommon::mockMonotonicTime = qMin(target, PadderCommon::mockMonotonicTime + CLOCKSTEP);
+        QMetaObject::invokeMethod(TimerWheel::getInstance(), "processTimers");
+        QCoreApplication::processEvents();
+    }
+}
+
+// Time of the first matching key event or -1 when none was sent
+qint64 TestPauseHold::findKeyEvent(int code, bool pressed)
+{
+    qint64 result = -1;
+
+    QList<RecordingOutputSink::OutputEvent> *events = sink->getEvents();
+    for (int i=0; i < events->size() && result < 0; i++)
+    {
+        const RecordingOutputSink::OutputEvent &event = events->at(i);
+        if (event.type == RecordingOutputSink::KeyOutput &&
+            event.code == code && (event.value != 0) == pressed)
+        {
+            result = event.timestamp;
+        }
+    }
+
+    return result;
+}
+
+void TestPauseHold::initTestCase()
+{
+    sink = new RecordingOutputSink();
+    OutputSink::setInstance(sink);
+}
+
+void TestPauseHold::cleanupTestCase()
+{
+    OutputSink::setInstance(0);
+    delete sink;
+    sink = 0;
+}
+
+static void addDurationRows()
+{
+    QTest::addColumn<int>("duration");
+
+    QTest::newRow("10 ms") << 10;
+    QTest::newRow("50 ms") << 50;
+    QTest::newRow("250 ms") << 250;
+}
+
+void TestPauseHold::pauseDeadline_data()
+{
+    addDurationRows();
+}
+
+// The pause starts when the slots before it are released
+void TestPauseHold::pauseDeadline()
+{
+    QFETCH(int, duration);
+
+    JoyButton button(0, 0);
+    button.setAssignedSlot(FIRSTKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button.setAssignedSlot(duration, JoyButtonSlot::JoyPause);
+    button.setAssignedSlot(SECONDKEYCODE, JoyButtonSlot::JoyKeyboard);
+
+    sink->clear();
+    button.joyEvent(true);
+    advance((JoyButton::PAUSEHOLDTIME + duration + SETTLETIME) * MILLISECOND);
+    button.joyEvent(false);
+    advance(SETTLETIME * MILLISECOND);
+
+    qint64 pauseStart = findKeyEvent(FIRSTKEYCODE, false);
+    qint64 pauseEnd = findKeyEvent(SECONDKEYCODE, true);
+    QVERIFY(pauseStart >= 0);
+    QVERIFY(pauseEnd >= 0);
+    QCOMPARE(pauseEnd - pauseStart, duration * MILLISECOND);
+}
+
+void TestPauseHold::holdDeadline_data()
+{
+    addDurationRows();
+}
+
+// The hold is measured from the moment the button was pressed
+void TestPauseHold::holdDeadline()
+{
+    QFETCH(int, duration);
+
+    JoyButton button(0, 0);
+    button.setAssignedSlot(FIRSTKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button.setAssignedSlot(duration, JoyButtonSlot::JoyHold);
+    button.setAssignedSlot(SECONDKEYCODE, JoyButtonSlot::JoyKeyboard);
+
+    sink->clear();
+    qint64 pressTime = PadderCommon::getMonotonicTime();
+    button.joyEvent(true);
+    advance((duration + SETTLETIME) * MILLISECOND);
+    button.joyEvent(false);
+    advance(SETTLETIME * MILLISECOND);
+
+    QVERIFY(findKeyEvent(FIRSTKEYCODE, true) >= 0);
+    QCOMPARE(findKeyEvent(FIRSTKEYCODE, false), pressTime + duration * MILLISECOND);
+    QCOMPARE(findKeyEvent(SECONDKEYCODE, true), pressTime + duration * MILLISECOND);
+}
+
+// Letting go before the hold time skips the slots after the hold
+void TestPauseHold::releaseBeforeHold()
+{
+    JoyButton button(0, 0);
+    button.setAssignedSlot(FIRSTKEYCODE, JoyButtonSlot::JoyKeyboard);
+    button.setAssignedSlot(100, JoyButtonSlot::JoyHold);
+    button.setAssignedSlot(SECONDKEYCODE, JoyButtonSlot::JoyKeyboard);
+
+    sink->clear();
+    button.joyEvent(true);
+    advance(99 * MILLISECOND);
+    button.joyEvent(false);
+    advance(SETTLETIME * MILLISECOND);
+
+    QVERIFY(findKeyEvent(FIRSTKEYCODE, true) >= 0);
+    QVERIFY(findKeyEvent(FIRSTKEYCODE, false) >= 0);
+    QCOMPARE(findKeyEvent(SECONDKEYCODE, true), (qint64)-1);
+}
+
+QTEST_MAIN(TestPauseHold)
+
+#include "tst_pausehold.moc"
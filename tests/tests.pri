@@ -0,0 +1,12 @@
+# Settings shared by every test program. Run the tests with
+# "make check" after building them.
+
+QT += testlib
+QT -= gui
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+include(../src/antimicrocore.pri)
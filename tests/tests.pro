@@ -0,0 +1,11 @@
+TEMPLATE = subdirs
+
+SUBDIRS += evdeveventreader \
+    joyaxis \
+    joybutton \
+    joycontrolstick \
+    joystick \
+    mousescheduler \
+    pausehold \
+    timerwheel \
+    turbo
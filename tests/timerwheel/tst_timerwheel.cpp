@@ -0,0 +1,210 @@
+#include <QtTest>
+
+#include "timerwheel.h"
+#include "joybutton.h"
+#include "common.h"
+
+// Far beyond the real monotonic time so the timerfd never fires
+// on its own while the test runs. Starts on a millisecond boundary
+qint64 PadderCommon::mockMonotonicTime = 1000000LL << 40;
+
+static const qint64 MILLISECOND = 1000000;
+
+// Counts how often its wheel timer fired and when
+class TimerButton : public JoyButton
+{
+public:
+    explicit TimerButton() :
+        JoyButton(0, 0)
+    {
+        fireCount = 0;
+        lastFireTime = 0;
+        stopOnFire = false;
+        timer = new WheelTimer(this, static_cast<WheelTimerHandler>(&TimerButton::fire));
+    }
+
+    ~TimerButton()
+    {
+        delete timer;
+    }
+
+    void fire()
+    {
+        fireCount++;
+        lastFireTime = PadderCommon::getMonotonicTime();
+        if (stopOnFire)
+        {
+            timer->stop();
+        }
+    }
+
+    WheelTimer *timer;
+    int fireCount;
+    qint64 lastFireTime;
+    bool stopOnFire;
+};
+
+/* Drives TimerWheel with a mocked monotonic clock. Each step moves
+ * the clock and then runs the wheel like a timerfd wakeup would.
+ */
+class TestTimerWheel : public QObject
+{
+    Q_OBJECT
+
+protected:
+    void advance(qint64 nanoseconds);
+
+    TimerButton *button;
+
+private slots:
+    void init();
+    void cleanup();
+
+    void zeroIntervalOncePerWakeup();
+    void overdueTimerOncePerWakeup();
+    void exactDeadline();
+    void repeatingInterval();
+    void lateWakeupFiresOnce();
+    void stopCancels();
+    void stopFromHandler();
+    void longDeadline();
+    void farDeadline();
+};
+
+void TestTimerWheel::advance(qint64 nanoseconds)
+{
+    PadderCommon::mockMonotonicTime += nanoseconds;
+    QMetaObject::invokeMethod(TimerWheel::getInstance(), "processTimers");
+}
+
+void TestTimerWheel::init()
+{
+    button = new TimerButton();
+}
+
+void TestTimerWheel::cleanup()
+{
+    delete button;
+    button = 0;
+}
+
+// A timer scheduled again by its handler must wait for the next wakeup
+void TestTimerWheel::zeroIntervalOncePerWakeup()
+{
+    button->timer->start(0);
+    advance(5 * MILLISECOND);
+    QCOMPARE(button->fireCount, 1);
+
+    advance(0);
+    QCOMPARE(button->fireCount, 2);
+
+    advance(MILLISECOND);
+    QCOMPARE(button->fireCount, 3);
+}
+
+void TestTimerWheel::overdueTimerOncePerWakeup()
+{
+    button->timer->startAt(PadderCommon::getMonotonicTime() - 3 * MILLISECOND);
+    advance(0);
+    QCOMPARE(button->fireCount, 1);
+}
+
+void TestTimerWheel::exactDeadline()
+{
+    button->timer->start(1000);
+    qint64 deadline = PadderCommon::getMonotonicTime() + 2500000;
+    button->timer->startAt(deadline);
+
+    advance(2400000);
+    QCOMPARE(button->fireCount, 0);
+
+    advance(100000);
+    QCOMPARE(button->fireCount, 1);
+    QCOMPARE(button->lastFireTime, deadline);
+}
+
+void TestTimerWheel::repeatingInterval()
+{
+    button->timer->start(10);
+    for (int i=1; i <= 10; i++)
+    {
+        advance(10 * MILLISECOND);
+        QCOMPARE(button->fireCount, i);
+    }
+
+    QVERIFY(button->timer->isActive());
+}
+
+// Missed intervals are not made up for, like with QTimer
+void TestTimerWheel::lateWakeupFiresOnce()
+{
+    button->timer->start(3);
+    advance(20 * MILLISECOND);
+    QCOMPARE(button->fireCount, 1);
+
+    advance(2 * MILLISECOND);
+    QCOMPARE(button->fireCount, 1);
+
+    advance(MILLISECOND);
+    QCOMPARE(button->fireCount, 2);
+}
+
+void TestTimerWheel::stopCancels()
+{
+    button->timer->start(5);
+    button->timer->stop();
+    QVERIFY(!button->timer->isActive());
+
+    advance(10 * MILLISECOND);
+    QCOMPARE(button->fireCount, 0);
+}
+
+void TestTimerWheel::stopFromHandler()
+{
+    button->stopOnFire = true;
+    button->timer->start(1);
+
+    advance(MILLISECOND);
+    QCOMPARE(button->fireCount, 1);
+    QVERIFY(!button->timer->isActive());
+
+    advance(5 * MILLISECOND);
+    QCOMPARE(button->fireCount, 1);
+}
+
+// Past the range of the root wheel the timer has to cascade down
+void TestTimerWheel::longDeadline()
+{
+    qint64 deadline = PadderCommon::getMonotonicTime() + 1000 * MILLISECOND;
+    button->timer->start(1000);
+
+    while (PadderCommon::getMonotonicTime() < deadline)
+    {
+        QCOMPARE(button->fireCount, 0);
+        advance(7 * MILLISECOND);
+    }
+
+    QCOMPARE(button->fireCount, 1);
+    QVERIFY(button->lastFireTime >= deadline);
+    QVERIFY(button->lastFireTime < deadline + 7 * MILLISECOND);
+}
+
+// Cascades down through two upper wheels
+void TestTimerWheel::farDeadline()
+{
+    qint64 deadline = PadderCommon::getMonotonicTime() + 100000 * MILLISECOND;
+    button->timer->start(100000);
+
+    while (PadderCommon::getMonotonicTime() < deadline)
+    {
+        QCOMPARE(button->fireCount, 0);
+        advance(999 * MILLISECOND);
+    }
+
+    QCOMPARE(button->fireCount, 1);
+    QVERIFY(button->lastFireTime < deadline + 999 * MILLISECOND);
+}
+
+QTEST_MAIN(TestTimerWheel)
+
+#include "tst_timerwheel.moc"
@@ -0,0 +1,228 @@
+#include <QtTest>
+#include <QList>
+
+#include "joybutton.h"
+#include "joybuttonslot.h"
+#include "timerwheel.h"
+#include "recordingoutputsink.h"
+#include "common.h"
+
+// Far beyond the real monotonic time so the timerfd never fires
+// on its own while the test runs. Starts on a millisecond boundary
+qint64 PadderCommon::mockMonotonicTime = 1000000LL << 40;
+
+static const int KEYCODE = 10;
+// Time in milliseconds
+static const int TURBOINTERVAL = 50;
+static const int SETTLETIME = 20;
+static const int CYCLES = 10;
+
+static const qint64 MILLISECOND = 1000000;
+// Step of the mocked clock in nanoseconds
+static const qint64 CLOCKSTEP = 100000;
+
+/* Holds turbo buttons on a mocked monotonic clock and checks that
+ * their press and release edges stay on the grid of the turbo
+ * period.
+ */
+class TestTurbo : public QObject
+{
+    Q_OBJECT
+
+protected:
+    void advance(qint64 nanoseconds);
+    void runWheel();
+    QList<qint64> findKeyEvents(bool pressed);
+
+    RecordingOutputSink *sink;
+    JoyButton *button;
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void edgesStayOnGrid();
+    void dutyCycle();
+    void phaseLock();
+    void stallRejoinsGrid();
+};
+
+/* Move the clock in small steps. Each step runs the timer wheel like
+ * a timerfd wakeup would and then the events it posted.
+ */
+void TestTurbo::advance(qint64 nanoseconds)
+{
+    qint64 target = PadderCommon::mockMonotonicTime + nanoseconds;
+    while (PadderCommon::mockMonotonicTime < target)
+    {
+        PadderCommon::mockMonotonicTime = qMin(target, PadderCommon::mockMonotonicTime + CLOCKSTEP);
+        runWheel();
+    }
+}
+
+void TestTurbo::runWheel()
+{
+    QMetaObject::invokeMethod(TimerWheel::getInstance(), "processTimers");
+    QCoreApplication::processEvents();
+}
+
+// Times of the key presses or releases in the order they were sent
+QList<qint64> TestTurbo::findKeyEvents(bool pressed)
+{
+    QList<qint64> result;
+
+    QList<RecordingOutputSink::OutputEvent> *events = sink->getEvents();
+    for (int i=0; i < events->size(); i++)
+    {
+        const RecordingOutputSink::OutputEvent &event = events->at(i);
+        if (event.type == RecordingOutputSink::KeyOutput &&
+            event.code == KEYCODE && (event.value != 0) == pressed)
+        {
+            result.append(event.timestamp);
+        }
+    }
+
+    return result;
+}
+
+void TestTurbo::initTestCase()
+{
+    sink = new RecordingOutputSink();
+    OutputSink::setInstance(sink);
+}
+
+void TestTurbo::cleanupTestCase()
+{
+    OutputSink::setInstance(0);
+    delete sink;
+    sink = 0;
+}
+
+void TestTurbo::init()
+{
+    button = new JoyButton(0, 0);
+    button->setAssignedSlot(KEYCODE, JoyButtonSlot::JoyKeyboard);
+    button->setTurboInterval(TURBOINTERVAL);
+    button->setUseTurbo(true);
+    sink->clear();
+}
+
+void TestTurbo::cleanup()
+{
+    button->joyEvent(false);
+    advance(SETTLETIME * MILLISECOND);
+    delete button;
+    button = 0;
+}
+
+/* The first press waits for the next wakeup of the wheel. Every later
+ * edge is a fixed offset from the cycle start no matter how late the
+ * edge before it fired.
+ */
+void TestTurbo::edgesStayOnGrid()
+{
+    qint64 period = TURBOINTERVAL * MILLISECOND;
+    qint64 cycleStart = PadderCommon::getMonotonicTime();
+    button->joyEvent(true);
+    advance(CYCLES * period);
+
+    QList<qint64> presses = findKeyEvents(true);
+    QList<qint64> releases = findKeyEvents(false);
+    QVERIFY(presses.size() >= CYCLES);
+    QVERIFY(releases.size() >= CYCLES);
+    QVERIFY(presses.at(0) - cycleStart <= CLOCKSTEP);
+
+    for (int i=1; i < CYCLES; i++)
+    {
+        QCOMPARE(presses.at(i), cycleStart + i * period);
+    }
+
+    for (int i=0; i < CYCLES; i++)
+    {
+        QCOMPARE(releases.at(i), cycleStart + i * period + JoyButton::TURBOPRESSTIME * MILLISECOND);
+    }
+}
+
+void TestTurbo::dutyCycle()
+{
+    qint64 period = TURBOINTERVAL * MILLISECOND;
+    button->setTurboDutyCycle(60);
+    qint64 cycleStart = PadderCommon::getMonotonicTime();
+    button->joyEvent(true);
+    advance(CYCLES * period);
+
+    QList<qint64> releases = findKeyEvents(false);
+    QVERIFY(releases.size() >= CYCLES);
+    for (int i=0; i < CYCLES; i++)
+    {
+        QCOMPARE(releases.at(i), cycleStart + i * period + (period * 60) / 100);
+    }
+}
+
+/* Cycles start on multiples of the period on the monotonic clock.
+ * The first press may wait for the next wakeup when the button is
+ * pressed right on a multiple.
+ */
+void TestTurbo::phaseLock()
+{
+    qint64 period = TURBOINTERVAL * MILLISECOND;
+    button->setTurboPhaseLock(true);
+    advance(7 * MILLISECOND);
+
+    qint64 pressTime = PadderCommon::getMonotonicTime();
+    button->joyEvent(true);
+    advance(CYCLES * period);
+
+    QList<qint64> presses = findKeyEvents(true);
+    QVERIFY(presses.size() >= CYCLES - 1);
+    QVERIFY(presses.at(0) >= pressTime);
+    QVERIFY(presses.at(0) <= pressTime + period);
+    for (int i=1; i < presses.size(); i++)
+    {
+        QCOMPARE(presses.at(i) % period, (qint64)0);
+    }
+}
+
+/* After a stall the missed cycles are not replayed one after the
+ * other. Presses go back to the grid of the first cycle.
+ */
+void TestTurbo::stallRejoinsGrid()
+{
+    qint64 period = TURBOINTERVAL * MILLISECOND;
+    qint64 cycleStart = PadderCommon::getMonotonicTime();
+    button->joyEvent(true);
+    advance(2 * period + 20 * MILLISECOND);
+
+    // No wakeup for eight periods
+    PadderCommon::mockMonotonicTime += 8 * period;
+    qint64 stallEnd = PadderCommon::getMonotonicTime();
+    runWheel();
+    advance(3 * period);
+
+    QList<qint64> presses = findKeyEvents(true);
+    int caughtUp = 0;
+    int onGrid = 0;
+    for (int i=0; i < presses.size(); i++)
+    {
+        qint64 pressTime = presses.at(i);
+        if (pressTime >= stallEnd && pressTime < stallEnd + period)
+        {
+            caughtUp++;
+        }
+        else if (pressTime >= stallEnd + period)
+        {
+            QCOMPARE((pressTime - cycleStart) % period, (qint64)0);
+            onGrid++;
+        }
+    }
+
+    // Replaying the missed cycles would press eight times
+    QVERIFY(caughtUp <= 3);
+    QVERIFY(onGrid >= 2);
+}
+
+QTEST_MAIN(TestTurbo)
+
+#include "tst_turbo.moc"